@@ -0,0 +1,116 @@
+/**
+ * @file sensor_alarm.c
+ * @brief 传感器报警判定
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_alarm.h"
+/* Private includes ----------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define ALARM_TYPE_NUM  3
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  统计置位数量
+ * @param  value: 数据
+ * @retval 置位数量
+ */
+static uint8_t bit_count(uint16_t value)
+{
+    uint8_t count = 0;
+    while(value) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+}
+/**
+ * @brief  报警状态复位
+ * @note   规则变更后调用
+ * @param  *alarm: 报警通道
+ */
+void sensor_alarm_reset(sensor_alarm_t *alarm)
+{
+    if(alarm == NULL) {
+        return;
+    }
+    memset(&alarm->state, 0, sizeof(sensor_alarm_state_t));
+}
+/**
+ * @brief  报警增量判定
+ * @note   无效数据不参与判定,保持当前状态;
+ *         单项报警在最近m次中n次满足时置位,n次不满足时解除
+ * @param  *alarm: 报警通道
+ * @param  value: 数据
+ * @param  status: 数据状态
+ * @param  ts: 数据时间戳(ms)
+ * @param  *prev: 变化前报警状态,可为空
+ * @retval true: 报警状态变化 false: 未变化
+ */
+bool sensor_alarm_update(sensor_alarm_t *alarm, float value, data_status_e status, uint32_t ts, uint8_t *prev)
+{
+    if(alarm == NULL || alarm->rule == NULL || status != DATA_STATUS_VALID) {
+        return false;
+    }
+
+    const sensor_alarm_rule_t *rule = alarm->rule;
+    sensor_alarm_state_t *st = &alarm->state;
+    uint8_t m = (rule->m == 0) ? 1 : (rule->m > 16) ? 16 : rule->m;
+    uint8_t n = (rule->n == 0) ? 1 : (rule->n > m) ? m : rule->n;
+    uint16_t mask = (m == 16) ? 0xFFFF : (uint16_t)((1U << m) - 1);
+
+    bool cond[ALARM_TYPE_NUM] = {false};
+    if(rule->enable & SENSOR_ALARM_HIGH) {
+        float limit = (st->state & SENSOR_ALARM_HIGH) ? rule->high - rule->hysteresis : rule->high;
+        cond[0] = value > limit;
+    }
+    if(rule->enable & SENSOR_ALARM_LOW) {
+        float limit = (st->state & SENSOR_ALARM_LOW) ? rule->low + rule->hysteresis : rule->low;
+        cond[1] = value < limit;
+    }
+    if((rule->enable & SENSOR_ALARM_RATE) && st->primed == true && ts != st->last_ts) {
+        float rate = (value - st->last_value) * 1000.0f / (float)(uint32_t)(ts - st->last_ts);
+        cond[2] = fabsf(rate) > rule->rate;
+    }
+    st->primed = true;
+    st->last_value = value;
+    st->last_ts = ts;
+
+    uint8_t state = st->state;
+    for(uint8_t i = 0; i < ALARM_TYPE_NUM; i++) {
+        uint8_t bit = 1 << i;
+        st->hist[i] = ((st->hist[i] << 1) | (cond[i] ? 1 : 0)) & mask;
+        uint8_t hits = bit_count(st->hist[i]);
+        if(hits >= n) {
+            state |= bit;
+        } else if(m - hits >= n) {
+            state &= ~bit;
+        }
+    }
+
+    if(state == st->state) {
+        return false;
+    }
+    if(prev != NULL) {
+        *prev = st->state;
+    }
+    st->state = state;
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file sensor_alarm.h
+ * @brief 传感器报警判定
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 表驱动报警判定,支持高低阈值回差、变化率限值、N-of-M去抖;
+ * 每通道状态大小固定,逐点增量判定,仅在状态变化时产生事件
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_ALARM_H__
+#define __SENSOR_ALARM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sensor_driver.h"
+/* Exported constants --------------------------------------------------------*/
+#define SENSOR_ALARM_NONE       (0x00)  //无报警
+#define SENSOR_ALARM_HIGH       (0x01)  //高于上限
+#define SENSOR_ALARM_LOW        (0x02)  //低于下限
+#define SENSOR_ALARM_RATE       (0x04)  //变化率超限
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  报警规则
+ * @note   可定义为const常量表;enable为报警类型掩码
+ */
+typedef struct
+{
+    uint8_t enable;         //使能的报警类型
+    float   high;           //上限
+    float   low;            //下限
+    float   hysteresis;     //回差,报警解除需回到阈值内hysteresis以上
+    float   rate;           //变化率限值,单位/秒
+    uint8_t n;              //去抖:最近m次判定中n次满足则报警
+    uint8_t m;              //去抖窗口 1~16,0按1处理
+}sensor_alarm_rule_t;
+/**
+ * @brief  报警状态
+ * @note   每通道一份
+ */
+typedef struct
+{
+    uint8_t  state;         //当前报警状态
+    bool     primed;        //已有上一个有效数据
+    uint16_t hist[3];       //高/低/变化率最近m次判定结果
+    float    last_value;    //上一个有效数据
+    uint32_t last_ts;       //上一个有效数据时间戳(ms)
+}sensor_alarm_state_t;
+/**
+ * @brief  报警通道
+ * @note   规则与状态
+ */
+typedef struct
+{
+    const sensor_alarm_rule_t *rule;    //报警规则,为空不判定
+    sensor_alarm_state_t       state;   //报警状态
+}sensor_alarm_t;
+/**
+ * @brief  报警事件
+ * @note   None
+ */
+typedef struct
+{
+    sensor_device_t sensor;     //传感器
+    uint8_t  id;                //通道
+    uint8_t  state;             //当前报警状态
+    uint8_t  prev;              //变化前报警状态
+    float    value;             //触发数据
+    uint32_t ts;                //触发数据采集时间戳(ms)
+}sensor_alarm_event_t;
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void sensor_alarm_reset(sensor_alarm_t *alarm);
+bool sensor_alarm_update(sensor_alarm_t *alarm, float value, data_status_e status, uint32_t ts, uint8_t *prev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_ALARM_H__ */
@@ -15,11 +15,12 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_builder.h"
 /* Private includes ----------------------------------------------------------*/
-
+#include "NodeSDKConfig.h"
+#include "cmsis_os.h"
 /* Private typedef -----------------------------------------------------------*/
 
 /* Private define ------------------------------------------------------------*/
-
+#define DIRECTOR_IDLE_MAX   1000        //单次空闲时间上限(ms),保证调度与日志输出按时处理
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
@@ -99,11 +100,79 @@ bool sensor_director_init(void)
     }
     return ret;
 }
+/**
+ * @brief  构建器是否到达执行时间
+ * @param  *builder: 构建器
+ * @param  now: 当前时间
+ * @retval true: 到达 false: 未到达
+ */
+static bool builder_due(sensor_builder_t *builder, uint32_t now)
+{
+    return builder->period == 0 || (int32_t)(now - builder->next_run) >= 0;
+}
+/**
+ * @brief  构建器传感器进入/退出低功耗
+ * @note   构建器接口未提供lpm时仅控制builder->sensor
+ * @param  *builder: 构建器
+ * @param  lpm_flag: true:进入低功耗 false:退出低功耗
+ * @retval true: 成功 false: 失败
+ */
+static bool builder_lpm(sensor_builder_t *builder, bool lpm_flag)
+{
+    if(builder->ops != NULL && builder->ops->lpm != NULL) {
+        return builder->ops->lpm(builder, lpm_flag);
+    }
+    return sensor_lpm(builder->sensor, lpm_flag);
+}
+/**
+ * @brief  计算阶段截止时间
+ * @note   取阶段预算与构建器剩余预算中较小者
+ * @param  *builder: 构建器
+ * @param  budget: 阶段预算
+ * @param  elapsed: 构建器已执行时间
+ * @retval 截止时长(ms),0表示不限制
+ */
+static uint32_t builder_deadline(sensor_builder_t *builder, uint32_t budget, uint32_t elapsed)
+{
+    uint32_t deadline = budget;
+    if(builder->budget != 0) {
+        uint32_t remain = (elapsed < builder->budget) ? builder->budget - elapsed : 1;
+        if(deadline == 0 || remain < deadline) {
+            deadline = remain;
+        }
+    }
+    return deadline;
+}
+/**
+ * @brief  构建器执行超出预算处理
+ * @note   构建器管理的所有传感器通道标记为无效,跳过剩余阶段
+ * @param  *builder: 构建器
+ * @param  id: 超出预算的阶段
+ */
+static void builder_overrun(sensor_builder_t *builder, uint8_t id)
+{
+    builder->overrun++;
+    builder->overrun_id = id;
+    sensor_stats_event(builder->sensor, SENSOR_STATS_TIMEOUT);
+    SENSOR_LOG_E("[%s]process[%d] overrun,budget %d/%dms\r\n", builder->sensor->name, id,
+                 builder->process[id].budget, builder->budget);
+
+    if(builder->ops != NULL && builder->ops->invalidate != NULL) {
+        builder->ops->invalidate(builder);
+        return;
+    }
+    data_status_e status = DATA_STATUS_INVALID;
+    for(uint8_t i = 0; i < builder->cfg_num; i++) {
+        sensor_control(builder->sensor, SENSOR_CMD_STATUS_SET, &status, &i);
+    }
+}
 /**
  * @brief  传感器任务执行
  * @note   没有添加构建器退出
  *         传感器执行函数为空跳过
  *         传感器不允许执行跳过当前执行任务
+ *         设置周期的构建器未到执行时间跳过;处于低功耗的传感器执行前退出低功耗
+ *         阶段或构建器超出时间预算时通道标记为无效,跳过剩余阶段,继续执行其他构建器
  */
 void sensor_director_process(void)
 {
@@ -116,6 +185,22 @@ void sensor_director_process(void)
         if(builder->sensor == NULL) {
             continue;
         }
+        uint32_t now = sensor_time_get();
+        if(builder_due(builder, now) == false) {
+            continue;
+        }
+        if(builder->period != 0) {
+            //按周期对齐,延误超过一个周期时从当前时间重新计算
+            builder->next_run += builder->period;
+            if((int32_t)(now - builder->next_run) >= 0) {
+                builder->next_run = now + builder->period;
+            }
+        }
+        if(builder->lpm_state == true) {
+            if(builder_lpm(builder, false) == true) {
+                builder->lpm_state = false;
+            }
+        }
         if(builder->allow_mode == false) {
             if(builder->process->allow != NULL) {
                 if(builder->process->allow(builder->sensor, builder->cfg) == false) {
@@ -123,6 +208,8 @@ void sensor_director_process(void)
                 }
             }
         }
+        uint32_t start = sensor_time_get();
+        uint64_t energy = sensor_energy_total();
         for(uint8_t i = 0; i < builder->process_num; i++) {
             builder->current_id = i;
             if(builder->allow_mode == true) {
@@ -134,8 +221,107 @@ void sensor_director_process(void)
             }
 
             if(builder->process[i].handler != NULL) {
+                uint32_t stage_start = sensor_time_get();
+                sensor_deadline_set(builder_deadline(builder, builder->process[i].budget, stage_start - start));
                 builder->process[i].handler(builder->sensor, builder->cfg, builder->cfg_num);
+                //驱动协作退出或阻塞超时,均在阶段结束后判定
+                bool expired = sensor_deadline_expired();
+                sensor_deadline_clear();
+                if(expired == true) {
+                    builder_overrun(builder, i);
+                    break;
+                }
             }
         }
+        builder->run_time = sensor_time_get() - start;
+        builder->energy += sensor_energy_total() - energy;
+        builder->runs++;
+    }
+}
+/**
+ * @brief  获取调度空闲时间
+ * @note   距最近一个周期构建器执行的时间,不超过DIRECTOR_IDLE_MAX;存在未设置周期的构建器时返回0
+ * @retval 空闲时间(ms)
+ */
+uint32_t sensor_director_idle_time(void)
+{
+    uint32_t now = sensor_time_get();
+    uint32_t idle = DIRECTOR_IDLE_MAX;
+    sensor_builder_t *builder = NULL;
+    rt_list_for_each_entry(builder, &_builder_list, node) {
+        if(builder->sensor == NULL) {
+            continue;
+        }
+        if(builder_due(builder, now) == true) {
+            return 0;
+        }
+        uint32_t wait = builder->next_run - now;
+        if(wait < idle) {
+            idle = wait;
+        }
+    }
+    return idle;
+}
+/**
+ * @brief  调度空闲休眠
+ * @note   sensor_director_process后调用;
+ *         使能低功耗的构建器所管理的空闲传感器进入低功耗,再按最近的执行时间调用平台休眠
+ *         传感器在其构建器到期时由sensor_director_process退出低功耗
+ */
+void sensor_director_sleep(void)
+{
+    if(rt_list_isempty(&_builder_list)) {
+        return;
+    }
+    uint32_t idle = sensor_director_idle_time();
+    if(idle == 0) {
+        return;
+    }
+
+    sensor_builder_t *builder = NULL;
+    rt_list_for_each_entry(builder, &_builder_list, node) {
+        if(builder->sensor == NULL || builder->lpm_enable == false || builder->lpm_state == true) {
+            continue;
+        }
+        if(builder_lpm(builder, true) == true) {
+            builder->lpm_state = true;
+        }
+    }
+    sensor_lpm_sleep(idle);
+}
+/**
+ * @brief  平台低功耗休眠
+ * @note   默认osDelay让出CPU,由RTOS空闲任务进入低功耗;平台可重写为进入STOP模式并由RTC/LPTIM在ms后唤醒,
+ *         休眠期间须保持sensor_time时间源连续(如唤醒后补偿系统节拍)
+ *         可提前返回(如中断唤醒),调度器重新计算空闲时间
+ * @param  ms: 休眠时间,不超过DIRECTOR_IDLE_MAX
+ */
+__weak void sensor_lpm_sleep(uint32_t ms)
+{
+    osDelay(ms);
+}
+/**
+ * @brief  获取构建器累计能耗
+ * @note   执行期间关闭的传感器与模块上电区间能耗;执行结束后保持上电的部分不计入
+ * @param  *builder: 构建器
+ * @retval 能耗(mJ)
+ */
+float sensor_builder_energy_get(sensor_builder_t *builder)
+{
+    if(builder == NULL) {
+        return 0;
+    }
+    return (float)builder->energy / 1000000.0f;
+}
+/**
+ * @brief  获取构建器单次执行平均能耗
+ * @param  *builder: 构建器
+ * @retval 能耗(mJ),未执行返回0
+ */
+float sensor_builder_sample_energy(sensor_builder_t *builder)
+{
+    if(builder == NULL || builder->runs == 0) {
+        return 0;
     }
+    return (float)builder->energy / builder->runs / 1000000.0f;
 }
@@ -46,6 +46,7 @@ typedef struct
 {
     allow_process_t     allow;     //允许执行任务判断
     sensor_process_t    handler;   //传感器任务处理
+    uint32_t            budget;    //阶段时间预算(ms),0表示不限制
 }sensor_process_ops_t;
 
 typedef struct sensor_builder sensor_builder_t;
@@ -73,15 +74,31 @@ typedef bool (*sensor_init_t)(sensor_builder_t *builder);
  * @retval true: 成功 false: 失败
  */
 typedef bool (*sensor_config_add_t)(sensor_builder_t *builder, void *cfg, uint8_t len, bool default_flag);
+/**
+ * @brief  构建器所有传感器通道标记为无效
+ * @note   执行超出预算时调用;构建器管理多个传感器时须全部标记
+ * @param  *builder: 构建器
+ */
+typedef void (*sensor_invalidate_t)(sensor_builder_t *builder);
+/**
+ * @brief  构建器所有传感器进入/退出低功耗
+ * @note   调度空闲时与构建器到期时调用;构建器管理多个传感器时须全部处理
+ * @param  *builder: 构建器
+ * @param  lpm_flag: true:进入低功耗 false:退出低功耗
+ * @retval true: 成功 false: 失败
+ */
+typedef bool (*sensor_builder_lpm_t)(sensor_builder_t *builder, bool lpm_flag);
 /**
  * @brief  传感器构建接口
- * @note   
+ * @note   invalidate为空时仅标记builder->sensor的通道;lpm为空时仅控制builder->sensor
  */
 typedef struct 
 {
     sensor_add_t        sensor_add;
     sensor_init_t       sensor_init;
     sensor_config_add_t config_add;
+    sensor_invalidate_t invalidate;
+    sensor_builder_lpm_t lpm;
 }sensor_builder_ops_t;
 /**
  * @brief  传感器构建类
@@ -102,6 +119,21 @@ struct sensor_builder
     //true: 每个任务都需要判断 false: 只在第一次执行判断
     bool    allow_mode; 
     sensor_process_ops_t *process;
+
+    uint32_t period;    //执行周期(ms),0表示每次调度均执行
+    uint32_t next_run;  //下次执行时间(ms)
+    //true: 空闲时由调度器控制传感器进入低功耗 false: 由流程自行控制电源
+    //采集阶段自行开关传感器的流程(如default_collect)不应使能,否则每周期重复唤醒已关闭的传感器
+    bool    lpm_enable;
+    bool    lpm_state;  //传感器处于低功耗
+
+    uint32_t budget;        //构建器单次执行时间预算(ms),0表示不限制
+    uint32_t run_time;      //最近一次执行耗时(ms)
+    uint32_t overrun;       //超出预算次数
+    uint8_t  overrun_id;    //最近一次超出预算的阶段
+
+    uint32_t runs;          //执行次数
+    uint64_t energy;        //执行期间结算的能耗(nJ)
 };
 /* Exported constants --------------------------------------------------------*/
 
@@ -116,6 +148,11 @@ bool builder_config_add(sensor_builder_t *builder, void *cfg, uint8_t len, bool
 bool sensor_builder_add(sensor_builder_t *builder);
 bool sensor_director_init(void);
 void sensor_director_process(void);
+uint32_t sensor_director_idle_time(void);
+void sensor_director_sleep(void);
+void sensor_lpm_sleep(uint32_t ms);
+float sensor_builder_energy_get(sensor_builder_t *builder);
+float sensor_builder_sample_energy(sensor_builder_t *builder);
 
 #ifdef __cplusplus
 }
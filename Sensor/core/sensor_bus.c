@@ -0,0 +1,217 @@
+/**
+ * @file sensor_bus.c
+ * @brief 传感器数据总线
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 订阅与取消订阅在初始化阶段调用,不与发布并发;
+ * 发布在传感器任务中调用,最新数据读取与队列读取可在其他任务中调用
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_bus.h"
+/* Private includes ----------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static sensor_bus_topic_t _topic[SENSOR_BUS_TOPIC_MAX];
+static uint8_t _topic_num = 0;
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  查找主题
+ * @param  sensor: 传感器
+ * @param  id: 通道
+ * @retval 主题,未找到返回NULL
+ */
+static sensor_bus_topic_t *topic_find(sensor_device_t sensor, uint8_t id)
+{
+    for(uint8_t i = 0; i < _topic_num; i++) {
+        if(_topic[i].sensor == sensor && _topic[i].id == id) {
+            return &_topic[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief  订阅者初始化
+ * @note   callback与queue均为空时仅可通过sensor_bus_latest读取最新数据
+ * @param  *sub: 订阅者
+ * @param  callback: 回调,可为空
+ * @param  *arg: 回调参数
+ * @param  *queue: 队列缓冲区,可为空
+ * @param  size: 队列大小,须为2的幂
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_bus_sub_init(sensor_bus_sub_t *sub, sensor_bus_callback_t callback, void *arg,
+                         sensor_sample_t *queue, uint16_t size)
+{
+    if(sub == NULL) {
+        return false;
+    }
+    if(queue != NULL && (size == 0 || (size & (size - 1)) != 0)) {
+        return false;
+    }
+
+    memset(sub, 0, sizeof(sensor_bus_sub_t));
+    rt_list_init(&sub->node);
+    sub->callback = callback;
+    sub->arg = arg;
+    sub->queue = queue;
+    sub->size = (queue != NULL) ? size : 0;
+    return true;
+}
+/**
+ * @brief  订阅主题
+ * @note   主题不存在时创建;每个订阅者只订阅一个主题
+ * @param  *sub: 订阅者
+ * @param  sensor: 传感器
+ * @param  id: 通道
+ * @retval true: 成功 false: 主题已满或已订阅
+ */
+bool sensor_bus_subscribe(sensor_bus_sub_t *sub, sensor_device_t sensor, uint8_t id)
+{
+    if(sub == NULL || sensor == NULL || sub->topic != NULL) {
+        return false;
+    }
+
+    sensor_bus_topic_t *topic = topic_find(sensor, id);
+    if(topic == NULL) {
+        if(_topic_num >= SENSOR_BUS_TOPIC_MAX) {
+            return false;
+        }
+        topic = &_topic[_topic_num];
+        memset(topic, 0, sizeof(sensor_bus_topic_t));
+        topic->sensor = sensor;
+        topic->id = id;
+        rt_list_init(&topic->sub_list);
+        _topic_num++;
+    }
+
+    sub->topic = topic;
+    sub->seq = topic->seq;
+    //只读最新数据的订阅者不加入链表,发布开销与其数量无关
+    if(sub->callback != NULL || sub->queue != NULL) {
+        rt_list_insert_before(&topic->sub_list, &sub->node);
+    }
+    return true;
+}
+/**
+ * @brief  取消订阅
+ * @note   主题保留
+ * @param  *sub: 订阅者
+ */
+void sensor_bus_unsubscribe(sensor_bus_sub_t *sub)
+{
+    if(sub == NULL || sub->topic == NULL) {
+        return;
+    }
+    rt_list_remove(&sub->node);
+    sub->topic = NULL;
+}
+/**
+ * @brief  发布数据
+ * @note   无订阅者的通道直接返回;
+ *         最新数据写入一次,只读最新数据的订阅者不产生额外开销
+ * @param  sensor: 传感器
+ * @param  id: 通道
+ * @param  value: 数据
+ * @param  status: 数据状态
+ * @param  ts: 采集时间戳(ms)
+ */
+void sensor_bus_publish(sensor_device_t sensor, uint8_t id, float value, data_status_e status, uint32_t ts)
+{
+    sensor_bus_topic_t *topic = topic_find(sensor, id);
+    if(topic == NULL) {
+        return;
+    }
+
+    //顺序锁写入最新数据
+    uint32_t seq = topic->seq;
+    __atomic_store_n(&topic->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    topic->latest.sensor = sensor;
+    topic->latest.id = id;
+    topic->latest.status = (uint8_t)status;
+    topic->latest.value = value;
+    topic->latest.ts = ts;
+    __atomic_store_n(&topic->seq, seq + 2, __ATOMIC_RELEASE);
+
+    sensor_bus_sub_t *sub;
+    rt_list_for_each_entry(sub, &topic->sub_list, node) {
+        if(sub->callback != NULL) {
+            sub->callback(&topic->latest, sub->arg);
+        }
+        if(sub->queue != NULL) {
+            uint16_t head = sub->head;
+            if((uint16_t)(head - __atomic_load_n(&sub->tail, __ATOMIC_ACQUIRE)) >= sub->size) {
+                sub->drop++;
+                continue;
+            }
+            sub->queue[head & (sub->size - 1)] = topic->latest;
+            __atomic_store_n(&sub->head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+        }
+    }
+}
+/**
+ * @brief  读取最新数据
+ * @note   可在其他任务中调用;与发布冲突时返回false,数据不更新
+ * @param  *sub: 订阅者
+ * @param  *sample: 数据,可为空仅判断是否有新数据
+ * @retval true: 自上次读取后有新数据 false: 无新数据
+ */
+bool sensor_bus_latest(sensor_bus_sub_t *sub, sensor_sample_t *sample)
+{
+    if(sub == NULL || sub->topic == NULL) {
+        return false;
+    }
+
+    //读取任务优先级可能高于发布任务,写入中不自旋等待,直接返回由调用者稍后重试
+    sensor_bus_topic_t *topic = sub->topic;
+    uint32_t seq = __atomic_load_n(&topic->seq, __ATOMIC_ACQUIRE);
+    if((seq & 1) || seq == sub->seq) {
+        return false;
+    }
+    if(sample != NULL) {
+        *sample = topic->latest;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&topic->seq, __ATOMIC_RELAXED) != seq) {
+        return false;
+    }
+    sub->seq = seq;
+    return true;
+}
+/**
+ * @brief  读取队列数据
+ * @note   单消费者调用
+ * @param  *sub: 订阅者
+ * @param  *sample: 数据
+ * @retval true: 成功 false: 队列为空
+ */
+bool sensor_bus_pop(sensor_bus_sub_t *sub, sensor_sample_t *sample)
+{
+    if(sub == NULL || sub->queue == NULL || sample == NULL) {
+        return false;
+    }
+
+    uint16_t tail = sub->tail;
+    if(__atomic_load_n(&sub->head, __ATOMIC_ACQUIRE) == tail) {
+        return false;
+    }
+    *sample = sub->queue[tail & (sub->size - 1)];
+    __atomic_store_n(&sub->tail, (uint16_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file sensor_bus.h
+ * @brief 传感器数据总线
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 静态容量的发布/订阅,主题为(传感器,通道);
+ * 每个主题保存一份最新数据(顺序锁),只读最新数据的订阅者直接读取主题,发布时不复制;
+ * 回调订阅者在发布上下文中调用;队列订阅者使用单生产者单消费者无锁队列,队列满时丢弃并计数;
+ * 发布由流程末尾的default_publish/group_publish执行
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_BUS_H__
+#define __SENSOR_BUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sensor_driver.h"
+/* Exported constants --------------------------------------------------------*/
+#ifndef SENSOR_BUS_TOPIC_MAX
+#define SENSOR_BUS_TOPIC_MAX    16  //最大主题数量
+#endif
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  总线数据
+ * @note   None
+ */
+typedef struct
+{
+    sensor_device_t sensor;     //传感器
+    uint8_t         id;         //通道
+    uint8_t         status;     //数据状态 data_status_e
+    float           value;      //数据
+    uint32_t        ts;         //采集时间戳(ms)
+}sensor_sample_t;
+/**
+ * @brief  订阅回调
+ * @note   在发布上下文中调用,不可阻塞
+ */
+typedef void (*sensor_bus_callback_t)(const sensor_sample_t *sample, void *arg);
+/**
+ * @brief  主题
+ * @note   最新数据由顺序锁保护,seq为奇数表示正在写入
+ */
+typedef struct
+{
+    sensor_device_t     sensor;     //传感器,为空表示未使用
+    uint8_t             id;         //通道
+    volatile uint32_t   seq;        //顺序锁序号
+    sensor_sample_t     latest;     //最新数据
+    rt_list_t           sub_list;   //订阅者链表
+}sensor_bus_topic_t;
+/**
+ * @brief  订阅者
+ * @note   由使用者静态定义;callback与queue均为空时为只读最新数据订阅者
+ */
+typedef struct
+{
+    rt_list_t               node;       //主题订阅者链表节点
+    sensor_bus_topic_t      *topic;     //订阅主题
+    sensor_bus_callback_t   callback;   //回调,可为空
+    void                    *arg;       //回调参数
+    sensor_sample_t         *queue;     //队列缓冲区,可为空
+    uint16_t                size;       //队列大小,须为2的幂
+    volatile uint16_t       head;       //发布者写入位置
+    volatile uint16_t       tail;       //订阅者读取位置
+    uint32_t                drop;       //队列满丢弃数量
+    uint32_t                seq;        //已读最新数据序号
+}sensor_bus_sub_t;
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+bool sensor_bus_sub_init(sensor_bus_sub_t *sub, sensor_bus_callback_t callback, void *arg,
+                         sensor_sample_t *queue, uint16_t size);
+bool sensor_bus_subscribe(sensor_bus_sub_t *sub, sensor_device_t sensor, uint8_t id);
+void sensor_bus_unsubscribe(sensor_bus_sub_t *sub);
+void sensor_bus_publish(sensor_device_t sensor, uint8_t id, float value, data_status_e status, uint32_t ts);
+bool sensor_bus_latest(sensor_bus_sub_t *sub, sensor_sample_t *sample);
+bool sensor_bus_pop(sensor_bus_sub_t *sub, sensor_sample_t *sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_BUS_H__ */
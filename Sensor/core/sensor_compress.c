@@ -0,0 +1,316 @@
+/**
+ * @file sensor_compress.c
+ * @brief 传感器历史数据压缩块
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 样本编码格式(高位先行):
+ * 1. 时间戳二阶差分 dod
+ *    '0'             dod = 0
+ *    '10'   + 7bit   dod ∈ [-64, 63]
+ *    '110'  + 9bit   dod ∈ [-256, 255]
+ *    '1110' + 12bit  dod ∈ [-2048, 2047]
+ *    '1111' + 32bit  其他
+ * 2. 数据状态
+ *    '0'             数据有效,后跟数据差分
+ *    '1'    + 2bit   数据无效/超量程/无状态,不存储数据
+ * 3. 数据差分(量化值 = value * unit,zig-zag编码后记为zz)
+ *    '0'             zz = 0
+ *    '10'   + 4bit   zz < 16
+ *    '110'  + 8bit   zz < 256
+ *    '1110' + 12bit  zz < 4096
+ *    '1111' + 32bit  其他
+ * 周期采集时时间戳多数仅占1bit,温湿度等慢变数据多数占1~6bit
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_compress.h"
+/* Private includes ----------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+#define ZIGZAG_ENCODE(x)    (((uint32_t)(x) << 1) ^ (uint32_t)((int32_t)(x) >> 31))
+#define ZIGZAG_DECODE(x)    ((int32_t)(((x) >> 1) ^ (~((x) & 1) + 1)))
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  写入bit
+ * @note   高位先行,调用前需确认剩余空间
+ * @param  *block: 压缩块
+ * @param  value: 写入值
+ * @param  bits: 写入位数 1~32
+ */
+static void bits_put(sensor_compress_t *block, uint32_t value, uint8_t bits)
+{
+    while(bits > 0) {
+        bits--;
+        uint32_t byte = block->bit_pos >> 3;
+        uint8_t  mask = 0x80 >> (block->bit_pos & 0x07);
+        if((value >> bits) & 0x01) {
+            block->buf[byte] |= mask;
+        } else {
+            block->buf[byte] &= ~mask;
+        }
+        block->bit_pos++;
+    }
+}
+/**
+ * @brief  读取bit
+ * @note   高位先行
+ * @param  *buf: 存储区
+ * @param  *bit_pos: 读取位置
+ * @param  bits: 读取位数 1~32
+ * @retval 读取值
+ */
+static uint32_t bits_get(const uint8_t *buf, uint32_t *bit_pos, uint8_t bits)
+{
+    uint32_t value = 0;
+    while(bits > 0) {
+        bits--;
+        uint32_t byte = *bit_pos >> 3;
+        uint8_t  mask = 0x80 >> (*bit_pos & 0x07);
+        value = (value << 1) | ((buf[byte] & mask) ? 1 : 0);
+        (*bit_pos)++;
+    }
+    return value;
+}
+/**
+ * @brief  读取前缀
+ * @note   连续读取'1',遇到'0'或达到最大长度停止
+ * @param  *buf: 存储区
+ * @param  *bit_pos: 读取位置
+ * @param  max: 前缀最大长度
+ * @retval 前缀中'1'的数量
+ */
+static uint8_t prefix_get(const uint8_t *buf, uint32_t *bit_pos, uint8_t max)
+{
+    uint8_t ones = 0;
+    while(ones < max && bits_get(buf, bit_pos, 1) == 1) {
+        ones++;
+    }
+    return ones;
+}
+/**
+ * @brief  时间戳二阶差分编码长度
+ * @param  dod: 二阶差分
+ * @param  *prefix: 前缀
+ * @param  *prefix_bits: 前缀长度
+ * @retval 数据长度
+ */
+static uint8_t dod_class(int32_t dod, uint8_t *prefix, uint8_t *prefix_bits)
+{
+    if(dod == 0) {
+        *prefix = 0x00; *prefix_bits = 1;
+        return 0;
+    } else if(dod >= -64 && dod <= 63) {
+        *prefix = 0x02; *prefix_bits = 2;
+        return 7;
+    } else if(dod >= -256 && dod <= 255) {
+        *prefix = 0x06; *prefix_bits = 3;
+        return 9;
+    } else if(dod >= -2048 && dod <= 2047) {
+        *prefix = 0x0E; *prefix_bits = 4;
+        return 12;
+    } else {
+        *prefix = 0x0F; *prefix_bits = 4;
+        return 32;
+    }
+}
+/**
+ * @brief  数据差分编码长度
+ * @param  zz: zig-zag编码后的差分
+ * @param  *prefix: 前缀
+ * @param  *prefix_bits: 前缀长度
+ * @retval 数据长度
+ */
+static uint8_t value_class(uint32_t zz, uint8_t *prefix, uint8_t *prefix_bits)
+{
+    if(zz == 0) {
+        *prefix = 0x00; *prefix_bits = 1;
+        return 0;
+    } else if(zz < 16) {
+        *prefix = 0x02; *prefix_bits = 2;
+        return 4;
+    } else if(zz < 256) {
+        *prefix = 0x06; *prefix_bits = 3;
+        return 8;
+    } else if(zz < 4096) {
+        *prefix = 0x0E; *prefix_bits = 4;
+        return 12;
+    } else {
+        *prefix = 0x0F; *prefix_bits = 4;
+        return 32;
+    }
+}
+/**
+ * @brief  压缩块初始化
+ * @note   None
+ * @param  *block: 压缩块
+ * @param  *buf: 存储区
+ * @param  size: 存储区大小(字节)
+ * @param  unit: 数据单位,例如10表示0.1精度
+ */
+void sensor_compress_init(sensor_compress_t *block, uint8_t *buf, uint16_t size, float unit)
+{
+    if(block == NULL) {
+        return;
+    }
+    memset(block, 0, sizeof(sensor_compress_t));
+    block->buf  = buf;
+    block->size = size;
+    block->unit = (unit > 0) ? unit : 1;
+}
+/**
+ * @brief  追加样本
+ * @note   剩余空间不足或样本数量达到上限时返回失败,块内容保持不变
+ * @param  *block: 压缩块
+ * @param  ts: 时间戳
+ * @param  value: 数据
+ * @param  status: 数据状态
+ * @retval true: 成功 false: 空间不足或数量已满
+ */
+bool sensor_compress_append(sensor_compress_t *block, uint32_t ts, float value, data_status_e status)
+{
+    if(block == NULL || block->buf == NULL || block->count == UINT16_MAX) {
+        return false;
+    }
+
+    uint8_t ts_prefix = 0, ts_prefix_bits = 0;
+    uint8_t v_prefix = 0, v_prefix_bits = 0;
+    uint8_t v_bits = 0;
+    uint32_t needed = 0;
+
+    int32_t delta = (int32_t)(ts - block->last_ts);
+    int32_t dod = (int32_t)((uint32_t)delta - (uint32_t)block->last_delta);
+    uint8_t ts_bits = dod_class(dod, &ts_prefix, &ts_prefix_bits);
+    needed = ts_prefix_bits + ts_bits + 1;
+
+    int32_t quant = 0;
+    uint32_t zz = 0;
+    if(status == DATA_STATUS_VALID) {
+        quant = (int32_t)lroundf(value * block->unit);
+        zz = ZIGZAG_ENCODE((int32_t)((uint32_t)quant - (uint32_t)block->last_value));
+        v_bits = value_class(zz, &v_prefix, &v_prefix_bits);
+        needed += v_prefix_bits + v_bits;
+    } else {
+        needed += 2;
+    }
+
+    if(block->bit_pos + needed > (uint32_t)block->size * 8) {
+        return false;
+    }
+
+    bits_put(block, ts_prefix, ts_prefix_bits);
+    if(ts_bits != 0) {
+        bits_put(block, (uint32_t)dod & (0xFFFFFFFF >> (32 - ts_bits)), ts_bits);
+    }
+    if(status == DATA_STATUS_VALID) {
+        bits_put(block, 0, 1);
+        bits_put(block, v_prefix, v_prefix_bits);
+        if(v_bits != 0) {
+            bits_put(block, zz, v_bits);
+        }
+        block->last_value = quant;
+    } else {
+        bits_put(block, 1, 1);
+        bits_put(block, (status == DATA_STATUS_INVALID) ? 0 : (status == DATA_STATUS_OUTRANGE) ? 1 : 2, 2);
+    }
+
+    block->last_ts = ts;
+    block->last_delta = delta;
+    block->count++;
+    return true;
+}
+/**
+ * @brief  获取压缩块已使用字节数
+ * @param  *block: 压缩块
+ * @retval 已使用字节数
+ */
+uint16_t sensor_compress_bytes(const sensor_compress_t *block)
+{
+    if(block == NULL) {
+        return 0;
+    }
+    return (uint16_t)((block->bit_pos + 7) >> 3);
+}
+/**
+ * @brief  遍历器初始化
+ * @note   从块内第一个样本开始遍历
+ * @param  *block: 压缩块
+ * @param  *iter: 遍历器
+ */
+void sensor_compress_iter_init(const sensor_compress_t *block, sensor_compress_iter_t *iter)
+{
+    if(block == NULL || iter == NULL) {
+        return;
+    }
+    memset(iter, 0, sizeof(sensor_compress_iter_t));
+}
+/**
+ * @brief  读取下一个样本
+ * @note   逐点解码,可在追加过程中同时遍历
+ * @param  *block: 压缩块
+ * @param  *iter: 遍历器
+ * @param  *ts: 时间戳
+ * @param  *value: 数据,数据无效时不修改
+ * @param  *status: 数据状态
+ * @retval true: 成功 false: 无更多样本
+ */
+bool sensor_compress_next(const sensor_compress_t *block, sensor_compress_iter_t *iter,
+                          uint32_t *ts, float *value, data_status_e *status)
+{
+    if(block == NULL || iter == NULL || iter->index >= block->count) {
+        return false;
+    }
+
+    static const uint8_t dod_bits[] = {0, 7, 9, 12, 32};
+    static const uint8_t val_bits[] = {0, 4, 8, 12, 32};
+    static const data_status_e status_map[] = {DATA_STATUS_INVALID, DATA_STATUS_OUTRANGE, DATA_STATUS_NONE, DATA_STATUS_NONE};
+
+    uint8_t cls = prefix_get(block->buf, &iter->bit_pos, 4);
+    uint8_t bits = dod_bits[cls];
+    int32_t dod = 0;
+    if(bits != 0) {
+        uint32_t raw = bits_get(block->buf, &iter->bit_pos, bits);
+        //符号扩展
+        dod = (bits == 32) ? (int32_t)raw : (int32_t)(raw << (32 - bits)) >> (32 - bits);
+    }
+    iter->delta = (int32_t)((uint32_t)iter->delta + (uint32_t)dod);
+    iter->ts += (uint32_t)iter->delta;
+
+    data_status_e st = DATA_STATUS_VALID;
+    if(bits_get(block->buf, &iter->bit_pos, 1) == 0) {
+        cls = prefix_get(block->buf, &iter->bit_pos, 4);
+        bits = val_bits[cls];
+        if(bits != 0) {
+            uint32_t zz = bits_get(block->buf, &iter->bit_pos, bits);
+            iter->value = (int32_t)((uint32_t)iter->value + (uint32_t)ZIGZAG_DECODE(zz));
+        }
+        if(value != NULL) {
+            *value = (float)iter->value / block->unit;
+        }
+    } else {
+        st = status_map[bits_get(block->buf, &iter->bit_pos, 2)];
+    }
+
+    if(ts != NULL) {
+        *ts = iter->ts;
+    }
+    if(status != NULL) {
+        *status = st;
+    }
+    iter->index++;
+    return true;
+}
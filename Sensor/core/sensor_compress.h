@@ -0,0 +1,76 @@
+/**
+ * @file sensor_compress.h
+ * @brief 传感器历史数据压缩块
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 时间戳使用二阶差分(delta-of-delta)编码,数据按通道unit量化为整数后使用zig-zag差分编码;
+ * 支持逐点追加与逐点遍历,无需解压整块
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_COMPRESS_H__
+#define __SENSOR_COMPRESS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sensor_driver.h"
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  压缩块
+ * @note   存储区由调用者提供,块内只保存编码状态,不占用额外内存
+ */
+typedef struct
+{
+    uint8_t    *buf;            //块存储区
+    uint16_t    size;           //存储区大小(字节)
+    uint32_t    bit_pos;        //写入位置(bit),存储区大于8KB时超出16位
+    uint16_t    count;          //样本数量,达到0xFFFF后不再追加
+    float       unit;           //数据单位,与通道配置unit一致
+    //编码状态
+    uint32_t    last_ts;        //上一个时间戳
+    int32_t     last_delta;     //上一个时间戳差值
+    int32_t     last_value;     //上一个有效量化值
+}sensor_compress_t;
+/**
+ * @brief  压缩块遍历器
+ * @note   None
+ */
+typedef struct
+{
+    uint32_t    bit_pos;        //读取位置(bit)
+    uint16_t    index;          //已读取样本数量
+    uint32_t    ts;             //当前时间戳
+    int32_t     delta;          //当前时间戳差值
+    int32_t     value;          //当前有效量化值
+}sensor_compress_iter_t;
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define SENSOR_COMPRESS_SAMPLE_MAX_BITS     (1 + 2 + 4 + 32 + 4 + 32)  //单个样本最大编码长度
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void sensor_compress_init(sensor_compress_t *block, uint8_t *buf, uint16_t size, float unit);
+bool sensor_compress_append(sensor_compress_t *block, uint32_t ts, float value, data_status_e status);
+uint16_t sensor_compress_bytes(const sensor_compress_t *block);
+
+void sensor_compress_iter_init(const sensor_compress_t *block, sensor_compress_iter_t *iter);
+bool sensor_compress_next(const sensor_compress_t *block, sensor_compress_iter_t *iter,
+                          uint32_t *ts, float *value, data_status_e *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_COMPRESS_H__ */
@@ -15,8 +15,6 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_default.h"
 /* Private includes ----------------------------------------------------------*/
-#include "module_debug.h"
-
 #include "board_system.h"
 #include "board_params.h"
 /* Private typedef -----------------------------------------------------------*/
@@ -119,9 +117,11 @@ void default_collect(sensor_device_t sensor, void *cfg, uint8_t num)
     sensor_close(sensor);
 
     while (ret != true) {
-        if(sensor_cfg[0].collect.err_cnt < sensor_cfg[0].allow_retry_collect_cnt) {
+        if(sensor_cfg[0].collect.err_cnt < sensor_cfg[0].allow_retry_collect_cnt
+        && sensor_deadline_expired() == false) {
             sensor_cfg[0].collect.err_cnt++;
-            printf_info("[%s][retry]collect%d/%d\r\n", sensor->name, sensor_cfg[0].collect.err_cnt, sensor_cfg[0].allow_retry_collect_cnt);
+            sensor_stats_event(sensor, SENSOR_STATS_RETRY);
+            SENSOR_LOG_I("[%s][retry]collect%d/%d\r\n", sensor->name, sensor_cfg[0].collect.err_cnt, sensor_cfg[0].allow_retry_collect_cnt);
             if(allow_flag == true) {
                 sensor_cfg[0].collect.count++;
             }
@@ -132,13 +132,17 @@ void default_collect(sensor_device_t sensor, void *cfg, uint8_t num)
                 ret = sensor_collect(sensor);
             }
             sensor_close(sensor);
+        } else if(sensor_cfg[0].collect.err_cnt < sensor_cfg[0].allow_retry_collect_cnt) {
+            //截止时间到达中止重采,超时由构建器阶段结束后统计,不计入采集失败
+            SENSOR_LOG_I("[%s][timeout]collect%d/%d\r\n", sensor->name, sensor_cfg[0].collect.err_cnt, sensor_cfg[0].allow_retry_collect_cnt);
+            break;
         } else {
             if (sensor_cfg[0].collect.normal == false) {
                 if(sensor_cfg[0].ops.fault_handler != NULL) {
                     sensor_cfg[0].ops.fault_handler(sensor_cfg);
                 } else {
                     //默认处理
-                    printf_info("[%s][error]fault\r\n", sensor->name);
+                    SENSOR_LOG_I("[%s][error]fault\r\n", sensor->name);
 
                 }
             } else {
@@ -147,7 +151,7 @@ void default_collect(sensor_device_t sensor, void *cfg, uint8_t num)
                 } else {
                     //默认处理
                     sensor_cfg[0].collect.fail_count++;
-                    printf_info("[%s][fail]collect%d/%d\r\n", sensor->name, sensor_cfg[0].collect.fail_count, sensor_cfg[0].allow_collect_fail_cnt);
+                    SENSOR_LOG_I("[%s][fail]collect%d/%d\r\n", sensor->name, sensor_cfg[0].collect.fail_count, sensor_cfg[0].allow_collect_fail_cnt);
                     if(sensor_cfg[0].collect.fail_count > sensor_cfg[0].allow_collect_fail_cnt) {
                         device_restart();
                     }
@@ -157,6 +161,7 @@ void default_collect(sensor_device_t sensor, void *cfg, uint8_t num)
         }
     }
     float data = 0;
+    uint32_t ts = 0;
     data_status_e status = DATA_STATUS_VALID;
     uint8_t data_id = 0;
     for(uint8_t i = 0; i < num; i++) {
@@ -168,6 +173,9 @@ void default_collect(sensor_device_t sensor, void *cfg, uint8_t num)
             sensor_control(sensor, SENSOR_CMD_STATUS_SET, &status, &i);
             sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &data_id);
             sensor_control(sensor, SENSOR_CMD_DATA_SET, &data, &i);
+            //数据值沿用原始数据采集时间戳
+            sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &data_id);
+            sensor_control(sensor, SENSOR_CMD_TIME_SET, &ts, &i);
         } else {
             status = DATA_STATUS_INVALID;
             sensor_control(sensor, SENSOR_CMD_STATUS_SET, &status, &i);
@@ -196,7 +204,7 @@ void default_calibration(sensor_device_t sensor, void *cfg, uint8_t num)
             return;
         }
         if(sensor_cfg[i].cal_addr == 0) {
-            printf_error("[%s]num[%d]calibration addr is invalid\r\n", sensor->name, i);
+            SENSOR_LOG_E("[%s]num[%d]calibration addr is invalid\r\n", sensor->name, i);
             return;
         }
 
@@ -205,7 +213,7 @@ void default_calibration(sensor_device_t sensor, void *cfg, uint8_t num)
             uint8_t data_id = SENSOR_DATA_GET_RAW - i;
             sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &data_id);
             float cal = (float)sensor_params.calibration_value / sensor_cfg[i].unit;
-            printf_debug("[%s]num[%d][cal]%s\r\n", sensor->name, i, ftoc(cal, 3));
+            SENSOR_LOG_D("[%s]num[%d][cal]%.3f\r\n", sensor->name, i, cal);
             data += cal;
             sensor_control(sensor, SENSOR_CMD_DATA_SET, &data, &i);
         }
@@ -230,7 +238,7 @@ void default_range_check(sensor_device_t sensor, void *cfg, uint8_t num)
             continue;
         }
         sensor_default_cfg_t sensor_cfg = (sensor_default_cfg_t)cfg;
-        printf_debug("[%s]num[%d]range[%d ~ %d]\r\n", sensor->name, i, sensor_cfg[i].check.min, sensor_cfg[i].check.max);
+        SENSOR_LOG_D("[%s]num[%d]range[%d ~ %d]\r\n", sensor->name, i, sensor_cfg[i].check.min, sensor_cfg[i].check.max);
 
         sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &i);
         int16_t temp = data * sensor_cfg[i].unit;
@@ -265,7 +273,7 @@ void default_data_check(sensor_device_t sensor, void *cfg, uint8_t num)
         }
 
         sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &i);
-        printf_debug("[%s]num[%d]data[%s]\r\n", sensor->name, i, ftoc(data, 3));
+        SENSOR_LOG_D("[%s]num[%d]data[%.3f]\r\n", sensor->name, i, data);
     }
 }
 /**
@@ -283,10 +291,74 @@ void default_alarm(sensor_device_t sensor, void *cfg, uint8_t num)
     sensor_default_cfg_t sensor_cfg = (sensor_default_cfg_t)cfg;
     for(uint8_t i = 0; i < num; i++) {
         if(sensor_cfg[i].ops.alarm_handler == NULL) {
-            return;
+            continue;
         }
         float data = 0;
         sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &i);
         sensor_cfg[i].ops.alarm_handler(sensor, sensor_cfg, &data);
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief  默认传感器报警判定处理
+ * @note   按通道报警规则增量判定,仅在报警状态变化时调用报警事件处理函数
+ *         变化率按采集时间戳计算
+ *         无报警规则的通道跳过
+ * @param  sensor: 传感器设备
+ * @param  *cfg: 构建器配置
+ * @retval None
+ */
+void default_alarm_check(sensor_device_t sensor, void *cfg, uint8_t num)
+{
+    if(cfg == NULL) {
+        return;
+    }
+    sensor_default_cfg_t sensor_cfg = (sensor_default_cfg_t)cfg;
+    for(uint8_t i = 0; i < num; i++) {
+        if(sensor_cfg[i].alarm.rule == NULL) {
+            continue;
+        }
+        float data = 0;
+        uint32_t ts = 0;
+        data_status_e status = DATA_STATUS_NONE;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &i);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &i);
+        sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &i);
+
+        sensor_alarm_event_t event = {
+            .sensor = sensor,
+            .id     = i,
+            .value  = data,
+            .ts     = ts,
+        };
+        if(sensor_alarm_update(&sensor_cfg[i].alarm, data, status, ts, &event.prev) == false) {
+            continue;
+        }
+        event.state = sensor_cfg[i].alarm.state.state;
+        SENSOR_LOG_I("[%s]num[%d]alarm[0x%02x -> 0x%02x]\r\n", sensor->name, i, event.prev, event.state);
+        if(sensor_cfg[i].ops.alarm_event_handler != NULL) {
+            sensor_cfg[i].ops.alarm_event_handler(sensor, &sensor_cfg[i], &event);
+        }
+    }
+}
+/**
+ * @brief  默认传感器数据发布处理
+ * @note   置于流程末尾,发布各通道最终数据、状态与采集时间戳至数据总线
+ * @param  sensor: 传感器设备
+ * @param  *cfg: 构建器配置
+ * @retval None
+ */
+void default_publish(sensor_device_t sensor, void *cfg, uint8_t num)
+{
+    if(cfg == NULL) {
+        return;
+    }
+    for(uint8_t i = 0; i < num; i++) {
+        float data = 0;
+        uint32_t ts = 0;
+        data_status_e status = DATA_STATUS_NONE;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &i);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &i);
+        sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &i);
+        sensor_bus_publish(sensor, i, data, status, ts);
+    }
+}
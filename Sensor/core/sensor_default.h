@@ -20,6 +20,8 @@ extern "C" {
 #endif
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_builder.h"
+#include "sensor_alarm.h"
+#include "sensor_bus.h"
 /* Exported types ------------------------------------------------------------*/
 typedef struct sensor_default_cfg *sensor_default_cfg_t;
 /**
@@ -52,6 +54,11 @@ typedef struct
      * @retval 返回OK表示数据有效,其他表示数据无效
      */
     void    (*alarm_handler)(sensor_device_t sensor, sensor_default_cfg_t cfg, void *data);
+    /**
+     * @brief  报警事件处理函数
+     * @note   default_alarm_check调用,仅在报警状态变化时调用
+     */
+    void    (*alarm_event_handler)(sensor_device_t sensor, sensor_default_cfg_t cfg, const sensor_alarm_event_t *event);
 }sensor_default_ops_t;
 /**
  * @brief  传感器默认配置类
@@ -84,6 +91,7 @@ struct sensor_default_cfg
         uint8_t     fail_count; //采集失败次数
         uint32_t    count;      //采集次数
     }collect;
+    sensor_alarm_t alarm;               //报警规则与状态
     sensor_default_ops_t ops;
 };
 /* Exported constants --------------------------------------------------------*/
@@ -98,6 +106,8 @@ void default_calibration(sensor_device_t sensor, void *cfg, uint8_t num);
 void default_range_check(sensor_device_t sensor, void *cfg, uint8_t num);
 void default_data_check(sensor_device_t sensor, void *cfg, uint8_t num);
 void default_alarm(sensor_device_t sensor, void *cfg, uint8_t num);
+void default_alarm_check(sensor_device_t sensor, void *cfg, uint8_t num);
+void default_publish(sensor_device_t sensor, void *cfg, uint8_t num);
 
 #ifdef __cplusplus
 }
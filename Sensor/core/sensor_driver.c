@@ -17,12 +17,81 @@
 /* Private typedef -----------------------------------------------------------*/
 
 /* Private define ------------------------------------------------------------*/
-
+#define STATS_LINE_SIZE     128     //统计输出单行缓冲区大小
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
 static rt_list_t _sensor_list = RT_LIST_OBJECT_INIT(_sensor_list);
+static uint64_t _energy_total = 0;  //所有传感器与模块已结算能耗(nJ)
 /* Private function prototypes -----------------------------------------------*/
+/**
+ * @brief  耗时计入直方图
+ * @note   log2分桶,计数饱和
+ * @param  *hist: 直方图
+ * @param  ms: 耗时
+ */
+static void stats_hist_add(uint16_t *hist, uint32_t ms)
+{
+    uint8_t k = 0;
+    while(ms != 0 && k < SENSOR_STATS_HIST_NUM - 1) {
+        ms >>= 1;
+        k++;
+    }
+    if(hist[k] != UINT16_MAX) {
+        hist[k]++;
+    }
+}
+/**
+ * @brief  进入上电区间
+ * @param  *energy: 能耗统计
+ */
+static void energy_on(sensor_energy_t *energy)
+{
+    if(energy->powered == false) {
+        energy->powered = true;
+        energy->on_ts = sensor_time_get();
+    }
+}
+/**
+ * @brief  计算上电区间能耗
+ * @param  *energy: 能耗统计
+ * @param  ms: 上电时间
+ * @retval 能耗(nJ)
+ */
+static uint64_t energy_calc(const sensor_energy_t *energy, uint32_t ms)
+{
+    //mV * uA * ms / 1000 = nJ
+    return (uint64_t)SENSOR_SUPPLY_MV * energy->current * ms / 1000;
+}
+/**
+ * @brief  结束上电区间并累计能耗
+ * @param  *energy: 能耗统计
+ */
+static void energy_off(sensor_energy_t *energy)
+{
+    if(energy->powered == true) {
+        uint32_t ms = sensor_time_age(energy->on_ts);
+        uint64_t nj = energy_calc(energy, ms);
+        energy->powered = false;
+        energy->on_time += ms;
+        energy->energy += nj;
+        _energy_total += nj;
+    }
+}
+/**
+ * @brief  获取累计能耗
+ * @note   包含当前未结束的上电区间
+ * @param  *energy: 能耗统计
+ * @retval 能耗(nJ)
+ */
+static uint64_t energy_now(const sensor_energy_t *energy)
+{
+    uint64_t nj = energy->energy;
+    if(energy->powered == true) {
+        nj += energy_calc(energy, sensor_time_age(energy->on_ts));
+    }
+    return nj;
+}
 /**
  * @brief 传感器注册函数
  * @note   供驱动注册
@@ -100,17 +169,21 @@ bool sensor_open(sensor_device_t dev)
     }
 
     bool err = true;
+    uint32_t start = sensor_time_get();
 
     if (dev->module != NULL && dev->module->open != NULL) {
         if (dev->module->status != SENSOR_MODULE_OPEN) {
             dev->module->status = SENSOR_MODULE_OPEN;
+            energy_on(&dev->module->energy);
             err = dev->module->open(dev);
         }
     }
 
     if(err == true) {
+        energy_on(&dev->energy);
         err = dev->ops->open(dev);
     }
+    stats_hist_add(dev->stats.open_hist, sensor_time_age(start));
 
     return err;
 }
@@ -127,22 +200,26 @@ bool sensor_close(sensor_device_t dev)
     }
 
     bool err = true;
-    if (dev->module->close != NULL && dev->module != NULL) {
+    uint32_t start = sensor_time_get();
+    if (dev->module != NULL && dev->module->close != NULL) {
         if (dev->module->status != SENSOR_MODULE_CLOSE) {
             dev->module->status = SENSOR_MODULE_CLOSE;
             err = dev->module->close(dev);
+            energy_off(&dev->module->energy);
         }
     }
 
     if(err == true) {
         err = dev->ops->close(dev);
     }
+    energy_off(&dev->energy);
+    stats_hist_add(dev->stats.close_hist, sensor_time_age(start));
 
     return err;
 }
 /**
  * @brief  传感器读取
- * @note   None
+ * @note   模块已处于读取状态时跳过采集并返回true,不计入成功/失败统计
  * @param  dev: 传感器设备
  * @retval 错误码
  */
@@ -153,14 +230,29 @@ bool sensor_collect(sensor_device_t dev)
     }
 
     bool err = true;
+    uint32_t start = sensor_time_get();
     if (dev->module != NULL) {
         if(dev->module->status != SENSOR_MODULE_READ) {
             dev->module->status = SENSOR_MODULE_READ;
             err = dev->ops->collect(dev);
+        } else {
+            //模块已由其他成员读取,本次未实际采集,不计入统计
+            return err;
         }
     } else {
         err = dev->ops->collect(dev);
     }
+    stats_hist_add(dev->stats.collect_hist, sensor_time_age(start));
+    if(err == true) {
+        dev->stats.success++;
+        dev->stats.fail_streak = 0;
+        dev->stats.last_good = sensor_time_get();
+    } else {
+        dev->stats.fail++;
+        if(dev->stats.fail_streak != UINT16_MAX) {
+            dev->stats.fail_streak++;
+        }
+    }
 
     return err;
 }
@@ -183,19 +275,23 @@ bool sensor_lpm(sensor_device_t dev, bool lpm_flag)
             if (dev->module->status != SENSOR_MODULE_LPM_IN) {
                 dev->module->status = SENSOR_MODULE_LPM_IN;
                 ret = dev->module->close(dev);
+                energy_off(&dev->module->energy);
             }
         }
         if(ret == true) {
             ret = dev->ops->close(dev);
         }
+        energy_off(&dev->energy);
     } else {
         if (dev->module != NULL && dev->module->open != NULL) {
             if (dev->module->status != SENSOR_MODULE_LPM_OUT) {
                 dev->module->status = SENSOR_MODULE_LPM_OUT;
+                energy_on(&dev->module->energy);
                 ret = dev->module->open(dev);
             }
         }
         if(ret == true) {
+            energy_on(&dev->energy);
             ret = dev->ops->open(dev);
         }
     }
@@ -218,4 +314,147 @@ bool sensor_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, void *arg
     }
 
     return dev->ops->control(dev, cmd, data, arg);
-}
\ No newline at end of file
+}
+/**
+ * @brief  获取传感器统计
+ * @param  dev: 传感器设备
+ * @retval 统计,传感器为空返回NULL
+ */
+const sensor_stats_t *sensor_stats_get(sensor_device_t dev)
+{
+    if(dev == NULL) {
+        return NULL;
+    }
+    return &dev->stats;
+}
+/**
+ * @brief  上报传感器统计事件
+ * @note   重采由采集策略上报,CRC错误由驱动上报,超时由调度器上报
+ * @param  dev: 传感器设备
+ * @param  event: 统计事件
+ */
+void sensor_stats_event(sensor_device_t dev, sensor_stats_e event)
+{
+    if(dev == NULL) {
+        return;
+    }
+    switch(event) {
+        case SENSOR_STATS_RETRY:
+            dev->stats.retry++;
+            break;
+        case SENSOR_STATS_CRC:
+            dev->stats.crc_err++;
+            break;
+        case SENSOR_STATS_TIMEOUT:
+            dev->stats.timeout++;
+            break;
+        default:
+            break;
+    }
+}
+/**
+ * @brief  清除传感器统计
+ * @param  dev: 传感器设备,为空清除所有传感器
+ */
+void sensor_stats_reset(sensor_device_t dev)
+{
+    if(dev != NULL) {
+        memset(&dev->stats, 0, sizeof(sensor_stats_t));
+        return;
+    }
+    sensor_device_t sensor = NULL;
+    rt_list_for_each_entry(sensor, &_sensor_list, sensor_node) {
+        memset(&sensor->stats, 0, sizeof(sensor_stats_t));
+    }
+}
+/**
+ * @brief  输出直方图
+ * @param  *name: 名称
+ * @param  *hist: 直方图
+ */
+static void stats_hist_dump(const char *name, const uint16_t *hist)
+{
+    char line[STATS_LINE_SIZE];
+    int len = snprintf(line, sizeof(line), "  %-7s", name);
+    for(uint8_t k = 0; k < SENSOR_STATS_HIST_NUM && len > 0 && len < (int)sizeof(line); k++) {
+        len += snprintf(&line[len], sizeof(line) - len, " %u", hist[k]);
+    }
+    if(len > 0 && len < (int)sizeof(line) - 2) {
+        snprintf(&line[len], sizeof(line) - len, "\r\n");
+    }
+    sensor_log_output(line);
+}
+/**
+ * @brief  输出单个传感器统计
+ * @param  dev: 传感器设备
+ */
+static void stats_dump_one(sensor_device_t dev)
+{
+    char line[STATS_LINE_SIZE];
+    const sensor_stats_t *st = &dev->stats;
+    snprintf(line, sizeof(line), "[%s]ok:%lu fail:%lu retry:%lu crc:%lu timeout:%lu streak:%u age:%lums\r\n",
+             dev->name, (unsigned long)st->success, (unsigned long)st->fail, (unsigned long)st->retry,
+             (unsigned long)st->crc_err, (unsigned long)st->timeout, st->fail_streak,
+             (unsigned long)((st->success != 0) ? sensor_time_age(st->last_good) : 0));
+    sensor_log_output(line);
+    stats_hist_dump("open", st->open_hist);
+    stats_hist_dump("collect", st->collect_hist);
+    stats_hist_dump("close", st->close_hist);
+}
+/**
+ * @brief  输出传感器统计
+ * @note   同步输出,不经过延迟日志缓冲区;直方图各列依次为0ms,1ms,2~3ms,4~7ms...
+ * @param  dev: 传感器设备,为空输出所有传感器
+ */
+void sensor_stats_dump(sensor_device_t dev)
+{
+    if(dev != NULL) {
+        stats_dump_one(dev);
+        return;
+    }
+    sensor_device_t sensor = NULL;
+    rt_list_for_each_entry(sensor, &_sensor_list, sensor_node) {
+        stats_dump_one(sensor);
+    }
+}
+/**
+ * @brief  获取传感器累计能耗
+ * @note   不含所属模块公共部分
+ * @param  dev: 传感器设备
+ * @retval 能耗(mJ)
+ */
+float sensor_energy_get(sensor_device_t dev)
+{
+    if(dev == NULL) {
+        return 0;
+    }
+    return (float)energy_now(&dev->energy) / 1000000.0f;
+}
+/**
+ * @brief  获取模块累计能耗
+ * @note   模块公共部分与所有成员传感器之和
+ * @param  *module: 传感器模块
+ * @retval 能耗(mJ)
+ */
+float sensor_module_energy_get(sensor_module_t *module)
+{
+    if(module == NULL) {
+        return 0;
+    }
+    uint64_t nj = energy_now(&module->energy);
+    for(uint8_t i = 0; i < module->sen_num && i < SENSOR_MODULE_MAX; i++) {
+        if(module->sen[i] != NULL) {
+            nj += energy_now(&module->sen[i]->energy);
+        }
+    }
+    return (float)nj / 1000000.0f;
+}
+/**
+ * @brief  获取已结算总能耗
+ * @note   所有传感器与模块已结束的上电区间之和,调度器按前后差值统计构建器能耗
+ * @retval 能耗(nJ)
+ */
+uint64_t sensor_energy_total(void)
+{
+    return _energy_total;
+}
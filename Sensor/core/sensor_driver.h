@@ -25,16 +25,22 @@ extern "C" {
 #include <stdbool.h>
 
 #include "rt_list.h"
+#include "sensor_log.h"
+#include "sensor_time.h"
 #include "node_convert.h"
 #include "NodeSDKConfig.h"
 /* Exported constants --------------------------------------------------------*/
 #define SENSOR_MODULE_MAX       (3)         //传感器模块的最大成员数
 #define SENSOR_ERROR_DATA       0XFFFFFFFF  //错误数据
 #define SENSOR_OUTRANGE_DATA    0XFFFFFFFD  //超量程数据
+#define SENSOR_STATS_HIST_NUM   (12)        //耗时直方图桶数,桶k统计[2^(k-1), 2^k)ms,末桶含更大值
+#ifndef SENSOR_SUPPLY_MV
+#define SENSOR_SUPPLY_MV        (3300)      //传感器供电电压(mV),能耗统计使用
+#endif
 /* Exported macro ------------------------------------------------------------*/
 #define  SENSOR_DEBUG_ENABLE    0           //传感器调试使能
 #if (SENSOR_DEBUG_ENABLE == 1)
-#define  sensor_printf(...)      printf(__VA_ARGS__)
+#define  sensor_printf(...)      SENSOR_LOG_D(__VA_ARGS__)
 #else
 
 #define  sensor_printf(...)
@@ -100,9 +106,50 @@ typedef enum
     SENSOR_CMD_GET_OTHER,   //获取其他数据
     SENSOR_CMD_SET_OTHER,   //设置其他数据
     SENSOR_CMD_SET_ISR_BACK,//设置中断回调
+    SENSOR_CMD_TIME_SET,    //采集时间戳设置
+    SENSOR_CMD_TIME_GET,    //采集时间戳获取
 }sensor_cmd_e;
+/**
+ * @brief  传感器统计事件
+ * @note   由框架或驱动上报
+ */
+typedef enum
+{
+    SENSOR_STATS_RETRY,     //重采
+    SENSOR_STATS_CRC,       //CRC校验错误
+    SENSOR_STATS_TIMEOUT,   //超时
+}sensor_stats_e;
 /* Exported types ------------------------------------------------------------*/
 typedef struct sensor_device *sensor_device_t;
+/**
+ * @brief  传感器能耗统计
+ * @note   上电区间为打开至关闭(或进入低功耗),能耗=供电电压*工作电流*上电时间
+ */
+typedef struct
+{
+    uint32_t current;       //上电工作电流(uA),驱动填写
+    bool     powered;       //处于上电区间
+    uint32_t on_ts;         //上电时刻(ms)
+    uint32_t on_time;       //累计上电时间(ms)
+    uint64_t energy;        //累计能耗(nJ)
+}sensor_energy_t;
+/**
+ * @brief  传感器统计
+ * @note   由框架更新,直方图计数饱和不回绕
+ */
+typedef struct
+{
+    uint16_t open_hist[SENSOR_STATS_HIST_NUM];      //打开耗时直方图
+    uint16_t collect_hist[SENSOR_STATS_HIST_NUM];   //采集耗时直方图
+    uint16_t close_hist[SENSOR_STATS_HIST_NUM];     //关闭耗时直方图
+    uint32_t success;       //采集成功次数
+    uint32_t fail;          //采集失败次数
+    uint32_t retry;         //重采次数
+    uint32_t crc_err;       //CRC校验错误次数
+    uint32_t timeout;       //超时次数
+    uint16_t fail_streak;   //当前连续失败次数
+    uint32_t last_good;     //最近一次采集成功时间(ms)
+}sensor_stats_t;
 /**
  * @brief  传感器模块
  * @note   不同传感器在同一模块中使用,需要填写此内容
@@ -116,6 +163,8 @@ typedef struct
     bool    (*init)(sensor_device_t dev);
     bool    (*open)(sensor_device_t dev);
     bool    (*close)(sensor_device_t dev);
+
+    sensor_energy_t energy;                 //模块公共部分能耗
 }sensor_module_t;
 /**
  * @brief  传感器接口
@@ -144,6 +193,8 @@ struct sensor_device
     const sensor_ops_t  *ops;
     sensor_module_t     *module;    //模块,不同传感器在同一模块中使用,需要填写此内容
     void                *arg;       //传感器参数
+    sensor_stats_t      stats;      //传感器统计
+    sensor_energy_t     energy;     //传感器能耗
 };
 /* Exported variables --------------------------------------------------------*/
 
@@ -158,6 +209,15 @@ bool sensor_collect(sensor_device_t dev);
 bool sensor_lpm(sensor_device_t dev, bool lpm_flag);
 bool sensor_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, void *arg);
 
+const sensor_stats_t *sensor_stats_get(sensor_device_t dev);
+void sensor_stats_event(sensor_device_t dev, sensor_stats_e event);
+void sensor_stats_reset(sensor_device_t dev);
+void sensor_stats_dump(sensor_device_t dev);
+
+float sensor_energy_get(sensor_device_t dev);
+float sensor_module_energy_get(sensor_module_t *module);
+uint64_t sensor_energy_total(void);
+
 #ifdef __cplusplus
 extern "C" }
 #endif
@@ -0,0 +1,382 @@
+/**
+ * @file sensor_frame.c
+ * @brief 传感器上行数据帧编解码
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 不依赖HAL与传感器框架,主机端可直接编译解码
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_frame.h"
+/* Private includes ----------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define FRAME_FLAG_KEY          0x80    //关键帧
+#define FRAME_FLAG_OUTRANGE     0x40    //含超量程位图
+#define FRAME_VARINT_MAX        5       //32位变长整数最大字节数
+/* Private macro -------------------------------------------------------------*/
+#define BITMAP_SIZE(num)        (((num) + 7) / 8)
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  定宽整数范围限制
+ * @param  value: 数据
+ * @param  width: 字节宽度
+ * @param  *clip: 超出范围标志
+ * @retval 限制后数据
+ */
+static int32_t width_clip(int64_t value, uint8_t width, bool *clip)
+{
+    int64_t max = (width >= 4) ? INT32_MAX : ((int64_t)1 << (width * 8 - 1)) - 1;
+    int64_t min = -max - 1;
+    *clip = false;
+    if(value > max) {
+        *clip = true;
+        return (int32_t)max;
+    }
+    if(value < min) {
+        *clip = true;
+        return (int32_t)min;
+    }
+    return (int32_t)value;
+}
+/**
+ * @brief  写入zig-zag变长整数
+ * @param  *buf: 缓冲区
+ * @param  value: 数据
+ * @retval 写入字节数
+ */
+static uint8_t varint_put(uint8_t *buf, int32_t value)
+{
+    uint32_t u = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    uint8_t n = 0;
+    while(u >= 0x80) {
+        buf[n++] = (uint8_t)(u | 0x80);
+        u >>= 7;
+    }
+    buf[n++] = (uint8_t)u;
+    return n;
+}
+/**
+ * @brief  读取zig-zag变长整数
+ * @param  *buf: 缓冲区
+ * @param  len: 剩余长度
+ * @param  *value: 数据
+ * @retval 读取字节数,0表示格式错误
+ */
+static uint8_t varint_get(const uint8_t *buf, uint16_t len, int32_t *value)
+{
+    uint32_t u = 0;
+    for(uint8_t n = 0; n < FRAME_VARINT_MAX && n < len; n++) {
+        u |= (uint32_t)(buf[n] & 0x7F) << (7 * n);
+        if((buf[n] & 0x80) == 0) {
+            *value = (int32_t)((u >> 1) ^ (~(u & 1) + 1));
+            return n + 1;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief  查找最近帧
+ * @param  *frame: 编解码状态
+ * @param  seq: 帧序号
+ * @retval 帧快照,未找到返回NULL
+ */
+static sensor_frame_snap_t *hist_find(sensor_frame_t *frame, uint8_t seq)
+{
+    for(uint8_t i = 0; i < SENSOR_FRAME_HIST_NUM; i++) {
+        if(frame->hist[i].valid == true && frame->hist[i].seq == seq) {
+            return &frame->hist[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief  保存最近帧
+ * @note   覆盖最旧一帧
+ * @param  *frame: 编解码状态
+ * @param  *snap: 帧快照
+ */
+static void hist_push(sensor_frame_t *frame, const sensor_frame_snap_t *snap)
+{
+    frame->hist[frame->hist_pos] = *snap;
+    frame->hist[frame->hist_pos].valid = true;
+    frame->hist_pos = (frame->hist_pos + 1) % SENSOR_FRAME_HIST_NUM;
+}
+/**
+ * @brief  帧初始化
+ * @param  *frame: 编解码状态
+ * @param  *schema: 帧模式
+ * @retval true: 成功 false: 模式无效
+ */
+bool sensor_frame_init(sensor_frame_t *frame, const sensor_frame_schema_t *schema)
+{
+    if(frame == NULL || schema == NULL || schema->field == NULL
+    || schema->num == 0 || schema->num > SENSOR_FRAME_CH_MAX) {
+        return false;
+    }
+    for(uint8_t i = 0; i < schema->num; i++) {
+        uint8_t width = schema->field[i].width;
+        if((width != 1 && width != 2 && width != 4) || schema->field[i].unit <= 0) {
+            return false;
+        }
+    }
+    memset(frame, 0, sizeof(sensor_frame_t));
+    frame->schema = schema;
+    return true;
+}
+/**
+ * @brief  清除参考帧
+ * @note   下一帧发送关键帧;入网或长时间未确认时调用
+ * @param  *frame: 编解码状态
+ */
+void sensor_frame_reset(sensor_frame_t *frame)
+{
+    if(frame == NULL) {
+        return;
+    }
+    frame->ack.valid = false;
+    for(uint8_t i = 0; i < SENSOR_FRAME_HIST_NUM; i++) {
+        frame->hist[i].valid = false;
+    }
+    frame->unacked = 0;
+}
+/**
+ * @brief  帧编码
+ * @note   无参考帧、达到关键帧间隔或连续SENSOR_FRAME_UNACK_MAX帧未确认时编码关键帧;
+ *         编码结果保存为最近帧,收到确认后调用sensor_frame_ack更新参考帧
+ * @param  *frame: 编解码状态
+ * @param  *value: 各通道数据
+ * @param  *status: 各通道状态 data_status_e
+ * @param  *buf: 输出缓冲区
+ * @param  size: 缓冲区大小
+ * @retval 帧长度,0表示缓冲区不足
+ */
+uint16_t sensor_frame_encode(sensor_frame_t *frame, const float *value, const uint8_t *status,
+                             uint8_t *buf, uint16_t size)
+{
+    if(frame == NULL || frame->schema == NULL || value == NULL || status == NULL || buf == NULL) {
+        return 0;
+    }
+
+    const sensor_frame_schema_t *schema = frame->schema;
+    uint8_t num = schema->num;
+    //确认丢失时主机参考已更新而设备未更新,差分帧无法解码,须以关键帧重新同步
+    bool key = (frame->ack.valid == false)
+            || (frame->unacked >= SENSOR_FRAME_UNACK_MAX)
+            || (schema->key_interval != 0 && frame->since_key >= schema->key_interval);
+
+    //转换为整数,超出定宽范围按超量程处理
+    bool outrange = false;
+    sensor_frame_snap_t snap = {0};
+    snap.seq = frame->seq & SENSOR_FRAME_SEQ_MASK;
+    for(uint8_t i = 0; i < num; i++) {
+        uint8_t st = status[i];
+        int32_t v = 0;
+        if(st == SENSOR_FRAME_ST_VALID) {
+            bool clip = false;
+            v = width_clip(llroundf(value[i] * schema->field[i].unit), schema->field[i].width, &clip);
+            if(clip == true) {
+                st = SENSOR_FRAME_ST_OUTRANGE;
+            }
+        } else if(st != SENSOR_FRAME_ST_OUTRANGE) {
+            st = SENSOR_FRAME_ST_INVALID;
+        }
+        if(st == SENSOR_FRAME_ST_OUTRANGE) {
+            outrange = true;
+        }
+        snap.status[i] = st;
+        snap.value[i] = (st == SENSOR_FRAME_ST_VALID) ? v : 0;
+    }
+
+    uint16_t bitmap = BITMAP_SIZE(num);
+    uint16_t len = 2 + (key ? 0 : 1) + bitmap + (outrange ? bitmap : 0);
+    if(len > size) {
+        return 0;
+    }
+    memset(buf, 0, len);
+    buf[0] = schema->id;
+    buf[1] = snap.seq | (key ? FRAME_FLAG_KEY : 0) | (outrange ? FRAME_FLAG_OUTRANGE : 0);
+    uint16_t pos = 2;
+    if(key == false) {
+        buf[pos++] = frame->ack.seq;
+    }
+    uint8_t *valid_map = &buf[pos];
+    uint8_t *outrange_map = &buf[pos + bitmap];
+    pos += bitmap + (outrange ? bitmap : 0);
+
+    for(uint8_t i = 0; i < num; i++) {
+        if(snap.status[i] == SENSOR_FRAME_ST_OUTRANGE) {
+            outrange_map[i / 8] |= 1 << (i % 8);
+        }
+        if(snap.status[i] != SENSOR_FRAME_ST_VALID) {
+            continue;
+        }
+        valid_map[i / 8] |= 1 << (i % 8);
+        int32_t v = snap.value[i];
+        if(key == true) {
+            uint8_t width = schema->field[i].width;
+            if(pos + width > size) {
+                return 0;
+            }
+            for(uint8_t b = 0; b < width; b++) {
+                buf[pos++] = (uint8_t)((uint32_t)v >> (8 * (width - 1 - b)));
+            }
+        } else {
+            if(pos + FRAME_VARINT_MAX > size) {
+                return 0;
+            }
+            //参考帧该通道无效时以0为参考
+            int32_t ref = (frame->ack.status[i] == SENSOR_FRAME_ST_VALID) ? frame->ack.value[i] : 0;
+            pos += varint_put(&buf[pos], (int32_t)((uint32_t)v - (uint32_t)ref));
+        }
+    }
+
+    hist_push(frame, &snap);
+    frame->seq = (frame->seq + 1) & SENSOR_FRAME_SEQ_MASK;
+    frame->since_key = key ? 1 : frame->since_key + 1;
+    if(frame->unacked < UINT8_MAX) {
+        frame->unacked++;
+    }
+    return pos;
+}
+/**
+ * @brief  帧解码
+ * @note   主机端调用;差分帧按参考序号在最近解码的帧中查找参考,未找到时失败,需等待关键帧;
+ *         解码结果保存为最近帧,发送确认时调用sensor_frame_ack
+ * @param  *frame: 编解码状态
+ * @param  *buf: 帧数据
+ * @param  len: 帧长度
+ * @param  *value: 各通道数据
+ * @param  *status: 各通道状态 data_status_e
+ * @param  *seq: 帧序号,可为空
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_frame_decode(sensor_frame_t *frame, const uint8_t *buf, uint16_t len,
+                         float *value, uint8_t *status, uint8_t *seq)
+{
+    if(frame == NULL || frame->schema == NULL || buf == NULL || value == NULL || status == NULL || len < 2) {
+        return false;
+    }
+
+    const sensor_frame_schema_t *schema = frame->schema;
+    uint8_t num = schema->num;
+    if(buf[0] != schema->id) {
+        return false;
+    }
+    bool key = (buf[1] & FRAME_FLAG_KEY) != 0;
+    bool outrange = (buf[1] & FRAME_FLAG_OUTRANGE) != 0;
+    uint16_t bitmap = BITMAP_SIZE(num);
+    uint16_t pos = 2;
+    const sensor_frame_snap_t *ref = NULL;
+    if(key == false) {
+        if(len < 3) {
+            return false;
+        }
+        //确认丢失时设备端参考早于主机端最近确认的帧,在最近帧中查找
+        ref = hist_find(frame, buf[2]);
+        if(ref == NULL && frame->ack.valid == true && frame->ack.seq == buf[2]) {
+            ref = &frame->ack;
+        }
+        if(ref == NULL) {
+            return false;
+        }
+        pos++;
+    }
+    if(pos + bitmap + (outrange ? bitmap : 0) > len) {
+        return false;
+    }
+    const uint8_t *valid_map = &buf[pos];
+    const uint8_t *outrange_map = &buf[pos + bitmap];
+    pos += bitmap + (outrange ? bitmap : 0);
+
+    sensor_frame_snap_t snap = {0};
+    int32_t *v = snap.value;
+    uint8_t *st = snap.status;
+    for(uint8_t i = 0; i < num; i++) {
+        v[i] = 0;
+        if((valid_map[i / 8] & (1 << (i % 8))) == 0) {
+            bool out = outrange && (outrange_map[i / 8] & (1 << (i % 8)));
+            st[i] = out ? SENSOR_FRAME_ST_OUTRANGE : SENSOR_FRAME_ST_INVALID;
+            continue;
+        }
+        st[i] = SENSOR_FRAME_ST_VALID;
+        if(key == true) {
+            uint8_t width = schema->field[i].width;
+            if(pos + width > len) {
+                return false;
+            }
+            uint32_t u = 0;
+            for(uint8_t b = 0; b < width; b++) {
+                u = (u << 8) | buf[pos++];
+            }
+            //符号扩展
+            if(width < 4 && (u & (1UL << (width * 8 - 1)))) {
+                u |= ~((1UL << (width * 8)) - 1);
+            }
+            v[i] = (int32_t)u;
+        } else {
+            int32_t delta = 0;
+            uint8_t n = varint_get(&buf[pos], len - pos, &delta);
+            if(n == 0) {
+                return false;
+            }
+            pos += n;
+            int32_t base = (ref->status[i] == SENSOR_FRAME_ST_VALID) ? ref->value[i] : 0;
+            v[i] = (int32_t)((uint32_t)base + (uint32_t)delta);
+        }
+    }
+
+    for(uint8_t i = 0; i < num; i++) {
+        status[i] = st[i];
+        value[i] = (st[i] == SENSOR_FRAME_ST_VALID) ? (float)v[i] / schema->field[i].unit : 0;
+    }
+    snap.seq = buf[1] & SENSOR_FRAME_SEQ_MASK;
+    hist_push(frame, &snap);
+    if(seq != NULL) {
+        *seq = snap.seq;
+    }
+    return true;
+}
+/**
+ * @brief  帧确认
+ * @note   设备端收到确认、主机端发送确认时调用,最近帧中序号匹配的帧成为新的差分参考;
+ *         确认迟到时仍可匹配,参考帧之后已发送的帧计入未确认数量;
+ *         不晚于当前参考帧的确认(重复或乱序到达)忽略
+ * @param  *frame: 编解码状态
+ * @param  seq: 确认的帧序号
+ * @retval true: 成功 false: 未找到该帧或确认已过时
+ */
+bool sensor_frame_ack(sensor_frame_t *frame, uint8_t seq)
+{
+    if(frame == NULL) {
+        return false;
+    }
+    seq &= SENSOR_FRAME_SEQ_MASK;
+    if(frame->ack.valid == true) {
+        uint8_t ahead = (seq - frame->ack.seq) & SENSOR_FRAME_SEQ_MASK;
+        if(ahead == 0 || ahead > SENSOR_FRAME_SEQ_MASK / 2) {
+            return false;
+        }
+    }
+    sensor_frame_snap_t *snap = hist_find(frame, seq);
+    if(snap == NULL) {
+        return false;
+    }
+    frame->ack = *snap;
+    frame->unacked = (frame->seq - seq - 1) & SENSOR_FRAME_SEQ_MASK;
+    return true;
+}
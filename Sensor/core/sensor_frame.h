@@ -0,0 +1,116 @@
+/**
+ * @file sensor_frame.h
+ * @brief 传感器上行数据帧编解码
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 一个采集周期的各通道数据打包为紧凑二进制帧,设备端编码,主机端解码,两端共用本文件;
+ * 帧格式:
+ * [0]      模式ID
+ * [1]      bit7:关键帧 bit6:含超量程位图 bit0~5:帧序号
+ * [2]      参考帧序号(仅差分帧)
+ * [..]     有效位图,每通道1位
+ * [..]     超量程位图,每通道1位(仅bit6置位)
+ * [..]     有效通道数据:关键帧为定宽有符号整数(大端),差分帧为相对参考帧的zig-zag变长整数
+ * 数据按通道unit转换为整数,如unit=10表示分辨率0.1;
+ * 差分参考为设备端最近一次收到确认的帧,序号写入差分帧;
+ * 设备端保存最近SENSOR_FRAME_HIST_NUM帧,确认迟到(已发送后续帧)时仍可匹配,早于当前参考的确认忽略;
+ * 主机端保存最近解码的SENSOR_FRAME_HIST_NUM帧,按差分帧携带的参考序号查找,确认丢失时仍可解码;
+ * 设备端连续SENSOR_FRAME_UNACK_MAX帧未确认后强制发送关键帧重新同步
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_FRAME_H__
+#define __SENSOR_FRAME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+/* Exported constants --------------------------------------------------------*/
+#define SENSOR_FRAME_CH_MAX         16      //单帧最大通道数量
+#define SENSOR_FRAME_SEQ_MASK       0x3F    //帧序号掩码
+#ifndef SENSOR_FRAME_UNACK_MAX
+#define SENSOR_FRAME_UNACK_MAX      3       //连续未确认帧数上限,达到后强制关键帧
+#endif
+#ifndef SENSOR_FRAME_HIST_NUM
+#define SENSOR_FRAME_HIST_NUM       (SENSOR_FRAME_UNACK_MAX + 1)    //保存的最近帧数量
+#endif
+#if (SENSOR_FRAME_HIST_NUM <= SENSOR_FRAME_UNACK_MAX)
+#error "SENSOR_FRAME_HIST_NUM must be greater than SENSOR_FRAME_UNACK_MAX"
+#endif
+//通道状态,与data_status_e取值一致
+#define SENSOR_FRAME_ST_INVALID     0       //数据无效
+#define SENSOR_FRAME_ST_VALID       1       //数据有效
+#define SENSOR_FRAME_ST_OUTRANGE    2       //数据超量程
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  通道描述
+ * @note   None
+ */
+typedef struct
+{
+    float   unit;       //数据单位,数据*unit取整传输
+    uint8_t width;      //关键帧字节宽度 1/2/4
+}sensor_frame_field_t;
+/**
+ * @brief  帧模式
+ * @note   通道顺序与数量变化时须更换模式ID
+ */
+typedef struct
+{
+    uint8_t                     id;             //模式ID
+    uint8_t                     num;            //通道数量
+    uint8_t                     key_interval;   //关键帧间隔,0表示仅在无参考或连续未确认时发送关键帧
+    const sensor_frame_field_t  *field;         //通道描述
+}sensor_frame_schema_t;
+/**
+ * @brief  帧快照
+ * @note   通道整数值与状态,用作差分参考
+ */
+typedef struct
+{
+    bool    valid;                              //已保存
+    uint8_t seq;                                //帧序号
+    uint8_t status[SENSOR_FRAME_CH_MAX];        //通道状态
+    int32_t value[SENSOR_FRAME_CH_MAX];         //通道数据
+}sensor_frame_snap_t;
+/**
+ * @brief  编解码状态
+ * @note   设备端与主机端各一份
+ */
+typedef struct
+{
+    const sensor_frame_schema_t *schema;
+    uint8_t seq;                                //下一帧序号
+    uint8_t since_key;                          //距上一关键帧帧数
+    uint8_t unacked;                            //参考帧之后已发送帧数
+    sensor_frame_snap_t ack;                    //确认的参考帧
+    sensor_frame_snap_t hist[SENSOR_FRAME_HIST_NUM];    //最近发送(设备端)或解码(主机端)的帧
+    uint8_t hist_pos;                           //下一写入位置
+}sensor_frame_t;
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+bool sensor_frame_init(sensor_frame_t *frame, const sensor_frame_schema_t *schema);
+uint16_t sensor_frame_encode(sensor_frame_t *frame, const float *value, const uint8_t *status,
+                             uint8_t *buf, uint16_t size);
+bool sensor_frame_decode(sensor_frame_t *frame, const uint8_t *buf, uint16_t len,
+                         float *value, uint8_t *status, uint8_t *seq);
+bool sensor_frame_ack(sensor_frame_t *frame, uint8_t seq);
+void sensor_frame_reset(sensor_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_FRAME_H__ */
@@ -15,8 +15,6 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_group.h"
 /* Private includes ----------------------------------------------------------*/
-#include "module_debug.h"
-
 #include "board_system.h"
 #include "board_params.h"
 /* Private typedef -----------------------------------------------------------*/
@@ -32,11 +30,15 @@ static rt_list_t _sensor_list = RT_LIST_OBJECT_INIT(_sensor_list);
 static bool group_sensor_add(sensor_builder_t *builder, sensor_device_t sensor);
 static bool group_sensor_init(sensor_builder_t *builder);
 static bool group_config_add(sensor_builder_t *builder, void *cfg, uint8_t len, bool group_flag);
+static void group_invalidate(sensor_builder_t *builder);
+static bool group_lpm(sensor_builder_t *builder, bool lpm_flag);
 sensor_builder_ops_t group_builder_ops = 
 {
     .sensor_add = group_sensor_add,
     .sensor_init = group_sensor_init,
     .config_add = group_config_add,
+    .invalidate = group_invalidate,
+    .lpm = group_lpm,
 };
 /* Private function prototypes -----------------------------------------------*/
 /**
@@ -105,6 +107,44 @@ static bool group_sensor_init(sensor_builder_t *builder)
     }
     return ret;
 }
+/**
+ * @brief  所有成员传感器通道标记为无效
+ * @note   组内各阶段遍历全部成员,超出预算时成员数据均可能未处理完成;
+ *         各成员按其构建器配置数量标记
+ * @param  *builder: 构建器
+ */
+static void group_invalidate(sensor_builder_t *builder)
+{
+    (void)builder;
+    data_status_e status = DATA_STATUS_INVALID;
+    sensor_device_t sensor;
+    rt_list_for_each_entry(sensor, &_sensor_list, cfg_node) {
+        sensor_builder_t *owner = (sensor_builder_t *)sensor->arg;
+        for(uint8_t i = 0; i < owner->cfg_num; i++) {
+            sensor_control(sensor, SENSOR_CMD_STATUS_SET, &status, &i);
+        }
+    }
+}
+/**
+ * @brief  所有成员传感器进入/退出低功耗
+ * @note   builder->sensor仅为最后添加的成员,须遍历全部成员;
+ *         任一成员失败返回失败,调度器下次空闲时重新处理
+ * @param  *builder: 构建器
+ * @param  lpm_flag: true:进入低功耗 false:退出低功耗
+ * @retval true: 成功 false: 失败
+ */
+static bool group_lpm(sensor_builder_t *builder, bool lpm_flag)
+{
+    (void)builder;
+    bool ret = true;
+    sensor_device_t sensor;
+    rt_list_for_each_entry(sensor, &_sensor_list, cfg_node) {
+        if(sensor_lpm(sensor, lpm_flag) == false) {
+            ret = false;
+        }
+    }
+    return ret;
+}
 /**
  * @brief  默认传感器数据采集处理
  * @note   支持多个传感器数据采集
@@ -145,9 +185,11 @@ void group_collect(sensor_device_t input, void *cfg, uint8_t num)
         }
 
         while (ret != true) {
-            if(sensor_cfg->collect.err_cnt < sensor_cfg->allow_retry_collect_cnt) {
+            if(sensor_cfg->collect.err_cnt < sensor_cfg->allow_retry_collect_cnt
+            && sensor_deadline_expired() == false) {
                 sensor_cfg->collect.err_cnt++;
-                printf_info("[%s][retry]collect%d/%d\r\n", sensor->name, sensor_cfg->collect.err_cnt, sensor_cfg->allow_retry_collect_cnt);
+                sensor_stats_event(sensor, SENSOR_STATS_RETRY);
+                SENSOR_LOG_I("[%s][retry]collect%d/%d\r\n", sensor->name, sensor_cfg->collect.err_cnt, sensor_cfg->allow_retry_collect_cnt);
                 if(allow_flag == true) {
                     sensor_cfg->collect.count++;
                 }
@@ -158,13 +200,20 @@ void group_collect(sensor_device_t input, void *cfg, uint8_t num)
                     ret = sensor_collect(sensor);
                 }
                 sensor_close(sensor);
+            } else if(sensor_cfg->collect.err_cnt < sensor_cfg->allow_retry_collect_cnt) {
+                //截止时间到达中止重采,记为超时,不计入采集失败;builder->sensor由构建器阶段结束后统计
+                if(sensor != builder->sensor) {
+                    sensor_stats_event(sensor, SENSOR_STATS_TIMEOUT);
+                }
+                SENSOR_LOG_I("[%s][timeout]collect%d/%d\r\n", sensor->name, sensor_cfg->collect.err_cnt, sensor_cfg->allow_retry_collect_cnt);
+                break;
             } else {
                 if (sensor_cfg->collect.normal == false) {
                     if(sensor_cfg->ops.fault_handler != NULL) {
                         sensor_cfg->ops.fault_handler(sensor_cfg);
                     } else {
                         //默认处理
-                        printf_info("[%s][error]fault\r\n", sensor->name);
+                        SENSOR_LOG_I("[%s][error]fault\r\n", sensor->name);
 
                     }
                 } else {
@@ -173,7 +222,7 @@ void group_collect(sensor_device_t input, void *cfg, uint8_t num)
                     } else {
                         //默认处理
                         sensor_cfg->collect.fail_count++;
-                        printf_info("[%s][fail]collect%d/%d\r\n", sensor->name, sensor_cfg->collect.fail_count, sensor_cfg->allow_collect_fail_cnt);
+                        SENSOR_LOG_I("[%s][fail]collect%d/%d\r\n", sensor->name, sensor_cfg->collect.fail_count, sensor_cfg->allow_collect_fail_cnt);
                         if(sensor_cfg->collect.fail_count > sensor_cfg->allow_collect_fail_cnt) {
                             device_restart();
                         }
@@ -183,6 +232,7 @@ void group_collect(sensor_device_t input, void *cfg, uint8_t num)
             }
         }
         float data = 0;
+        uint32_t ts = 0;
         data_status_e status = DATA_STATUS_VALID;
         uint8_t data_id = 0;
         for(uint8_t i = 0; i < num; i++) {
@@ -194,6 +244,9 @@ void group_collect(sensor_device_t input, void *cfg, uint8_t num)
                 sensor_control(sensor, SENSOR_CMD_STATUS_SET, &status, &i);
                 sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &data_id);
                 sensor_control(sensor, SENSOR_CMD_DATA_SET, &data, &i);
+                //数据值沿用原始数据采集时间戳
+                sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &data_id);
+                sensor_control(sensor, SENSOR_CMD_TIME_SET, &ts, &i);
             } else {
                 status = DATA_STATUS_INVALID;
                 sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &i);
@@ -226,7 +279,7 @@ void group_calibration(sensor_device_t input, void *cfg, uint8_t num)
                 return;
             }
             if(sensor_cfg[i].cal_addr == 0) {
-                printf_error("[%s]num[%d]calibration addr is invalid\r\n", sensor->name, i);
+                SENSOR_LOG_E("[%s]num[%d]calibration addr is invalid\r\n", sensor->name, i);
                 return;
             }
 
@@ -235,7 +288,7 @@ void group_calibration(sensor_device_t input, void *cfg, uint8_t num)
                 uint8_t data_id = SENSOR_DATA_GET_RAW - i;
                 sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &data_id);
                 int16_t temp = (int16_t)(data * sensor_cfg[i].unit);
-                printf_debug("[%s]num[%d][original]%d[cal]%d\r\n", sensor->name, i, temp, sensor_params.calibration_value);
+                SENSOR_LOG_D("[%s]num[%d][original]%d[cal]%d\r\n", sensor->name, i, temp, sensor_params.calibration_value);
                 data = (float)(temp + sensor_params.calibration_value) / sensor_cfg[i].unit;
                 sensor_control(sensor, SENSOR_CMD_DATA_SET, &data, &i);
             }
@@ -260,7 +313,7 @@ void group_range_check(sensor_device_t input, void *cfg, uint8_t num)
 
         float data = 0;
         uint8_t id = 0;
-        printf_debug("[%s]range[%d ~ %d]\r\n", sensor->name, sensor_cfg[id].check.min, sensor_cfg[id].check.max);
+        SENSOR_LOG_D("[%s]range[%d ~ %d]\r\n", sensor->name, sensor_cfg[id].check.min, sensor_cfg[id].check.max);
 
         sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &id);
         int16_t temp = data * sensor_cfg[id].unit;
@@ -296,7 +349,7 @@ void group_data_check(sensor_device_t input, void *cfg, uint8_t num)
         }
 
         sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &id);
-        printf_debug("[%s]data[%s]\r\n", sensor->name, ftoc(data, 3));
+        SENSOR_LOG_D("[%s]data[%.3f]\r\n", sensor->name, data);
     }
 }
 /**
@@ -319,7 +372,7 @@ void group_alarm(sensor_device_t input, void *cfg, uint8_t num)
         sensor_group_cfg_t sensor_cfg = (sensor_group_cfg_t )builder->cfg;
         sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &id);
         if(sensor_cfg[id].ops.alarm_handler == NULL || status != DATA_STATUS_VALID) {
-            return;
+            continue;
         }
 
         float data = 0;
@@ -327,3 +380,72 @@ void group_alarm(sensor_device_t input, void *cfg, uint8_t num)
         sensor_cfg[id].ops.alarm_handler(sensor_cfg, &data);
     }
 }
+/**
+ * @brief  默认传感器报警判定处理
+ * @note   按通道报警规则增量判定,仅在报警状态变化时调用报警事件处理函数
+ *         无报警规则的传感器跳过;变化率按采集时间戳计算
+ * @param  sensor: 传感器设备
+ * @param  *cfg: 构建器配置
+ * @retval None
+ */
+void group_alarm_check(sensor_device_t input, void *cfg, uint8_t num)
+{
+    if(cfg == NULL) {
+        return;
+    }
+    uint8_t id = 0;
+    sensor_device_t sensor;
+    rt_list_for_each_entry(sensor, &_sensor_list, cfg_node) {
+        sensor_builder_t *builder = (sensor_builder_t *)sensor->arg;
+        sensor_group_cfg_t sensor_cfg = (sensor_group_cfg_t )builder->cfg;
+        if(sensor_cfg[id].alarm.rule == NULL) {
+            continue;
+        }
+
+        float data = 0;
+        uint32_t ts = 0;
+        data_status_e status = DATA_STATUS_NONE;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &id);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &id);
+        sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &id);
+
+        sensor_alarm_event_t event = {
+            .sensor = sensor,
+            .id     = id,
+            .value  = data,
+            .ts     = ts,
+        };
+        if(sensor_alarm_update(&sensor_cfg[id].alarm, data, status, ts, &event.prev) == false) {
+            continue;
+        }
+        event.state = sensor_cfg[id].alarm.state.state;
+        SENSOR_LOG_I("[%s]alarm[0x%02x -> 0x%02x]\r\n", sensor->name, event.prev, event.state);
+        if(sensor_cfg[id].ops.alarm_event_handler != NULL) {
+            sensor_cfg[id].ops.alarm_event_handler(sensor_cfg, &event);
+        }
+    }
+}
+/**
+ * @brief  默认传感器数据发布处理
+ * @note   置于流程末尾,发布各传感器最终数据、状态与采集时间戳至数据总线
+ * @param  sensor: 传感器设备
+ * @param  *cfg: 构建器配置
+ * @retval None
+ */
+void group_publish(sensor_device_t input, void *cfg, uint8_t num)
+{
+    if(cfg == NULL) {
+        return;
+    }
+    uint8_t id = 0;
+    sensor_device_t sensor;
+    rt_list_for_each_entry(sensor, &_sensor_list, cfg_node) {
+        float data = 0;
+        uint32_t ts = 0;
+        data_status_e status = DATA_STATUS_NONE;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &id);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, &data, &id);
+        sensor_control(sensor, SENSOR_CMD_TIME_GET, &ts, &id);
+        sensor_bus_publish(sensor, id, data, status, ts);
+    }
+}
@@ -0,0 +1,244 @@
+/**
+ * @file sensor_log.c
+ * @brief 传感器延迟日志
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 多生产者单消费者无锁环形缓冲区,每个记录槽带序号(保存为序号减槽位编号,零初始化即可使用);
+ * 生产者CAS抢占写入位置,写完后发布序号;消费者按序号判断记录是否可读;
+ * 缓冲区满时丢弃新记录并计数
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_log.h"
+/* Private includes ----------------------------------------------------------*/
+#include <stdio.h>
+#include "node_convert.h"
+#include "NodeSDKConfig.h"
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    volatile uint32_t   seq;        //记录槽序号 - 槽位编号
+    sensor_log_entry_t  entry;      //日志记录
+}log_cell_t;
+/* Private define ------------------------------------------------------------*/
+#define LOG_MASK            (SENSOR_LOG_BUF_NUM - 1)
+#define LOG_LINE_SIZE       128     //单行格式化缓冲区大小
+#define LOG_SPEC_SIZE       16      //单个格式说明符最大长度
+/* Private macro -------------------------------------------------------------*/
+#if (SENSOR_LOG_BUF_NUM & LOG_MASK) != 0
+#error "SENSOR_LOG_BUF_NUM must be a power of 2"
+#endif
+/* Private variables ---------------------------------------------------------*/
+static log_cell_t _log_buf[SENSOR_LOG_BUF_NUM];
+static uint32_t _log_head = 0;      //生产者写入位置
+static uint32_t _log_tail = 0;      //消费者读取位置
+static uint32_t _log_drop = 0;      //丢弃记录数
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  写入日志记录
+ * @note   由SENSOR_LOG_x宏调用;可在中断中调用,不阻塞
+ * @param  level: 日志等级
+ * @param  *fmt: 格式字符串
+ * @param  *args: 参数
+ * @param  argc: 参数数量
+ * @retval true: 成功 false: 缓冲区满丢弃
+ */
+bool sensor_log_write(uint8_t level, const char *fmt, const sensor_log_arg_t *args, uint8_t argc)
+{
+    log_cell_t *cell = NULL;
+    uint32_t pos = __atomic_load_n(&_log_head, __ATOMIC_RELAXED);
+    while(1) {
+        cell = &_log_buf[pos & LOG_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) + (pos & LOG_MASK) - pos);
+        if(diff == 0) {
+            if(__atomic_compare_exchange_n(&_log_head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(diff < 0) {
+            __atomic_fetch_add(&_log_drop, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            pos = __atomic_load_n(&_log_head, __ATOMIC_RELAXED);
+        }
+    }
+
+    if(argc > SENSOR_LOG_ARG_MAX) {
+        argc = SENSOR_LOG_ARG_MAX;
+    }
+    cell->entry.fmt = fmt;
+    cell->entry.level = level;
+    cell->entry.argc = argc;
+    for(uint8_t i = 0; i < argc; i++) {
+        cell->entry.args[i] = args[i];
+    }
+    __atomic_store_n(&cell->seq, pos + 1 - (pos & LOG_MASK), __ATOMIC_RELEASE);
+    return true;
+}
+/**
+ * @brief  读取日志记录
+ * @note   单消费者调用;用于二进制上传或主机端解析
+ * @param  *entry: 日志记录
+ * @retval true: 成功 false: 无记录
+ */
+bool sensor_log_read(sensor_log_entry_t *entry)
+{
+    if(entry == NULL) {
+        return false;
+    }
+
+    uint32_t index = _log_tail & LOG_MASK;
+    log_cell_t *cell = &_log_buf[index];
+    if(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) + index != _log_tail + 1) {
+        return false;
+    }
+    *entry = cell->entry;
+    __atomic_store_n(&cell->seq, _log_tail + SENSOR_LOG_BUF_NUM - index, __ATOMIC_RELEASE);
+    _log_tail++;
+    return true;
+}
+/**
+ * @brief  格式化日志记录
+ * @note   逐个格式说明符调用snprintf;%f使用ftoc转换,默认3位小数
+ * @param  *entry: 日志记录
+ * @param  *buf: 输出缓冲区
+ * @param  size: 缓冲区大小
+ * @retval 输出长度
+ */
+uint16_t sensor_log_format(const sensor_log_entry_t *entry, char *buf, uint16_t size)
+{
+    if(entry == NULL || entry->fmt == NULL || buf == NULL || size == 0) {
+        return 0;
+    }
+
+    const char *p = entry->fmt;
+    uint16_t len = 0;
+    uint8_t argi = 0;
+    char spec[LOG_SPEC_SIZE];
+
+    buf[0] = '\0';
+    while(*p != '\0' && len < size - 1) {
+        if(*p != '%') {
+            buf[len++] = *p++;
+            continue;
+        }
+        if(*(p + 1) == '%') {
+            buf[len++] = '%';
+            p += 2;
+            continue;
+        }
+        //解析格式说明符: 标志 宽度 精度 长度
+        uint8_t n = 0;
+        int8_t precision = -1;
+        spec[n++] = *p++;
+        while(*p != '\0' && strchr("-+ #0123456789.hlzjt", *p) != NULL && n < LOG_SPEC_SIZE - 2) {
+            if(*p == '.') {
+                precision = 0;
+            } else if(precision >= 0 && *p >= '0' && *p <= '9') {
+                precision = precision * 10 + (*p - '0');
+            }
+            if(strchr("hlzjt", *p) == NULL) {
+                //参数统一按sensor_log_arg_t保存,忽略长度修饰
+                spec[n++] = *p;
+            }
+            p++;
+        }
+        if(*p == '\0') {
+            break;
+        }
+        char conv = *p++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+
+        sensor_log_arg_t arg = (argi < entry->argc) ? entry->args[argi++] : 0;
+        int ret = 0;
+        switch(conv) {
+            case 'd':
+            case 'i':
+                ret = snprintf(&buf[len], size - len, spec, (int)arg);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'c':
+                ret = snprintf(&buf[len], size - len, spec, (unsigned int)arg);
+                break;
+            case 's':
+                ret = snprintf(&buf[len], size - len, spec, (arg != 0) ? (const char *)arg : "(null)");
+                break;
+            case 'p':
+                ret = snprintf(&buf[len], size - len, spec, (void *)arg);
+                break;
+            case 'f':
+            case 'e':
+            case 'g':
+            {
+                float f = 0;
+                uint32_t u = (uint32_t)arg;
+                memcpy(&f, &u, sizeof(f));
+                ret = snprintf(&buf[len], size - len, "%s", ftoc(f, (precision >= 0) ? precision : 3));
+                break;
+            }
+            default:
+                ret = snprintf(&buf[len], size - len, "%s", spec);
+                break;
+        }
+        if(ret < 0) {
+            break;
+        }
+        len = (len + ret < size - 1) ? len + ret : size - 1;
+    }
+    buf[len] = '\0';
+    return len;
+}
+/**
+ * @brief  格式化输出缓冲区中的日志
+ * @note   由低优先级任务周期调用,不可在中断中调用
+ * @param  max: 最大输出条数,0表示全部
+ * @retval 输出条数
+ */
+uint32_t sensor_log_flush(uint32_t max)
+{
+    static char line[LOG_LINE_SIZE];
+    sensor_log_entry_t entry;
+    uint32_t count = 0;
+
+    while((max == 0 || count < max) && sensor_log_read(&entry) == true) {
+        sensor_log_format(&entry, line, sizeof(line));
+        sensor_log_output(line);
+        count++;
+    }
+
+    uint32_t drop = __atomic_exchange_n(&_log_drop, 0, __ATOMIC_RELAXED);
+    if(drop != 0) {
+        snprintf(line, sizeof(line), "[log]drop %lu\r\n", (unsigned long)drop);
+        sensor_log_output(line);
+    }
+    return count;
+}
+/**
+ * @brief  获取丢弃记录数
+ * @retval 自上次输出后丢弃的记录数
+ */
+uint32_t sensor_log_drop_get(void)
+{
+    return __atomic_load_n(&_log_drop, __ATOMIC_RELAXED);
+}
+/**
+ * @brief  日志输出
+ * @note   默认输出至printf,可重写输出至其他接口
+ * @param  *str: 格式化后的字符串
+ */
+__weak void sensor_log_output(const char *str)
+{
+    printf("%s", str);
+}
@@ -0,0 +1,140 @@
+/**
+ * @file sensor_log.h
+ * @brief 传感器延迟日志
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 调用处仅保存格式字符串地址与原始参数至无锁环形缓冲区,不进行格式化与串口输出;
+ * 由低优先级任务调用sensor_log_flush格式化输出,或通过sensor_log_read读取二进制记录由主机端解析;
+ * 格式字符串地址即格式ID,主机端通过map文件/ELF还原;
+ * 支持 %d %i %u %x %X %o %c %s %f %p,%s参数须为常量或静态字符串,%f参数为float
+ * 可在中断中调用
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_LOG_H__
+#define __SENSOR_LOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* Exported constants --------------------------------------------------------*/
+#define SENSOR_LOG_LVL_NONE     0   //关闭
+#define SENSOR_LOG_LVL_ERROR    1   //错误
+#define SENSOR_LOG_LVL_WARN     2   //警告
+#define SENSOR_LOG_LVL_INFO     3   //信息
+#define SENSOR_LOG_LVL_DEBUG    4   //调试
+
+#ifndef SENSOR_LOG_LEVEL
+#define SENSOR_LOG_LEVEL        SENSOR_LOG_LVL_INFO     //编译期日志等级,低于该等级的调用不编译
+#endif
+#ifndef SENSOR_LOG_BUF_NUM
+#define SENSOR_LOG_BUF_NUM      32                      //缓冲区记录数量,须为2的幂
+#endif
+#define SENSOR_LOG_ARG_MAX      8                       //单条记录最大参数数量
+/* Exported types ------------------------------------------------------------*/
+typedef uintptr_t sensor_log_arg_t;
+/**
+ * @brief  日志记录
+ * @note   二进制格式,主机端按格式字符串解析参数
+ */
+typedef struct
+{
+    const char         *fmt;                        //格式字符串地址
+    uint8_t             level;                      //日志等级
+    uint8_t             argc;                       //参数数量
+    sensor_log_arg_t    args[SENSOR_LOG_ARG_MAX];   //原始参数,float按位保存
+}sensor_log_entry_t;
+/* Exported macro ------------------------------------------------------------*/
+/**
+ * @brief  参数转换
+ * @note   float按位保存,字符串与指针保存地址,整型直接保存;其他类型指针需转换为void *
+ */
+static inline sensor_log_arg_t sensor_log_arg_int(uintptr_t value)
+{
+    return (sensor_log_arg_t)value;
+}
+static inline sensor_log_arg_t sensor_log_arg_float(double value)
+{
+    float f = (float)value;
+    uint32_t u = 0;
+    memcpy(&u, &f, sizeof(u));
+    return (sensor_log_arg_t)u;
+}
+static inline sensor_log_arg_t sensor_log_arg_ptr(const void *value)
+{
+    return (sensor_log_arg_t)value;
+}
+#define SENSOR_LOG_ARG(x) _Generic((x),                 \
+    float:          sensor_log_arg_float,               \
+    double:         sensor_log_arg_float,               \
+    char *:         sensor_log_arg_ptr,                 \
+    const char *:   sensor_log_arg_ptr,                 \
+    void *:         sensor_log_arg_ptr,                 \
+    const void *:   sensor_log_arg_ptr,                 \
+    default:        sensor_log_arg_int)(x)
+
+#define _SENSOR_LOG_NARG(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define SENSOR_LOG_NARG(...)    _SENSOR_LOG_NARG(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _SENSOR_LOG_A0()
+#define _SENSOR_LOG_A1(a)                   , SENSOR_LOG_ARG(a)
+#define _SENSOR_LOG_A2(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A1(__VA_ARGS__)
+#define _SENSOR_LOG_A3(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A2(__VA_ARGS__)
+#define _SENSOR_LOG_A4(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A3(__VA_ARGS__)
+#define _SENSOR_LOG_A5(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A4(__VA_ARGS__)
+#define _SENSOR_LOG_A6(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A5(__VA_ARGS__)
+#define _SENSOR_LOG_A7(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A6(__VA_ARGS__)
+#define _SENSOR_LOG_A8(a, ...)              , SENSOR_LOG_ARG(a) _SENSOR_LOG_A7(__VA_ARGS__)
+#define _SENSOR_LOG_CAT(a, b)               a##b
+#define _SENSOR_LOG_ARGS(n)                 _SENSOR_LOG_CAT(_SENSOR_LOG_A, n)
+
+#define SENSOR_LOG(level, fmt, ...)                                                             \
+    do {                                                                                        \
+        const sensor_log_arg_t _log_args[] = {0 _SENSOR_LOG_ARGS(SENSOR_LOG_NARG(__VA_ARGS__))(__VA_ARGS__)}; \
+        sensor_log_write(level, fmt, &_log_args[1], sizeof(_log_args) / sizeof(_log_args[0]) - 1); \
+    } while(0)
+
+#if (SENSOR_LOG_LEVEL >= SENSOR_LOG_LVL_ERROR)
+#define SENSOR_LOG_E(fmt, ...)  SENSOR_LOG(SENSOR_LOG_LVL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define SENSOR_LOG_E(fmt, ...)
+#endif
+#if (SENSOR_LOG_LEVEL >= SENSOR_LOG_LVL_WARN)
+#define SENSOR_LOG_W(fmt, ...)  SENSOR_LOG(SENSOR_LOG_LVL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define SENSOR_LOG_W(fmt, ...)
+#endif
+#if (SENSOR_LOG_LEVEL >= SENSOR_LOG_LVL_INFO)
+#define SENSOR_LOG_I(fmt, ...)  SENSOR_LOG(SENSOR_LOG_LVL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define SENSOR_LOG_I(fmt, ...)
+#endif
+#if (SENSOR_LOG_LEVEL >= SENSOR_LOG_LVL_DEBUG)
+#define SENSOR_LOG_D(fmt, ...)  SENSOR_LOG(SENSOR_LOG_LVL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define SENSOR_LOG_D(fmt, ...)
+#endif
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+bool sensor_log_write(uint8_t level, const char *fmt, const sensor_log_arg_t *args, uint8_t argc);
+bool sensor_log_read(sensor_log_entry_t *entry);
+uint16_t sensor_log_format(const sensor_log_entry_t *entry, char *buf, uint16_t size);
+uint32_t sensor_log_flush(uint32_t max);
+uint32_t sensor_log_drop_get(void);
+void sensor_log_output(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_LOG_H__ */
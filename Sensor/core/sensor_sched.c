@@ -0,0 +1,205 @@
+/**
+ * @file sensor_sched.c
+ * @brief 传感器能耗预算调度
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 与sensor_director_process在同一任务中调用
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_sched.h"
+/* Private includes ----------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define SCHED_DAY_MS    (24.0f * 3600 * 1000)   //一天毫秒数
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  设置构建器周期
+ * @note   保持上次执行时间不变,下次执行时间按新周期重新计算
+ * @param  *builder: 构建器
+ * @param  period: 周期(ms)
+ */
+static void sched_period_set(sensor_builder_t *builder, uint32_t period)
+{
+    if(builder->period == period) {
+        return;
+    }
+    if(builder->period != 0) {
+        builder->next_run = builder->next_run - builder->period + period;
+    }
+    builder->period = period;
+}
+/**
+ * @brief  更新单次执行能耗估计
+ * @param  *item: 调度项
+ */
+static void sched_cost_update(sensor_sched_item_t *item)
+{
+    sensor_builder_t *builder = item->builder;
+    uint32_t runs = builder->runs - item->runs;
+    if(runs == 0) {
+        return;
+    }
+
+    float sample = (float)(builder->energy - item->energy) / runs / 1000000.0f;
+    item->runs = builder->runs;
+    item->energy = builder->energy;
+    if(item->cost == 0) {
+        item->cost = sample;
+    } else {
+        item->cost += SENSOR_SCHED_ALPHA * (sample - item->cost);
+    }
+}
+/**
+ * @brief  调度器初始化
+ * @note   构建器周期限制在[min_period, max_period],未设置周期的按max_period执行
+ * @param  *sched: 调度器
+ * @param  daily: 每日能耗预算(mJ)
+ * @param  interval: 重新规划间隔(ms)
+ * @param  *item: 调度项
+ * @param  num: 调度项数量
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_sched_init(sensor_sched_t *sched, float daily, uint32_t interval,
+                       sensor_sched_item_t *item, uint8_t num)
+{
+    if(sched == NULL || item == NULL || num == 0 || daily <= 0) {
+        return false;
+    }
+    for(uint8_t i = 0; i < num; i++) {
+        if(item[i].builder == NULL || item[i].min_period == 0
+        || item[i].min_period > item[i].max_period) {
+            return false;
+        }
+    }
+
+    memset(sched, 0, sizeof(sensor_sched_t));
+    sched->daily = daily;
+    sched->interval = interval;
+    sched->item = item;
+    sched->num = num;
+    sched->last = sensor_time_get();
+    sched->total = sensor_energy_total();
+    for(uint8_t i = 0; i < num; i++) {
+        sensor_builder_t *builder = item[i].builder;
+        item[i].cost = 0;
+        item[i].power = 0;
+        item[i].runs = builder->runs;
+        item[i].energy = builder->energy;
+        if(builder->period == 0 || builder->period > item[i].max_period) {
+            sched_period_set(builder, item[i].max_period);
+        } else if(builder->period < item[i].min_period) {
+            sched_period_set(builder, item[i].min_period);
+        }
+    }
+    return true;
+}
+/**
+ * @brief  重新规划构建器周期
+ * @note   可在预算或调度项参数修改后立即调用
+ * @param  *sched: 调度器
+ */
+void sensor_sched_plan(sensor_sched_t *sched)
+{
+    if(sched == NULL) {
+        return;
+    }
+
+    //按当前预算累计结余,结余上限为一个修正时长的预算
+    float rate = sched->daily / SCHED_DAY_MS;
+    uint64_t total = sensor_energy_total();
+    sched->balance += rate * sensor_time_age(sched->last) - (float)(total - sched->total) / 1000000.0f;
+    if(sched->balance > rate * SENSOR_SCHED_HORIZON) {
+        sched->balance = rate * SENSOR_SCHED_HORIZON;
+    }
+    sched->last = sensor_time_get();
+    sched->total = total;
+
+    //结余在修正时长内摊还
+    float power = rate + sched->balance / (float)SENSOR_SCHED_HORIZON;
+    if(power < 0) {
+        power = 0;
+    }
+    sched->power = power;
+
+    //最低采样率
+    float remain = power;
+    for(uint8_t i = 0; i < sched->num; i++) {
+        sensor_sched_item_t *item = &sched->item[i];
+        sched_cost_update(item);
+        item->power = item->cost / item->max_period;
+        remain -= item->power;
+    }
+    sched->shortfall = (remain < 0);
+
+    //剩余功率按优先级分配,达到最高采样率的余量继续分给其他构建器
+    for(uint8_t n = 0; n < sched->num && remain > 0; n++) {
+        uint32_t weight = 0;
+        for(uint8_t i = 0; i < sched->num; i++) {
+            sensor_sched_item_t *item = &sched->item[i];
+            if(item->cost > 0 && item->power < item->cost / item->min_period) {
+                weight += item->priority;
+            }
+        }
+        if(weight == 0) {
+            break;
+        }
+
+        float share = remain;
+        for(uint8_t i = 0; i < sched->num; i++) {
+            sensor_sched_item_t *item = &sched->item[i];
+            float cap = item->cost / item->min_period;
+            if(item->cost > 0 && item->power < cap) {
+                float add = share * item->priority / weight;
+                if(add > cap - item->power) {
+                    add = cap - item->power;
+                }
+                item->power += add;
+                remain -= add;
+            }
+        }
+    }
+
+    for(uint8_t i = 0; i < sched->num; i++) {
+        sensor_sched_item_t *item = &sched->item[i];
+        if(item->cost <= 0) {
+            continue;
+        }
+        float period = item->cost / item->power;
+        if(period < item->min_period) {
+            period = item->min_period;
+        } else if(period > item->max_period) {
+            period = item->max_period;
+        }
+        sched_period_set(item->builder, (uint32_t)period);
+    }
+}
+/**
+ * @brief  调度器处理
+ * @note   每隔interval重新规划一次,在sensor_director_process前调用
+ * @param  *sched: 调度器
+ */
+void sensor_sched_process(sensor_sched_t *sched)
+{
+    if(sched == NULL) {
+        return;
+    }
+    if(sensor_time_age(sched->last) >= sched->interval) {
+        sensor_sched_plan(sched);
+    }
+}
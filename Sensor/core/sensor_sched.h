@@ -0,0 +1,88 @@
+/**
+ * @file sensor_sched.h
+ * @brief 传感器能耗预算调度
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 按每日能耗预算调整构建器执行周期;
+ * 单次执行能耗由构建器能耗统计实测,平滑后作为估计值;
+ * 结余 = 按当时预算累计的能耗 - 实际能耗,结余上限为一个修正时长的预算,修改预算不追溯;
+ * 可用功率 = 预算功率 + 结余 / 修正时长,超支时降低后续采样率,结余时提高;
+ * 每个构建器先按最低采样率分配,剩余功率按优先级权重分配,达到最高采样率后余量分给其他构建器;
+ * 预算不足以维持最低采样率时所有构建器按最低采样率执行并置位shortfall;
+ * 尚未测得能耗的构建器保持当前周期
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_SCHED_H__
+#define __SENSOR_SCHED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sensor_builder.h"
+/* Exported constants --------------------------------------------------------*/
+#ifndef SENSOR_SCHED_HORIZON
+#define SENSOR_SCHED_HORIZON    (24UL * 3600 * 1000)    //超支/结余修正时长(ms)
+#endif
+#ifndef SENSOR_SCHED_ALPHA
+#define SENSOR_SCHED_ALPHA      (0.25f)                 //单次能耗平滑系数
+#endif
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  调度项
+ * @note   由使用者静态定义,填写builder/priority/min_period/max_period
+ */
+typedef struct
+{
+    sensor_builder_t *builder;  //构建器
+    uint8_t  priority;          //优先级权重,越大分配越多,0表示固定最低采样率
+    uint32_t min_period;        //最小周期(ms),对应最高采样率
+    uint32_t max_period;        //最大周期(ms),对应最低采样率
+
+    float    cost;              //单次执行能耗估计(mJ),0表示未测得
+    float    power;             //分配功率(mJ/ms)
+    uint32_t runs;              //上次统计时构建器执行次数
+    uint64_t energy;            //上次统计时构建器能耗(nJ)
+}sensor_sched_item_t;
+/**
+ * @brief  调度器
+ * @note   None
+ */
+typedef struct
+{
+    float    daily;             //每日能耗预算(mJ)
+    uint32_t interval;          //重新规划间隔(ms)
+    sensor_sched_item_t *item;  //调度项
+    uint8_t  num;               //调度项数量
+
+    uint32_t last;              //上次规划时间
+    uint64_t total;             //上次规划时已结算总能耗(nJ)
+    float    balance;           //预算结余(mJ),负数表示超支
+    float    power;             //当前可用功率(mJ/ms)
+    bool     shortfall;         //预算不足以维持最低采样率
+}sensor_sched_t;
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+bool sensor_sched_init(sensor_sched_t *sched, float daily, uint32_t interval,
+                       sensor_sched_item_t *item, uint8_t num);
+void sensor_sched_process(sensor_sched_t *sched);
+void sensor_sched_plan(sensor_sched_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_SCHED_H__ */
@@ -0,0 +1,389 @@
+/**
+ * @file sensor_store.c
+ * @brief 传感器数据Flash日志存储
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 扇区布局:
+ * | 扇区头 32字节 | 记录槽0 | 记录槽1 | ... |
+ * 扇区头分为4个8字节写入单元,每个单元擦除后只写入一次:
+ *   单元0: magic + seq          开启扇区时写入
+ *   单元1: t_first + 槽大小      开启扇区时写入
+ *   单元2: t_last + count       扇区写满封存时写入
+ *   单元3: 保留
+ * 记录槽: ts(4) + len(2) + check(2) + data,按槽大小对齐
+ * 当前写入扇区未封存,上电时对记录槽二分查找得到写入位置,无需逐条扫描
+ * 时间戳需单调递增,建议使用RTC秒计数
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_store.h"
+/* Private includes ----------------------------------------------------------*/
+#include <string.h>
+#include <stddef.h>
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t t_first;
+    uint16_t record_size;
+    uint16_t reserved0;
+    uint32_t t_last;
+    uint32_t count;
+    uint32_t reserved1[2];
+}store_sector_head_t;
+
+typedef struct
+{
+    uint32_t ts;
+    uint16_t len;
+    uint16_t check;
+}store_record_head_t;
+/* Private define ------------------------------------------------------------*/
+#define STORE_MAGIC         0X53544F52  //"STOR"
+#define STORE_ERASED        0XFFFFFFFF
+#define STORE_HEAD_SIZE     sizeof(store_sector_head_t)
+/* Private macro -------------------------------------------------------------*/
+#define ALIGN_UP(x, a)      ((((x) + (a) - 1) / (a)) * (a))
+#define SECTOR_ADDR(s, n)   ((s)->flash->base + (uint32_t)(n) * (s)->flash->sector_size)
+#define SLOT_ADDR(s, n, i)  (SECTOR_ADDR(s, n) + STORE_HEAD_SIZE + (uint32_t)(i) * (s)->record_size)
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  记录校验
+ * @note   Fletcher-16
+ * @param  ts: 时间戳
+ * @param  *data: 数据
+ * @param  len: 数据长度
+ * @retval 校验值
+ */
+static uint16_t record_check(uint32_t ts, const uint8_t *data, uint16_t len)
+{
+    uint16_t sum1 = 0xFF, sum2 = 0xFF;
+    for(uint8_t i = 0; i < 4; i++) {
+        sum1 = (sum1 + ((ts >> (i * 8)) & 0xFF)) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    for(uint16_t i = 0; i < len; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+/**
+ * @brief  写入Flash并统计
+ * @param  *store: 存储对象
+ * @param  addr: 地址
+ * @param  *data: 数据
+ * @param  len: 长度,需对齐
+ * @retval true: 成功 false: 失败
+ */
+static bool flash_write(sensor_store_t *store, uint32_t addr, const void *data, uint32_t len)
+{
+    store->stats.flash_bytes += len;
+    return store->flash->write(addr, data, len);
+}
+/**
+ * @brief  读取记录槽时间戳
+ * @param  *store: 存储对象
+ * @param  sector: 扇区
+ * @param  slot: 记录槽
+ * @retval 时间戳,未写入返回STORE_ERASED
+ */
+static uint32_t slot_ts(sensor_store_t *store, uint16_t sector, uint16_t slot)
+{
+    store_record_head_t head;
+    if(store->flash->read(SLOT_ADDR(store, sector, slot), &head, sizeof(head)) == false) {
+        return STORE_ERASED;
+    }
+    if(head.len == 0xFFFF && head.check == 0xFFFF) {
+        return STORE_ERASED;
+    }
+    return head.ts;
+}
+/**
+ * @brief  查找扇区写入位置
+ * @note   记录槽顺序写入,二分查找第一个未写入槽
+ * @param  *store: 存储对象
+ * @param  sector: 扇区
+ * @retval 已写入记录数量
+ */
+static uint16_t sector_used(sensor_store_t *store, uint16_t sector)
+{
+    uint16_t lo = 0, hi = store->slot_num;
+    while(lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if(slot_ts(store, sector, mid) == STORE_ERASED) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+/**
+ * @brief  封存扇区
+ * @note   写入扇区头单元2;该单元擦除后只能写入一次,已封存扇区直接返回
+ * @param  *store: 存储对象
+ * @param  sector: 扇区
+ * @retval true: 成功 false: 失败
+ */
+static bool sector_seal(sensor_store_t *store, uint16_t sector)
+{
+    if(store->index[sector].sealed == true) {
+        return true;
+    }
+    uint32_t tail[2] = {store->index[sector].t_last, store->index[sector].count};
+    if(flash_write(store, SECTOR_ADDR(store, sector) + offsetof(store_sector_head_t, t_last), tail, sizeof(tail)) == false) {
+        return false;
+    }
+    store->index[sector].sealed = true;
+    return true;
+}
+/**
+ * @brief  开启新扇区
+ * @note   循环选择下一个扇区,擦除后写入扇区头,最旧数据被覆盖;
+ *         扇区头写入成功后才更新序号与当前扇区,失败时序号与扇区映射保持不变
+ * @param  *store: 存储对象
+ * @param  ts: 首条记录时间戳
+ * @retval true: 成功 false: 失败
+ */
+static bool sector_open(sensor_store_t *store, uint32_t ts)
+{
+    uint16_t next = (store->index[store->active].seq == 0) ? store->active
+                  : (store->active + 1) % store->flash->sector_num;
+
+    if(store->flash->erase(SECTOR_ADDR(store, next)) == false) {
+        return false;
+    }
+    store->stats.erase_count++;
+    //旧数据已擦除,查询时跳过该扇区
+    memset(&store->index[next], 0, sizeof(sensor_store_index_t));
+
+    uint32_t seq = store->seq + 1;
+    uint32_t head[4] = {STORE_MAGIC, seq, ts, store->record_size | 0xFFFF0000};
+    if(flash_write(store, SECTOR_ADDR(store, next), head, sizeof(head)) == false) {
+        return false;
+    }
+
+    store->seq = seq;
+    store->active = next;
+    store->index[next].seq = seq;
+    store->index[next].t_first = ts;
+    store->index[next].t_last = ts;
+    store->index[next].count = 0;
+    return true;
+}
+/**
+ * @brief  存储初始化
+ * @note   仅扫描扇区头恢复索引;记录槽大小变化时格式化
+ * @param  *store: 存储对象
+ * @param  *flash: Flash驱动接口
+ * @param  data_size: 单条记录最大数据长度
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_store_init(sensor_store_t *store, const sensor_flash_ops_t *flash, uint16_t data_size)
+{
+    if(store == NULL || flash == NULL || flash->read == NULL || flash->write == NULL || flash->erase == NULL
+    || flash->sector_num == 0 || flash->sector_num > SENSOR_STORE_SECTOR_MAX || flash->write_align == 0) {
+        return false;
+    }
+
+    memset(store, 0, sizeof(sensor_store_t));
+    store->flash = flash;
+    store->record_size = ALIGN_UP(sizeof(store_record_head_t) + data_size, flash->write_align);
+    if(store->record_size > SENSOR_STORE_RECORD_MAX || flash->sector_size <= STORE_HEAD_SIZE + store->record_size) {
+        return false;
+    }
+    store->slot_num = (flash->sector_size - STORE_HEAD_SIZE) / store->record_size;
+
+    bool format = false;
+    for(uint16_t i = 0; i < flash->sector_num; i++) {
+        store_sector_head_t head;
+        if(flash->read(SECTOR_ADDR(store, i), &head, sizeof(head)) == false) {
+            return false;
+        }
+        if(head.magic != STORE_MAGIC) {
+            continue;
+        }
+        //单元1未写入:开启扇区时掉电,视为空扇区,下次开启时重新擦除,不可按槽大小变化格式化
+        if(head.record_size == 0xFFFF) {
+            continue;
+        }
+        if(head.record_size != store->record_size) {
+            format = true;
+            break;
+        }
+        store->index[i].seq = head.seq;
+        store->index[i].t_first = head.t_first;
+        if(head.t_last != STORE_ERASED) {
+            store->index[i].t_last = head.t_last;
+            store->index[i].count = head.count;
+            store->index[i].sealed = true;
+        } else {
+            //未封存扇区(当前写入扇区或封存前掉电),恢复写入位置与结束时间
+            store->index[i].count = sector_used(store, i);
+            store->index[i].t_last = (store->index[i].count != 0) ? slot_ts(store, i, store->index[i].count - 1) : head.t_first;
+        }
+        if(head.seq > store->seq) {
+            store->seq = head.seq;
+            store->active = i;
+        }
+    }
+    if(format == true) {
+        return sensor_store_format(store);
+    }
+    return true;
+}
+/**
+ * @brief  格式化存储区
+ * @note   擦除全部扇区
+ * @param  *store: 存储对象
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_store_format(sensor_store_t *store)
+{
+    if(store == NULL || store->flash == NULL) {
+        return false;
+    }
+    for(uint16_t i = 0; i < store->flash->sector_num; i++) {
+        if(store->flash->erase(SECTOR_ADDR(store, i)) == false) {
+            return false;
+        }
+        store->stats.erase_count++;
+    }
+    memset(store->index, 0, sizeof(store->index));
+    store->active = 0;
+    store->seq = 0;
+    return true;
+}
+/**
+ * @brief  追加记录
+ * @note   时间戳需单调递增;扇区写满后封存并切换至下一扇区
+ * @param  *store: 存储对象
+ * @param  ts: 时间戳
+ * @param  *data: 数据
+ * @param  len: 数据长度
+ * @retval true: 成功 false: 失败
+ */
+bool sensor_store_append(sensor_store_t *store, uint32_t ts, const void *data, uint16_t len)
+{
+    if(store == NULL || store->flash == NULL || data == NULL
+    || sizeof(store_record_head_t) + len > store->record_size) {
+        return false;
+    }
+
+    sensor_store_index_t *active = &store->index[store->active];
+    if(active->seq == 0 || active->count >= store->slot_num) {
+        //上电恢复的已封存扇区或上次开启新扇区失败时不再重复封存
+        if(active->seq != 0 && sector_seal(store, store->active) == false) {
+            return false;
+        }
+        if(sector_open(store, ts) == false) {
+            return false;
+        }
+        active = &store->index[store->active];
+    }
+
+    store_record_head_t head = {
+        .ts = ts,
+        .len = len,
+        .check = record_check(ts, data, len),
+    };
+    memset(store->buf, 0xFF, store->record_size);
+    memcpy(store->buf, &head, sizeof(head));
+    memcpy(store->buf + sizeof(head), data, len);
+    uint16_t size = ALIGN_UP(sizeof(head) + len, store->flash->write_align);
+    if(flash_write(store, SLOT_ADDR(store, store->active, active->count), store->buf, size) == false) {
+        return false;
+    }
+
+    store->stats.payload_bytes += len;
+    active->t_last = ts;
+    active->count++;
+    return true;
+}
+/**
+ * @brief  时间范围查询
+ * @note   按扇区序号由旧到新遍历;扇区内二分查找起始记录
+ * @param  *store: 存储对象
+ * @param  t_start: 起始时间
+ * @param  t_end: 结束时间
+ * @param  visit: 记录回调
+ * @param  *arg: 用户参数
+ * @retval 访问的记录数量
+ */
+uint32_t sensor_store_query(sensor_store_t *store, uint32_t t_start, uint32_t t_end,
+                            sensor_store_visit_t visit, void *arg)
+{
+    if(store == NULL || store->flash == NULL || visit == NULL || t_start > t_end) {
+        return 0;
+    }
+
+    uint32_t visited = 0;
+    uint32_t seq_min = (store->seq >= store->flash->sector_num) ? store->seq - store->flash->sector_num + 1 : 1;
+    for(uint32_t seq = seq_min; seq <= store->seq; seq++) {
+        uint16_t sector = (store->active + store->flash->sector_num - (store->seq - seq)) % store->flash->sector_num;
+        sensor_store_index_t *index = &store->index[sector];
+        if(index->seq != seq || index->count == 0) {
+            continue;
+        }
+        if(index->t_last < t_start || index->t_first > t_end) {
+            continue;
+        }
+
+        uint16_t lo = 0, hi = index->count;
+        while(lo < hi) {
+            uint16_t mid = lo + (hi - lo) / 2;
+            if(slot_ts(store, sector, mid) < t_start) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        for(uint16_t i = lo; i < index->count; i++) {
+            if(store->flash->read(SLOT_ADDR(store, sector, i), store->buf, store->record_size) == false) {
+                return visited;
+            }
+            store_record_head_t *head = (store_record_head_t *)store->buf;
+            if(head->ts > t_end) {
+                return visited;
+            }
+            if(head->len > store->record_size - sizeof(store_record_head_t)
+            || head->check != record_check(head->ts, store->buf + sizeof(store_record_head_t), head->len)) {
+                //掉电导致的半写记录
+                store->stats.drop_count++;
+                continue;
+            }
+            visited++;
+            if(visit(head->ts, store->buf + sizeof(store_record_head_t), head->len, arg) == false) {
+                return visited;
+            }
+        }
+    }
+    return visited;
+}
+/**
+ * @brief  最新记录时间戳
+ * @note   上电后用于恢复时间基准,保证追加记录的时间戳单调递增
+ * @param  *store: 存储对象
+ * @retval 最新记录时间戳,无记录返回0
+ */
+uint32_t sensor_store_last(const sensor_store_t *store)
+{
+    if(store == NULL || store->index[store->active].seq == 0) {
+        return 0;
+    }
+    return store->index[store->active].t_last;
+}
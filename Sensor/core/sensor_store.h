@@ -0,0 +1,107 @@
+/**
+ * @file sensor_store.h
+ * @brief 传感器数据Flash日志存储
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 只追加写入,扇区循环使用实现磨损均衡;扇区头记录时间范围用于快速范围查询;
+ * 掉电后仅扫描扇区头即可恢复
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_STORE_H__
+#define __SENSOR_STORE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+/* Exported constants --------------------------------------------------------*/
+#define SENSOR_STORE_SECTOR_MAX     (32)    //最大扇区数量
+#define SENSOR_STORE_RECORD_MAX     (128)   //最大记录长度(含记录头)
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  Flash驱动接口
+ * @note   写入地址与长度均按write_align对齐;同一对齐单元擦除后只写入一次
+ */
+typedef struct
+{
+    bool (*read)(uint32_t addr, void *data, uint32_t len);
+    bool (*write)(uint32_t addr, const void *data, uint32_t len);
+    bool (*erase)(uint32_t addr);       //擦除addr所在扇区
+    uint32_t base;                      //存储区起始地址
+    uint32_t sector_size;               //扇区大小
+    uint16_t sector_num;                //扇区数量
+    uint8_t  write_align;               //写入对齐单位,STM32WL为8
+}sensor_flash_ops_t;
+/**
+ * @brief  扇区索引
+ * @note   由扇区头恢复,常驻内存
+ */
+typedef struct
+{
+    uint32_t seq;       //扇区序号,0表示空扇区
+    uint32_t t_first;   //首条记录时间戳
+    uint32_t t_last;    //末条记录时间戳
+    uint16_t count;     //记录数量
+    bool     sealed;    //扇区头单元2已写入,不可再次封存
+}sensor_store_index_t;
+/**
+ * @brief  存储统计
+ * @note   写放大 = flash_bytes / payload_bytes
+ */
+typedef struct
+{
+    uint32_t payload_bytes;     //用户数据写入字节数
+    uint32_t flash_bytes;       //实际写入Flash字节数
+    uint32_t erase_count;       //擦除次数
+    uint32_t drop_count;        //校验失败丢弃记录数
+}sensor_store_stats_t;
+/**
+ * @brief  存储对象
+ * @note   None
+ */
+typedef struct
+{
+    const sensor_flash_ops_t *flash;
+    uint16_t record_size;                           //记录槽大小(含记录头,已对齐)
+    uint16_t slot_num;                              //每扇区记录槽数量
+    uint16_t active;                                //当前写入扇区
+    uint32_t seq;                                   //当前最大扇区序号
+    sensor_store_index_t index[SENSOR_STORE_SECTOR_MAX];
+    sensor_store_stats_t stats;
+    uint8_t  buf[SENSOR_STORE_RECORD_MAX];          //读写缓存
+}sensor_store_t;
+/**
+ * @brief  范围查询回调
+ * @param  ts: 记录时间戳
+ * @param  *data: 记录数据
+ * @param  len: 数据长度
+ * @param  *arg: 用户参数
+ * @retval true: 继续 false: 停止查询
+ */
+typedef bool (*sensor_store_visit_t)(uint32_t ts, const uint8_t *data, uint16_t len, void *arg);
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+bool sensor_store_init(sensor_store_t *store, const sensor_flash_ops_t *flash, uint16_t data_size);
+bool sensor_store_append(sensor_store_t *store, uint32_t ts, const void *data, uint16_t len);
+uint32_t sensor_store_query(sensor_store_t *store, uint32_t t_start, uint32_t t_end,
+                            sensor_store_visit_t visit, void *arg);
+bool sensor_store_format(sensor_store_t *store);
+uint32_t sensor_store_last(const sensor_store_t *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_STORE_H__ */
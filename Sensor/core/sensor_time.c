@@ -0,0 +1,100 @@
+/**
+ * @file sensor_time.c
+ * @brief 传感器时间源
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include "sensor_time.h"
+/* Private includes ----------------------------------------------------------*/
+#include <stddef.h>
+#include "board_system.h"
+#include "NodeSDKConfig.h"
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static sensor_time_source_t _time_source = NULL;
+static uint32_t _deadline = 0;          //截止时间
+static bool     _deadline_en = false;   //截止时间有效
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  设置时间源
+ * @note   初始化阶段调用;为空时恢复默认时间源
+ * @param  source: 时间源
+ */
+void sensor_time_set_source(sensor_time_source_t source)
+{
+    _time_source = source;
+}
+/**
+ * @brief  获取当前时间戳
+ * @note   可在中断中调用
+ * @retval 单调毫秒时间
+ */
+uint32_t sensor_time_get(void)
+{
+    sensor_time_source_t source = _time_source;
+    if(source != NULL) {
+        return source();
+    }
+    return sensor_time_default();
+}
+/**
+ * @brief  获取时间戳距今时长
+ * @note   无符号差值,跨回绕有效
+ * @param  ts: 时间戳
+ * @retval 时长(ms)
+ */
+uint32_t sensor_time_age(uint32_t ts)
+{
+    return (uint32_t)(sensor_time_get() - ts);
+}
+/**
+ * @brief  默认时间源
+ * @note   可重写
+ * @retval 单调毫秒时间
+ */
+__weak uint32_t sensor_time_default(void)
+{
+    return HAL_GetTick();
+}
+/**
+ * @brief  设置截止时间
+ * @note   由调度器在执行阶段前调用
+ * @param  ms: 距当前时间的时长,0表示不限制
+ */
+void sensor_deadline_set(uint32_t ms)
+{
+    _deadline = sensor_time_get() + ms;
+    _deadline_en = (ms != 0);
+}
+/**
+ * @brief  清除截止时间
+ */
+void sensor_deadline_clear(void)
+{
+    _deadline_en = false;
+}
+/**
+ * @brief  是否超过截止时间
+ * @note   驱动在重试与等待循环中调用,超时后应尽快返回失败
+ * @retval true: 已超时 false: 未超时或未设置
+ */
+bool sensor_deadline_expired(void)
+{
+    return _deadline_en == true && (int32_t)(sensor_time_get() - _deadline) >= 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file sensor_time.h
+ * @brief 传感器时间源
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 单调毫秒时间戳,32位回绕约49.7天,比较时使用无符号差值;
+ * 时间源可替换,默认使用HAL_GetTick,主机端可设置为自定义时钟;
+ * 时间源须可在中断中调用;
+ * 截止时间由调度器在每个阶段前设置,驱动在重试/等待循环中调用sensor_deadline_expired协作退出
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+#ifndef __SENSOR_TIME_H__
+#define __SENSOR_TIME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  时间源
+ * @retval 单调毫秒时间
+ */
+typedef uint32_t (*sensor_time_source_t)(void);
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void sensor_time_set_source(sensor_time_source_t source);
+uint32_t sensor_time_get(void);
+uint32_t sensor_time_age(uint32_t ts);
+uint32_t sensor_time_default(void);
+
+void sensor_deadline_set(uint32_t ms);
+void sensor_deadline_clear(void);
+bool sensor_deadline_expired(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SENSOR_TIME_H__ */
@@ -1,229 +1,849 @@
+#include <math.h>
+#include <string.h>
+
 #include "ads1015.h"
 #include "main.h"
 #include "i2c.h"
 #include "module_ntag.h"
 
-#define I2C_ADDR          0x48
-#define I2C_READ_ADDR     0x91
-#define I2C_WRITE_ADDR    0x90
+#define POINTER_UNKNOWN   0xFF
+//比较器关闭,与上电默认值一致
+#define CONFIG_COMP_DEFAULT   (0x3 << 0)
+//比较器每次转换后触发,低有效,非锁存;配合阈值寄存器作为转换完成信号
+#define CONFIG_COMP_RDY       (0x0 << 0)
+#define RDY_LO_THRESH         0x0000    //Lo_thresh最高位为0
+#define RDY_HI_THRESH         0x8000    //Hi_thresh最高位为1
+#define RDY_DELAY_MS          10        //固定延时等待时间
+#define XFER_MS               0.1f      //单次读取I2C耗时估计(ms)
+#define CODE_POS_CLIP         2047      //正向满量程码值
+#define CODE_NEG_CLIP         (-2048)   //负向满量程码值
+//扫描排序键:量程、数据率、通道
+#define SCAN_KEY(e)           (((uint16_t)(e)->fsr << 6) | ((uint16_t)(e)->dr << 3) | (uint16_t)(e)->mux)
+
+/**
+ * @brief  扫描游标
+ * @note   记录单个实例扫描进度,多实例扫描时轮流推进
+ */
+typedef struct scan_cursor_s {
+	uint8_t order[ADS1015_SCAN_MAX];	//执行顺序
+	uint16_t offset[ADS1015_SCAN_MAX];	//各项结果起始位置
+	uint8_t entry;		//当前执行项
+	uint8_t count;		//当前采样点
+	uint8_t n;			//当前采样点已转换次数
+	uint8_t valid;		//当前采样点有效转换次数
+	int32_t sum;		//当前采样点码值和
+	bool clip;			//当前采样点存在满量程码值
+	bool discard;		//丢弃配置后首个结果
+	bool done;			//扫描结束
+	uint32_t start;		//本次转换开始时间
+} scan_cursor_t;
 
-static I2c_t *s_i2c_handle = NULL;
-static ads1015_mode_t s_cur_mode = 0;
+//各数据率转换完成超时(ms),两个转换周期加1ms
+static const uint8_t s_rdy_timeout[] =
+{
+	[SPS_128]  = 17,
+	[SPS_250]  = 9,
+	[SPS_490]  = 6,
+	[SPS_920]  = 4,
+	[SPS_1600] = 3,
+	[SPS_2400] = 3,
+	[SPS_3300] = 3,
+};
+static const uint16_t s_dr_sps[] =
+{
+	[SPS_128]  = 128,
+	[SPS_250]  = 250,
+	[SPS_490]  = 490,
+	[SPS_920]  = 920,
+	[SPS_1600] = 1600,
+	[SPS_2400] = 2400,
+	[SPS_3300] = 3300,
+};
+//各数据率器件噪声(uV RMS),ADS1015低量程下远小于1LSB,噪声以外部电路为主
+static const float s_dr_noise_uv[] =
+{
+	[SPS_128]  = 4.0f,
+	[SPS_250]  = 5.0f,
+	[SPS_490]  = 7.0f,
+	[SPS_920]  = 10.0f,
+	[SPS_1600] = 13.0f,
+	[SPS_2400] = 16.0f,
+	[SPS_3300] = 19.0f,
+};
+//各量程LSB(uV)
+static const float s_fsr_lsb_uv[] =
+{
+	[FSR_6144] = 3000.0f,
+	[FSR_4096] = 2000.0f,
+	[FSR_2048] = 1000.0f,
+	[FSR_1024] = 500.0f,
+	[FSR_0512] = 250.0f,
+	[FSR_0256] = 125.0f,
+};
 
 /**
  * @brief  加锁
- * @note   None
+ * @note   实例处于扫描会话时总线锁已持有
  * @retval None
  */
-static int ads1015_lock(void)
+static int ads1015_lock(ads1015_t *dev)
 {
+    if(dev->session == true) {
+        return 0;
+    }
     return ntag_lock();
 }
 /**
  * @brief  解锁
- * @note   None
+ * @note   实例处于扫描会话时由扫描结束统一释放
  * @retval None
  */
-static int ads1015_unlock(void)
+static int ads1015_unlock(ads1015_t *dev)
 {
+    if(dev->session == true) {
+        return 0;
+    }
     return ntag_unlock();
 }
 
-static uint8_t write_register(ads1015_reg_addr_t reg, uint16_t value)
+/**
+ * @brief  写指针后重复起始读取
+ * @note   默认以指针写与读取两次传输实现;
+ *         板级I2C支持重复起始(如HAL_I2C_Mem_Read)时重新实现为一次传输
+ * @param  *obj: I2C对象
+ * @param  addr: 器件地址
+ * @param  reg: 寄存器
+ * @param  *data: 读取数据
+ * @param  size: 读取长度
+ * @retval 0: 成功 其他: 失败
+ */
+__weak uint8_t ads1015_i2c_read_reg(I2c_t *obj, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t size)
+{
+	uint8_t ret = I2cTransmit(obj, addr, &reg, 1);
+	if(ret) {
+		return ret;
+	}
+	return I2cReceive(obj, addr, data, size);
+}
+/**
+ * @brief  写寄存器
+ * @note   调用者持有锁;写操作同时将指针寄存器指向reg
+ */
+static uint8_t write_register_locked(ads1015_t *dev, ads1015_reg_addr_t reg, uint16_t value)
 {
 	uint8_t data[3] = {0};
 	
 	data[0] = reg;
 	data[1] = (value >> 8) & 0xff;
 	data[2] = value & 0xff;
-	ads1015_lock();
-	uint8_t ret =  I2cTransmit(s_i2c_handle, I2C_ADDR, data, sizeof(data));
-	ads1015_unlock();
+	dev->xfer_count++;
+	uint8_t ret = I2cTransmit(dev->i2c, dev->addr, data, sizeof(data));
+	dev->pointer = (ret == 0) ? reg : POINTER_UNKNOWN;
 	return ret;
 }
-
-static uint8_t read_register(ads1015_reg_addr_t reg, uint16_t *value)
+/**
+ * @brief  读寄存器
+ * @note   调用者持有锁;指针已指向reg时直接读取,否则指针写与读取合并为一次重复起始传输
+ */
+static uint8_t read_register_locked(ads1015_t *dev, ads1015_reg_addr_t reg, uint16_t *value)
 {
 	uint8_t data[2] = {0};
 	uint8_t ret;
 
-	ads1015_lock();
-	ret = I2cTransmit(s_i2c_handle, I2C_ADDR, (uint8_t *)&reg, 1);
-	if(ret) {
-		ads1015_unlock();
-		return ret;
+	dev->xfer_count++;
+	if(dev->pointer == reg) {
+		ret = I2cReceive(dev->i2c, dev->addr, data, sizeof(data));
+	} else {
+		ret = ads1015_i2c_read_reg(dev->i2c, dev->addr, reg, data, sizeof(data));
 	}
-	
-	ret = I2cReceive(s_i2c_handle, I2C_ADDR, data, sizeof(data));
-	ads1015_unlock();
 	if(ret) {
+		dev->pointer = POINTER_UNKNOWN;
 		return ret;
 	}
+	dev->pointer = reg;
 	
 	*value = (data[0] << 8) | data[1];
 	
 	return ret;
 }
 
-static uint8_t ads1015_conversions_trigger(void)
+static uint8_t write_register(ads1015_t *dev, ads1015_reg_addr_t reg, uint16_t value)
 {
-	ConfigReg_t reg;
+	ads1015_lock(dev);
+	uint8_t ret = write_register_locked(dev, reg, value);
+	ads1015_unlock(dev);
+	return ret;
+}
+
+static uint8_t read_register(ads1015_t *dev, ads1015_reg_addr_t reg, uint16_t *value)
+{
+	ads1015_lock(dev);
+	uint8_t ret = read_register_locked(dev, reg, value);
+	ads1015_unlock(dev);
+	return ret;
+}
+/**
+ * @brief  写配置寄存器
+ * @note   与影子一致时跳过;OS位为触发位,写入后不保存到影子
+ */
+static uint8_t config_write(ads1015_t *dev, uint16_t value)
+{
+	uint8_t ret = 0;
+	uint16_t shadow = value & ~ADS1015_CONFIG_OS;
+
+	ads1015_lock(dev);
+	if(dev->config_valid == false || dev->config != shadow || (value & ADS1015_CONFIG_OS)) {
+		ret = write_register_locked(dev, Reg_Config, value);
+		dev->config_valid = (ret == 0);
+		dev->config = shadow;
+	}
+	ads1015_unlock(dev);
+	return ret;
+}
+
+static uint8_t ads1015_conversions_trigger(ads1015_t *dev)
+{
+	dev->rdy_flag = false;
+	return config_write(dev, dev->config | ADS1015_CONFIG_OS);
+}
+/**
+ * @brief  配置阈值寄存器为转换完成信号
+ * @note   上电后阈值为默认值,首次使用RDY_PIN时写入
+ */
+static uint8_t rdy_thresh_config(ads1015_t *dev)
+{
+	uint8_t ret = 0;
+
+	if(dev->rdy == ADS1015_RDY_PIN && dev->rdy_valid == false) {
+		ret = write_register(dev, Reg_LoThresh, RDY_LO_THRESH);
+		if(ret == 0) {
+			ret = write_register(dev, Reg_HiThresh, RDY_HI_THRESH);
+		}
+		dev->rdy_valid = (ret == 0);
+	}
+	return ret;
+}
+/**
+ * @brief  无转换完成信号时的等待时间
+ * @note   固定延时模式SPS_128保持10ms,其他情况按一个转换周期向上取整(ms)
+ */
+static uint32_t rdy_delay(ads1015_t *dev, ads1015_dr_t dr)
+{
+	return (dev->rdy == ADS1015_RDY_DELAY && dr == SPS_128) ? RDY_DELAY_MS : (1000U + s_dr_sps[dr] - 1) / s_dr_sps[dr];
+}
+/**
+ * @brief  等待转换完成
+ * @note   超时后仍读取数据,由调用者按数据判断
+ * @retval true: 转换完成 false: 超时或固定延时
+ */
+static bool wait_ready(ads1015_t *dev)
+{
+	ConfigReg_t reg = {.value = dev->config};
+	uint32_t timeout = s_rdy_timeout[reg.Bits.Dr];
+	uint32_t start = HAL_GetTick();
+
+	if(dev->rdy == ADS1015_RDY_PIN) {
+		while(dev->rdy_flag == false) {
+			if(HAL_GetTick() - start >= timeout) {
+				return false;
+			}
+		}
+		dev->rdy_flag = false;
+		return true;
+	} else if(dev->rdy == ADS1015_RDY_POLL && dev->mode == SingleShot_Mode) {
+		while(HAL_GetTick() - start < timeout) {
+			//OS位读1表示空闲,即转换完成
+			if(read_register(dev, Reg_Config, &reg.value) == 0 && reg.Bits.Os == 1) {
+				return true;
+			}
+		}
+		return false;
+	}
+	HAL_Delay(rdy_delay(dev, (ads1015_dr_t)reg.Bits.Dr));
+	return false;
+}
+/**
+ * @brief  查询转换是否完成
+ * @note   不阻塞,供多实例扫描轮询;超时视为完成,由调用者按数据判断;
+ *         无转换完成信号时start可能位于节拍中间,需多等待1个节拍保证经过完整延时
+ * @param  start: 转换开始时间
+ * @retval true: 可读取 false: 转换中
+ */
+static bool conversion_ready(ads1015_t *dev, uint32_t start)
+{
+	ConfigReg_t reg = {.value = dev->config};
+	uint32_t age = HAL_GetTick() - start;
+
+	if(age >= s_rdy_timeout[reg.Bits.Dr]) {
+		dev->rdy_flag = false;
+		return true;
+	}
+	if(dev->rdy == ADS1015_RDY_PIN) {
+		if(dev->rdy_flag == true) {
+			dev->rdy_flag = false;
+			return true;
+		}
+		return false;
+	} else if(dev->rdy == ADS1015_RDY_POLL && dev->mode == SingleShot_Mode) {
+		return read_register(dev, Reg_Config, &reg.value) == 0 && reg.Bits.Os == 1;
+	}
+	return age > rdy_delay(dev, (ads1015_dr_t)reg.Bits.Dr);
+}
+/**
+ * @brief  读取一次转换结果
+ * @note   单次模式先触发转换;连续模式无转换完成信号时,配置后首个结果丢弃
+ * @param  mode: 转换模式
+ * @param  first: 配置后首次读取
+ * @param  *code: 有符号码值
+ * @retval 0: 成功 其他: 失败
+ */
+static uint8_t conversion_read(ads1015_t *dev, ads1015_mode_t mode, bool first, int16_t *code)
+{
+	uint16_t raw = 0;
 	uint8_t ret;
-	
-	ret = read_register(Reg_Config, &reg.value);
-	if(ret != 0) {
-		return ret;
+
+	if(mode == SingleShot_Mode) {
+		//转换完成等待由wait_ready处理,触发前无需延时
+		ret = ads1015_conversions_trigger(dev);
+		if(ret != 0) {
+			return ret;
+		}
 	}
-	
-	reg.Bits.Os = 1;
-	
-	ret = write_register(Reg_Config, reg.value);	
-	
+
+	//转换完成信号对应配置写入后的首次转换,无需丢弃
+	if(wait_ready(dev) == true) {
+		ret = read_register(dev, Reg_Conversion, &raw);
+	} else if(first == true && Continuous_Mode == mode) {
+		ret = read_register(dev, Reg_Conversion, &raw);
+		wait_ready(dev);
+		ret = read_register(dev, Reg_Conversion, &raw);
+	} else {
+		ret = read_register(dev, Reg_Conversion, &raw);
+	}
+	*code = (int16_t)raw >> 4;
 	return ret;
 }
 
 #if 0
-static void ads1015_set_mode(ads1015_mode_t mode)
+static void ads1015_set_mode(ads1015_t *dev, ads1015_mode_t mode)
 {
 	ConfigReg_t reg;
 	
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 	reg.Bits.Mode = mode;
 	
-	write_register(Reg_Config, reg.value);
+	write_register(dev, Reg_Config, reg.value);
 }
 
-static void ads1015_set_fsr(ads1015_fsr_t fsr)
+static void ads1015_set_fsr(ads1015_t *dev, ads1015_fsr_t fsr)
 {
 	ConfigReg_t reg;
 	
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 	reg.Bits.Pga = fsr;
 	
-	write_register(Reg_Config, reg.value);
+	write_register(dev, Reg_Config, reg.value);
 }
 
-static void ads1015_set_mux(ads1015_mux_t mux)
+static void ads1015_set_mux(ads1015_t *dev, ads1015_mux_t mux)
 {
 	ConfigReg_t reg;
 	
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 	reg.Bits.Mux = mux;
 	
-	write_register(Reg_Config, reg.value);	
+	write_register(dev, Reg_Config, reg.value);	
 }
 
-static void ads1015_set_dr(ads1015_dr_t dr)
+static void ads1015_set_dr(ads1015_t *dev, ads1015_dr_t dr)
 {
 	ConfigReg_t reg;
 	
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 	reg.Bits.Dr = dr;
 	
-	write_register(Reg_Config, reg.value);	
+	write_register(dev, Reg_Config, reg.value);	
 }
 #endif
 
-void ads1015_init(I2c_t *obj)
+/**
+ * @brief  实例初始化
+ * @note   重新上电后器件恢复默认值,影子与指针失效;等待方式保持不变
+ * @param  *dev: 实例
+ * @param  *obj: I2C对象
+ * @param  addr: 器件地址,由ADDR引脚决定,ADS1015_ADDR_GND~ADS1015_ADDR_SCL
+ */
+void ads1015_init(ads1015_t *dev, I2c_t *obj, uint8_t addr)
 {
-	s_i2c_handle = obj;
+	dev->i2c = obj;
+	dev->addr = addr;
+	dev->config_valid = false;
+	dev->rdy_valid = false;
+	dev->rdy_flag = false;
+	dev->pointer = POINTER_UNKNOWN;
+	dev->session = false;
 }
 
-uint8_t ads1015_config(ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, ads1015_dr_t dr)
+void ads1015_rdy_set(ads1015_t *dev, ads1015_rdy_t rdy)
 {
-	ConfigReg_t reg;
-	uint8_t ret;
-	
-	ret = read_register(Reg_Config, &reg.value);
+	dev->rdy = rdy;
+	dev->rdy_valid = false;
+}
+/**
+ * @brief  转换完成中断
+ * @note   各实例ALERT/RDY引脚独立,在对应引脚的外部中断中调用
+ */
+void ads1015_rdy_isr(ads1015_t *dev)
+{
+	dev->rdy_flag = true;
+}
+
+uint8_t ads1015_config(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, ads1015_dr_t dr)
+{
+	//配置寄存器全部字段已知,直接写入,无需先读
+	uint8_t ret = rdy_thresh_config(dev);
 	if(ret != 0) {
 		return ret;
 	}
+	dev->mode = mode;
+	dev->rdy_flag = false;
+	return config_write(dev, ADS1015_CONFIG_ENCODE(num, mode, fsr, dr) |
+	                    ((dev->rdy == ADS1015_RDY_PIN) ? CONFIG_COMP_RDY : CONFIG_COMP_DEFAULT));
+}
 
-	reg.Bits.Mux  = num;
-	reg.Bits.Mode = mode;
-	s_cur_mode    = mode;
-	reg.Bits.Pga  = fsr;
-	reg.Bits.Dr   = dr;
-	
-	ret = write_register(Reg_Config, reg.value);
-	
+uint32_t ads1015_xfer_count(ads1015_t *dev)
+{
+	return dev->xfer_count;
+}
+/**
+ * @brief  开始总线会话
+ * @note   持有总线锁直到ads1015_session_end,期间实例的寄存器访问不再逐次加锁,
+ *         可在中断中读取转换结果;NFC等共用总线的访问被阻塞
+ */
+void ads1015_session_begin(ads1015_t *dev)
+{
+	ads1015_lock(dev);
+	dev->session = true;
+}
+
+void ads1015_session_end(ads1015_t *dev)
+{
+	dev->session = false;
+	ads1015_unlock(dev);
+}
+/**
+ * @brief  读取最新转换结果
+ * @note   不等待转换完成;指针已指向转换寄存器时只需一次读传输
+ * @param  *dev: 实例
+ * @param  *code: 有符号码值
+ * @retval 0: 成功 其他: 失败
+ */
+uint8_t ads1015_conversion_get(ads1015_t *dev, int16_t *code)
+{
+	uint16_t raw = 0;
+	uint8_t ret = read_register(dev, Reg_Conversion, &raw);
+	*code = (int16_t)raw >> 4;
 	return ret;
 }
+/**
+ * @brief  进入掉电
+ * @note   切换为单次模式,当前转换结束后器件掉电
+ */
+uint8_t ads1015_power_down(ads1015_t *dev)
+{
+	dev->mode = SingleShot_Mode;
+	return config_write(dev, dev->config | ADS1015_CONFIG_ENCODE(0, SingleShot_Mode, 0, 0));
+}
 
-uint8_t ads1015_collect(uint8_t samples, ads1015_data_t *data)
+/**
+ * @brief  保存采样点
+ * @note   value保持12位补码形式,mean为有符号均值
+ */
+static void data_store(ads1015_data_t *data, int32_t sum, uint8_t num, bool clip)
+{
+	if(num == 0) {
+		data->succ = false;
+		return;
+	}
+	data->mean = (float)sum / num;
+	data->value = (uint16_t)(int16_t)lroundf(data->mean) & 0x0FFF;
+	data->clip = clip;
+	data->succ = true;
+}
+
+/**
+ * @brief  按当前配置采集
+ * @note   单次转换失败时对应采样点succ置false,继续采集其余采样点
+ * @param  *dev: 实例
+ * @param  samples: 采样点数
+ * @param  *data: 采样数据
+ * @retval 0: 成功 其他: 首个失败转换的错误码
+ */
+uint8_t ads1015_collect(ads1015_t *dev, uint8_t samples, ads1015_data_t *data)
 {
 	uint8_t count = 0;
 	uint8_t ret = 0;
+	int16_t code = 0;
 
 	for(count = 0; count < samples; count++) {
-		if(s_cur_mode == SingleShot_Mode) {
-			HAL_Delay(10);
-			ret = ads1015_conversions_trigger();
-			if(ret != 0) {
-				data[count].succ = false;
-				continue;
-			}
-		}
-
-		HAL_Delay(10);
-
-		ret = read_register(Reg_Conversion, &data[count].value);
-		if(ret == 0) {
-			data[count].value = (data[count].value >> 4);
-			data[count].succ  = true;
+		uint8_t err = conversion_read(dev, dev->mode, false, &code);
+		if(err == 0) {
+			data_store(&data[count], code, 1, (code == CODE_POS_CLIP || code == CODE_NEG_CLIP));
 		} else {
-			data[count].succ  = false;
+			data[count].succ = false;
+			if(ret == 0) {
+				ret = err;
+			}
 		}
 	}
 
-	return 0;
+	return ret;
 }
 
-uint8_t ads1015_extend_collect(ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, uint8_t samples, ads1015_data_t *data)
+uint8_t ads1015_extend_collect(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr,
+                               uint8_t samples, ads1015_data_t *data)
+{
+	return ads1015_extend_collect_dr(dev, num, mode, fsr, SPS_128, 1, samples, data);
+}
+/**
+ * @brief  指定数据率与过采样次数采集
+ * @note   每个采样点为oversample次转换的均值
+ * @param  *dev: 实例
+ * @param  num: 通道
+ * @param  mode: 转换模式
+ * @param  fsr: 量程
+ * @param  dr: 数据率
+ * @param  oversample: 每点过采样次数,0按1处理
+ * @param  samples: 采样点数
+ * @param  *data: 采样数据
+ * @retval 0: 成功 其他: 配置失败
+ */
+uint8_t ads1015_extend_collect_dr(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr,
+                                  ads1015_dr_t dr, uint8_t oversample, uint8_t samples, ads1015_data_t *data)
 {
-	uint8_t count = 0;
 	uint8_t ret;
 	
-	ret = ads1015_config(num, mode, fsr, SPS_128);
+	ret = ads1015_config(dev, num, mode, fsr, dr);
 	if(ret != 0) {
 		return ret;
 	}
+	if(oversample == 0) {
+		oversample = 1;
+	}
 	
-	for(count = 0; count < samples; count++) {
-		if(mode == SingleShot_Mode) {
-			HAL_Delay(10);
-			ret = ads1015_conversions_trigger();
-			if(ret != 0) {
-				data[count].succ = false;
-				continue;
+	for(uint8_t count = 0; count < samples; count++) {
+		int32_t sum = 0;
+		uint8_t n = 0;
+		bool clip = false;
+		for(uint8_t i = 0; i < oversample; i++) {
+			int16_t code = 0;
+			if(conversion_read(dev, mode, (count == 0 && i == 0), &code) == 0) {
+				sum += code;
+				n++;
+				clip |= (code == CODE_POS_CLIP || code == CODE_NEG_CLIP);
 			}
 		}
-		
-		HAL_Delay(10);			
-		if(count == 0 && Continuous_Mode == mode) {
-			ret = read_register(Reg_Conversion, &data[count].value);
-			HAL_Delay(10);
-			ret = read_register(Reg_Conversion, &data[count].value);
-		} else {
-			ret = read_register(Reg_Conversion, &data[count].value);
+		data_store(&data[count], sum, n, clip);
+	}
+	
+	return 0;
+}
+/**
+ * @brief  扫描列表预处理
+ * @note   执行顺序按量程、数据率、通道稳定排序,减少PGA切换与配置写入
+ * @retval 0: 成功 其他: 参数错误
+ */
+static uint8_t scan_prepare(const ads1015_job_t *job, scan_cursor_t *cur)
+{
+	uint16_t total = 0;
+
+	if(job->dev == NULL || job->list == NULL || job->data == NULL
+	|| job->num == 0 || job->num > ADS1015_SCAN_MAX) {
+		return 0xFF;
+	}
+	memset(cur, 0, sizeof(scan_cursor_t));
+	for(uint8_t i = 0; i < job->num; i++) {
+		cur->offset[i] = total;
+		total += job->list[i].samples;
+		cur->order[i] = i;
+	}
+	if(total > job->size) {
+		return 0xFF;
+	}
+
+	//插入排序,相同配置保持原顺序
+	for(uint8_t i = 1; i < job->num; i++) {
+		uint8_t id = cur->order[i];
+		uint16_t key = SCAN_KEY(&job->list[id]);
+		int8_t j = i - 1;
+		while(j >= 0 && SCAN_KEY(&job->list[cur->order[j]]) > key) {
+			cur->order[j + 1] = cur->order[j];
+			j--;
+		}
+		cur->order[j + 1] = id;
+	}
+	return 0;
+}
+/**
+ * @brief  开始一次转换
+ * @note   单次模式触发转换,连续模式仅记录开始时间
+ */
+static uint8_t scan_convert(ads1015_t *dev, ads1015_mode_t mode, scan_cursor_t *cur)
+{
+	uint8_t ret = 0;
+
+	if(mode == SingleShot_Mode) {
+		ret = ads1015_conversions_trigger(dev);
+	}
+	cur->start = HAL_GetTick();
+	if(ret != 0) {
+		cur->done = true;
+	}
+	return ret;
+}
+/**
+ * @brief  开始当前扫描项
+ * @note   跳过采样点数为0的项;连续模式无转换完成信号时丢弃配置后首个结果
+ */
+static uint8_t scan_entry_start(const ads1015_job_t *job, ads1015_mode_t mode, scan_cursor_t *cur)
+{
+	while(cur->entry < job->num && job->list[cur->order[cur->entry]].samples == 0) {
+		cur->entry++;
+	}
+	if(cur->entry >= job->num) {
+		cur->done = true;
+		return 0;
+	}
+
+	const ads1015_scan_t *entry = &job->list[cur->order[cur->entry]];
+	uint8_t ret = ads1015_config(job->dev, entry->mux, mode, entry->fsr, entry->dr);
+	if(ret != 0) {
+		cur->done = true;
+		return ret;
+	}
+	cur->count = 0;
+	cur->n = 0;
+	cur->valid = 0;
+	cur->sum = 0;
+	cur->clip = false;
+	cur->discard = (mode == Continuous_Mode && job->dev->rdy != ADS1015_RDY_PIN);
+	return scan_convert(job->dev, mode, cur);
+}
+/**
+ * @brief  读取转换结果并推进扫描
+ * @note   转换完成后调用
+ */
+static uint8_t scan_step(const ads1015_job_t *job, ads1015_mode_t mode, scan_cursor_t *cur)
+{
+	uint8_t id = cur->order[cur->entry];
+	const ads1015_scan_t *entry = &job->list[id];
+	uint8_t oversample = (entry->oversample == 0) ? 1 : entry->oversample;
+	uint16_t raw = 0;
+
+	uint8_t ret = read_register(job->dev, Reg_Conversion, &raw);
+	if(cur->discard == true) {
+		cur->discard = false;
+		cur->start = HAL_GetTick();
+		return 0;
+	}
+	if(ret == 0) {
+		int16_t code = (int16_t)raw >> 4;
+		cur->sum += code;
+		cur->valid++;
+		cur->clip |= (code == CODE_POS_CLIP || code == CODE_NEG_CLIP);
+	}
+	if(++cur->n >= oversample) {
+		data_store(&job->data[cur->offset[id] + cur->count], cur->sum, cur->valid, cur->clip);
+		cur->count++;
+		cur->n = 0;
+		cur->valid = 0;
+		cur->sum = 0;
+		cur->clip = false;
+	}
+	if(cur->count >= entry->samples) {
+		cur->entry++;
+		return scan_entry_start(job, mode, cur);
+	}
+	return scan_convert(job->dev, mode, cur);
+}
+/**
+ * @brief  扫描列表采集
+ * @note   整个扫描持有一次总线锁,期间NFC等共用总线的访问被阻塞;
+ *         结果按列表原顺序连续存放于data,第i项起始位置为前i项samples之和
+ * @param  *dev: 实例
+ * @param  *list: 扫描列表
+ * @param  num: 列表项数,不超过ADS1015_SCAN_MAX
+ * @param  mode: 转换模式
+ * @param  *data: 结果缓冲区
+ * @param  size: 结果缓冲区数量
+ * @retval 0: 成功 其他: 失败
+ */
+uint8_t ads1015_scan(ads1015_t *dev, const ads1015_scan_t *list, uint8_t num, ads1015_mode_t mode,
+                     ads1015_data_t *data, uint16_t size)
+{
+	ads1015_job_t job = {
+		.dev = dev,
+		.list = list,
+		.num = num,
+		.data = data,
+		.size = size,
+	};
+	return ads1015_scan_multi(&job, 1, mode);
+}
+/**
+ * @brief  多实例交错扫描
+ * @note   各实例按各自列表独立推进,轮询转换完成状态,一个实例转换期间读取其他实例;
+ *         所有实例共用总线锁,整个扫描只加锁一次;同一实例不能出现在多个任务中
+ * @param  *job: 扫描任务,每个实例一个
+ * @param  num: 任务数,不超过ADS1015_JOB_MAX
+ * @param  mode: 转换模式
+ * @retval 0: 成功 其他: 首个失败的错误码
+ */
+uint8_t ads1015_scan_multi(const ads1015_job_t *job, uint8_t num, ads1015_mode_t mode)
+{
+	scan_cursor_t cur[ADS1015_JOB_MAX];
+	uint8_t ret = 0;
+	bool active = true;
+
+	if(job == NULL || num == 0 || num > ADS1015_JOB_MAX) {
+		return 0xFF;
+	}
+	for(uint8_t i = 0; i < num; i++) {
+		if(scan_prepare(&job[i], &cur[i]) != 0) {
+			return 0xFF;
+		}
+		for(uint8_t j = 0; j < i; j++) {
+			if(job[j].dev == job[i].dev) {
+				return 0xFF;
+			}
 		}
+	}
 
+	ntag_lock();
+	for(uint8_t i = 0; i < num; i++) {
+		job[i].dev->session = true;
+	}
+	for(uint8_t i = 0; i < num; i++) {
+		uint8_t err = scan_entry_start(&job[i], mode, &cur[i]);
 		if(ret == 0) {
-			data[count].value = (data[count].value >> 4);
-			data[count].succ  = true;
-		} else {
-			data[count].succ  = false;
+			ret = err;
 		}
 	}
-	
-	return 0;
+	while(active == true) {
+		active = false;
+		for(uint8_t i = 0; i < num; i++) {
+			if(cur[i].done == true) {
+				continue;
+			}
+			active = true;
+			if(conversion_ready(job[i].dev, cur[i].start) == true) {
+				uint8_t err = scan_step(&job[i], mode, &cur[i]);
+				if(ret == 0) {
+					ret = err;
+				}
+			}
+		}
+	}
+	for(uint8_t i = 0; i < num; i++) {
+		job[i].dev->session = false;
+	}
+	ntag_unlock();
+	return ret;
+}
+/**
+ * @brief  估计采样点噪声
+ * @note   模拟噪声足够抖动量化误差(>=0.5LSB)时量化噪声随平均下降,否则保持量化底噪
+ * @param  fsr: 量程
+ * @param  noise: 单次转换外部模拟噪声(LSB RMS)
+ * @param  dr: 数据率
+ * @param  oversample: 过采样次数
+ * @retval 噪声(LSB RMS)
+ */
+float ads1015_rate_noise(ads1015_fsr_t fsr, float noise, ads1015_dr_t dr, uint8_t oversample)
+{
+	float adc = s_dr_noise_uv[dr] / s_fsr_lsb_uv[fsr];
+	float analog = noise * noise + adc * adc;
+	float quant = 1.0f / 12;
+
+	if(oversample == 0) {
+		oversample = 1;
+	}
+	if(analog >= 0.25f) {
+		quant /= oversample;
+	}
+	return sqrtf(analog / oversample + quant);
+}
+/**
+ * @brief  估计采样点耗时
+ * @note   使用ALERT/RDY引脚或单次模式轮询时按转换周期计算,
+ *         其他情况按向上取整的固定延时加1个节拍计算,与conversion_ready一致
+ * @param  *dev: 实例
+ * @param  dr: 数据率
+ * @param  oversample: 过采样次数
+ * @retval 耗时(ms)
+ */
+float ads1015_rate_latency(ads1015_t *dev, ads1015_dr_t dr, uint8_t oversample)
+{
+	float period = 1000.0f / s_dr_sps[dr];
+
+	if(oversample == 0) {
+		oversample = 1;
+	}
+	if(dev->rdy == ADS1015_RDY_DELAY) {
+		period = rdy_delay(dev, dr) + 1;
+	}
+	return oversample * (period + XFER_MS);
+}
+/**
+ * @brief  按目标噪声与耗时选择数据率与过采样次数
+ * @note   满足目标噪声的组合中选耗时最短者;均不满足时选耗时限制内噪声最低者
+ * @param  *dev: 实例
+ * @param  fsr: 量程
+ * @param  noise: 单次转换外部模拟噪声(LSB RMS)
+ * @param  target: 每点目标噪声(LSB RMS)
+ * @param  latency: 每点耗时上限(ms)
+ * @param  *dr: 数据率
+ * @param  *oversample: 过采样次数
+ * @retval true: 满足目标噪声 false: 未满足
+ */
+bool ads1015_rate_select(ads1015_t *dev, ads1015_fsr_t fsr, float noise, float target, float latency,
+                         ads1015_dr_t *dr, uint8_t *oversample)
+{
+	bool found = false;
+	float best_t = 0;
+	float best_e = 0;
+
+	*dr = SPS_128;
+	*oversample = 1;
+	for(uint8_t d = SPS_128; d <= SPS_3300; d++) {
+		for(uint16_t n = 1; n <= ADS1015_OVERSAMPLE_MAX; n <<= 1) {
+			float t = ads1015_rate_latency(dev, (ads1015_dr_t)d, n);
+			float e = ads1015_rate_noise(fsr, noise, (ads1015_dr_t)d, n);
+			if(t > latency) {
+				continue;
+			}
+			if(e <= target) {
+				if(found == false || t < best_t) {
+					found = true;
+					best_t = t;
+					*dr = (ads1015_dr_t)d;
+					*oversample = n;
+				}
+			} else if(found == false && (best_e == 0 || e < best_e)) {
+				best_e = e;
+				*dr = (ads1015_dr_t)d;
+				*oversample = n;
+			}
+		}
+	}
+	return found;
 }
 
-void ads1015_test(void)
+void ads1015_test(ads1015_t *dev)
 {
 	ConfigReg_t reg;
 
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 
 	printf("===ads1015 read default begin===\r\n");
 	printf("===default config reg : 0x%04x\r\n", reg.value);
@@ -237,11 +857,12 @@ void ads1015_test(void)
 	reg.Bits.CompQue = 2;
 	reg.Bits.Pga     = 3;
 	reg.Bits.Mux     = 4;
-	write_register(Reg_Config, reg.value);
+	write_register(dev, Reg_Config, reg.value);
+	dev->config_valid = false;
 	printf("===set config reg : 0x%04x\r\n", reg.value);
 	reg.value = 0;
 
-	read_register(Reg_Config, &reg.value);
+	read_register(dev, Reg_Config, &reg.value);
 	printf("===current config reg : 0x%04x\r\n", reg.value);
 	printf("===comp_que = %d, comp_lat = %d, comp_pol = %d, comp_mode = %d\r\n", reg.Bits.CompQue, reg.Bits.CompLat, \
 	reg.Bits.CompPol, reg.Bits.CompMode);
@@ -47,6 +47,17 @@ typedef enum ads1015_dr_s {
 	SPS_3300,
 } ads1015_dr_t;
 
+/**
+ * @brief  转换完成等待方式
+ * @note   RDY_PIN: 比较器配置为ALERT/RDY转换完成信号,板级外部中断中调用ads1015_rdy_isr
+ *         RDY_POLL: 单次模式轮询配置寄存器OS位,连续模式无OS状态,按数据率超时等待
+ */
+typedef enum ads1015_rdy_s {
+	ADS1015_RDY_DELAY = 0,	//固定延时10ms
+	ADS1015_RDY_PIN,		//ALERT/RDY引脚中断
+	ADS1015_RDY_POLL,		//轮询OS位
+} ads1015_rdy_t;
+
 typedef union uConfigReg {
 	uint16_t value;
 	struct sBits
@@ -63,15 +74,88 @@ typedef union uConfigReg {
 	}Bits;	
 } ConfigReg_t;
 
+#define ADS1015_CONFIG_OS	(1u << 15)
+//配置寄存器编码,参数为常量时编译期计算
+#define ADS1015_CONFIG_ENCODE(mux, mode, fsr, dr)	\
+	((uint16_t)(((uint16_t)(mux) << 12) | ((uint16_t)(fsr) << 9) | ((uint16_t)(mode) << 8) | ((uint16_t)(dr) << 5)))
+
+#define ADS1015_OVERSAMPLE_MAX	64	//过采样次数上限
+#define ADS1015_SCAN_MAX		8	//扫描列表项数上限
+#define ADS1015_JOB_MAX			4	//交错扫描实例数上限
+
+//器件地址,由ADDR引脚连接决定,每条总线最多4片
+#define ADS1015_ADDR_GND		0x48
+#define ADS1015_ADDR_VDD		0x49
+#define ADS1015_ADDR_SDA		0x4A
+#define ADS1015_ADDR_SCL		0x4B
+
+/**
+ * @brief  ADS1015实例
+ * @note   由使用者静态定义,ads1015_init初始化;rdy由ads1015_rdy_set设置
+ */
+typedef struct ads1015_s {
+	I2c_t *i2c;					//I2C对象
+	uint8_t addr;				//器件地址
+	ads1015_mode_t mode;		//当前转换模式
+	uint16_t config;			//配置寄存器影子
+	bool config_valid;			//影子与器件一致
+	uint8_t pointer;			//器件指针寄存器当前值
+	ads1015_rdy_t rdy;			//转换完成等待方式
+	bool rdy_valid;				//阈值寄存器已配置为转换完成信号
+	volatile bool rdy_flag;		//转换完成中断标志
+	bool session;				//扫描期间已持有总线锁
+	uint32_t xfer_count;		//I2C传输次数
+} ads1015_t;
+
+typedef struct ads1015_scan_s {
+	ads1015_mux_t mux;		//通道
+	ads1015_fsr_t fsr;		//量程
+	ads1015_dr_t dr;		//数据率
+	uint8_t oversample;		//每点过采样次数
+	uint8_t samples;		//采样点数
+} ads1015_scan_t;
+
 typedef struct ads1015_data_s {
 	bool succ;
-	uint16_t value;
+	uint16_t value;		//12位补码,过采样时为均值取整
+	float mean;			//有符号码值均值
+	bool clip;			//存在满量程码值
 } ads1015_data_t;
 
-void ads1015_init(I2c_t *obj);
-uint8_t ads1015_config(ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, ads1015_dr_t dr);
-uint8_t ads1015_collect(uint8_t samples, ads1015_data_t *data);
-uint8_t ads1015_extend_collect(ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, uint8_t samples, ads1015_data_t *data);
-void ads1015_test(void);
+/**
+ * @brief  交错扫描任务
+ * @note   每个实例一个任务,data按list原顺序存放结果
+ */
+typedef struct ads1015_job_s {
+	ads1015_t *dev;					//实例
+	const ads1015_scan_t *list;		//扫描列表
+	uint8_t num;					//列表项数
+	ads1015_data_t *data;			//结果缓冲区
+	uint16_t size;					//结果缓冲区数量
+} ads1015_job_t;
+
+void ads1015_init(ads1015_t *dev, I2c_t *obj, uint8_t addr);
+uint8_t ads1015_config(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr, ads1015_dr_t dr);
+uint8_t ads1015_collect(ads1015_t *dev, uint8_t samples, ads1015_data_t *data);
+uint8_t ads1015_extend_collect(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr,
+                               uint8_t samples, ads1015_data_t *data);
+uint8_t ads1015_extend_collect_dr(ads1015_t *dev, ads1015_mux_t num, ads1015_mode_t mode, ads1015_fsr_t fsr,
+                                  ads1015_dr_t dr, uint8_t oversample, uint8_t samples, ads1015_data_t *data);
+uint8_t ads1015_scan(ads1015_t *dev, const ads1015_scan_t *list, uint8_t num, ads1015_mode_t mode,
+                     ads1015_data_t *data, uint16_t size);
+uint8_t ads1015_scan_multi(const ads1015_job_t *job, uint8_t num, ads1015_mode_t mode);
+float ads1015_rate_noise(ads1015_fsr_t fsr, float noise, ads1015_dr_t dr, uint8_t oversample);
+float ads1015_rate_latency(ads1015_t *dev, ads1015_dr_t dr, uint8_t oversample);
+bool ads1015_rate_select(ads1015_t *dev, ads1015_fsr_t fsr, float noise, float target, float latency,
+                        ads1015_dr_t *dr, uint8_t *oversample);
+void ads1015_test(ads1015_t *dev);
+uint32_t ads1015_xfer_count(ads1015_t *dev);
+void ads1015_session_begin(ads1015_t *dev);
+void ads1015_session_end(ads1015_t *dev);
+uint8_t ads1015_conversion_get(ads1015_t *dev, int16_t *code);
+uint8_t ads1015_power_down(ads1015_t *dev);
+void ads1015_rdy_set(ads1015_t *dev, ads1015_rdy_t rdy);
+void ads1015_rdy_isr(ads1015_t *dev);
+uint8_t ads1015_i2c_read_reg(I2c_t *obj, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t size);
 #endif
 
@@ -0,0 +1,280 @@
+/**
+ * ****************************************************************************
+ * @file ADS1015 连续采集
+ * @note 连续模式按指定数据率转换,由ALERT/RDY引脚中断或定时器中断调用ads1015_stream_isr
+ *       启动非阻塞读取,传输完成回调中调用ads1015_stream_rx_done写入环形缓冲区,消费者按块读取;
+ *       中断中不等待I2C传输,板级须实现ads1015_stream_rx_start,未实现时无法开始采集;
+ *       可选实现ads1015_stream_rx_abort,停止时终止超时未完成的读取;
+ *       采集期间持有总线锁,NFC等共用总线的访问被阻塞;
+ *       每个结果一次2字节读传输,400kHz下约70us,100kHz下约290us,SPS_3300需400kHz
+ * ****************************************************************************
+*/
+#include <math.h>
+#include <string.h>
+#include "ads1015_stream.h"
+#include "main.h"
+
+#define STREAM_PI               3.14159265f
+#define STREAM_STOP_TIMEOUT     2       //停止时等待进行中读取完成的超时(ms)
+
+/**
+ * @brief  启动非阻塞读取
+ * @note   板级实现,在中断中调用,须立即返回;使用HAL_I2C_Master_Receive_IT/DMA,
+ *         传输完成回调中调用ads1015_stream_rx_done(st, true),错误回调中调用ads1015_stream_rx_done(st, false);
+ *         弱引用,未实现时地址为空,ads1015_stream_start返回失败
+ * @param  *st: 采集流
+ * @param  *obj: I2C对象
+ * @param  addr: 器件地址
+ * @param  *data: 接收缓冲区
+ * @param  size: 接收长度
+ * @retval 0: 已启动 其他: 失败
+ */
+__weak uint8_t ads1015_stream_rx_start(ads1015_stream_t *st, I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size);
+/**
+ * @brief  终止非阻塞读取
+ * @note   板级可选实现,停止时读取超时未完成调用;使用HAL_I2C_Master_Abort_IT等,
+ *         返回0前须确保传输已结束且不再调用ads1015_stream_rx_done;
+ *         弱引用,未实现时地址为空,ads1015_stream_stop保持读取进行中并返回失败
+ * @param  *st: 采集流
+ * @param  *obj: I2C对象
+ * @param  addr: 器件地址
+ * @retval 0: 已终止 其他: 失败
+ */
+__weak uint8_t ads1015_stream_rx_abort(ads1015_stream_t *st, I2c_t *obj, uint8_t addr);
+
+/**
+ * @brief  开始连续采集
+ * @note   size须为2的幂且不超过32768;使用ALERT/RDY引脚时先ads1015_rdy_set(dev, ADS1015_RDY_PIN),
+ *         定时器驱动时定时周期不小于一个转换周期;板级未实现ads1015_stream_rx_start时返回失败
+ * @param  *st: 采集流
+ * @param  *dev: 实例
+ * @param  mux: 通道
+ * @param  fsr: 量程
+ * @param  dr: 数据率
+ * @param  *buf: 环形缓冲区
+ * @param  size: 缓冲区数量
+ * @retval true: 成功 false: 失败
+ */
+bool ads1015_stream_start(ads1015_stream_t *st, ads1015_t *dev, ads1015_mux_t mux, ads1015_fsr_t fsr,
+                          ads1015_dr_t dr, int16_t *buf, uint16_t size)
+{
+	if(st == NULL || dev == NULL || buf == NULL || size < 2 || size > 32768 || (size & (size - 1)) != 0) {
+		return false;
+	}
+	if(ads1015_stream_rx_start == NULL) {
+		return false;
+	}
+
+	memset(st, 0, sizeof(ads1015_stream_t));
+	st->dev = dev;
+	st->buf = buf;
+	st->mask = size - 1;
+	ads1015_session_begin(dev);
+	//读取一次使指针指向转换寄存器,之后每个结果只需一次读传输;首个结果可能为旧配置,丢弃
+	int16_t code = 0;
+	if(ads1015_config(dev, mux, Continuous_Mode, fsr, dr) != 0 || ads1015_conversion_get(dev, &code) != 0) {
+		ads1015_session_end(dev);
+		return false;
+	}
+	st->running = true;
+	return true;
+}
+/**
+ * @brief  停止连续采集
+ * @note   等待进行中的读取完成,超时后由ads1015_stream_rx_abort终止;器件进入掉电后释放总线锁,
+ *         缓冲区中未读数据保留;读取未完成且无法终止时保持总线锁与busy,待ads1015_stream_rx_done后再次调用
+ * @param  *st: 采集流
+ * @retval true: 已停止 false: 读取进行中,未停止
+ */
+bool ads1015_stream_stop(ads1015_stream_t *st)
+{
+	if(st == NULL || st->dev == NULL) {
+		return true;
+	}
+	st->running = false;
+	uint32_t start = HAL_GetTick();
+	while(st->busy == true && HAL_GetTick() - start < STREAM_STOP_TIMEOUT) {
+	}
+	if(st->busy == true) {
+		//传输仍占用总线,不可写入掉电配置
+		if(ads1015_stream_rx_abort == NULL || ads1015_stream_rx_abort(st, st->dev->i2c, st->dev->addr) != 0) {
+			return false;
+		}
+		st->busy = false;
+	}
+	ads1015_power_down(st->dev);
+	ads1015_session_end(st->dev);
+	st->dev = NULL;
+	return true;
+}
+/**
+ * @brief  采集中断处理
+ * @note   ALERT/RDY引脚下降沿或定时器中断中调用,启动一次转换结果读取后立即返回;
+ *         上次读取未完成时本次转换计入late
+ */
+void ads1015_stream_isr(ads1015_stream_t *st)
+{
+	if(st == NULL || st->running == false) {
+		return;
+	}
+	if(st->busy == true) {
+		st->late++;
+		return;
+	}
+	st->busy = true;
+	st->dev->xfer_count++;
+	if(ads1015_stream_rx_start(st, st->dev->i2c, st->dev->addr, st->rx, sizeof(st->rx)) != 0) {
+		st->busy = false;
+		st->error++;
+	}
+}
+/**
+ * @brief  读取完成处理
+ * @note   I2C传输完成或错误回调中调用,转换结果写入环形缓冲区
+ * @param  *st: 采集流
+ * @param  ok: true: 传输成功 false: 传输失败
+ */
+void ads1015_stream_rx_done(ads1015_stream_t *st, bool ok)
+{
+	if(st == NULL || st->busy == false) {
+		return;
+	}
+	if(ok == false) {
+		st->error++;
+		st->busy = false;
+		return;
+	}
+	int16_t code = (int16_t)((st->rx[0] << 8) | st->rx[1]) >> 4;
+	st->busy = false;
+	uint16_t head = st->head;
+	if((uint16_t)(head - st->tail) > st->mask) {
+		st->overrun++;
+		return;
+	}
+	st->buf[head & st->mask] = code;
+	//数据写入后再更新写位置
+	st->head = head + 1;
+	st->count++;
+}
+/**
+ * @brief  获取可读数量
+ */
+uint16_t ads1015_stream_available(const ads1015_stream_t *st)
+{
+	return (uint16_t)(st->head - st->tail);
+}
+/**
+ * @brief  读取数据
+ * @param  *st: 采集流
+ * @param  *data: 读取数据
+ * @param  num: 最大读取数量
+ * @retval 实际读取数量
+ */
+uint16_t ads1015_stream_read(ads1015_stream_t *st, int16_t *data, uint16_t num)
+{
+	uint16_t tail = st->tail;
+	uint16_t avail = (uint16_t)(st->head - tail);
+
+	if(num > avail) {
+		num = avail;
+	}
+	//分两段拷贝,处理回绕
+	uint16_t pos = tail & st->mask;
+	uint16_t first = st->mask + 1 - pos;
+	if(first > num) {
+		first = num;
+	}
+	memcpy(data, &st->buf[pos], first * sizeof(int16_t));
+	memcpy(&data[first], st->buf, (num - first) * sizeof(int16_t));
+	//数据读出后再释放空间
+	st->tail = tail + num;
+	return num;
+}
+/**
+ * @brief  读取数据块
+ * @note   可读数量不足num时不读取
+ * @retval true: 读取成功 false: 数据不足
+ */
+bool ads1015_stream_block(ads1015_stream_t *st, int16_t *data, uint16_t num)
+{
+	if(ads1015_stream_available(st) < num) {
+		return false;
+	}
+	ads1015_stream_read(st, data, num);
+	return true;
+}
+/**
+ * @brief  数据块统计
+ * @note   整数累加,单次遍历
+ * @param  *data: 数据块
+ * @param  num: 数量
+ * @param  *stats: 统计结果
+ */
+void ads1015_stream_stats(const int16_t *data, uint16_t num, ads1015_stream_stats_t *stats)
+{
+	int32_t sum = 0;
+	int64_t sq = 0;
+
+	memset(stats, 0, sizeof(ads1015_stream_stats_t));
+	if(num == 0) {
+		return;
+	}
+	stats->min = data[0];
+	stats->max = data[0];
+	for(uint16_t i = 0; i < num; i++) {
+		int16_t v = data[i];
+		if(v < stats->min) {
+			stats->min = v;
+		} else if(v > stats->max) {
+			stats->max = v;
+		}
+		sum += v;
+		sq += (int32_t)v * v;
+	}
+	stats->mean = (float)sum / num;
+	float ms = (float)sq / num;
+	stats->rms = sqrtf(ms);
+	float var = ms - stats->mean * stats->mean;
+	stats->ac_rms = (var > 0) ? sqrtf(var) : 0;
+}
+/**
+ * @brief  生成Hann窗系数
+ * @note   初始化时计算一次,避免每块重复计算三角函数
+ * @param  *window: 窗系数
+ * @param  num: 窗长度
+ */
+void ads1015_stream_hann(float *window, uint16_t num)
+{
+	if(num < 2) {
+		if(num == 1) {
+			window[0] = 1.0f;
+		}
+		return;
+	}
+	for(uint16_t i = 0; i < num; i++) {
+		window[i] = 0.5f - 0.5f * cosf(2 * STREAM_PI * i / (num - 1));
+	}
+}
+/**
+ * @brief  数据块加窗
+ * @note   去均值后乘窗系数,输出可直接作为FFT实数输入
+ * @param  *data: 数据块
+ * @param  *window: 窗系数,长度与数据块相同
+ * @param  num: 数量
+ * @param  *out: 加窗结果
+ */
+void ads1015_stream_window(const int16_t *data, const float *window, uint16_t num, float *out)
+{
+	int32_t sum = 0;
+
+	if(num == 0) {
+		return;
+	}
+	for(uint16_t i = 0; i < num; i++) {
+		sum += data[i];
+	}
+	float mean = (float)sum / num;
+	for(uint16_t i = 0; i < num; i++) {
+		out[i] = (data[i] - mean) * window[i];
+	}
+}
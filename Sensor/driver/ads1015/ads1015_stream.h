@@ -0,0 +1,52 @@
+#ifndef __ADS1015_STREAM_H__
+#define __ADS1015_STREAM_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include "ads1015.h"
+
+/**
+ * @brief  连续采集流
+ * @note   单生产者单消费者环形缓冲区:head仅由ads1015_stream_rx_done写入,tail仅由消费者写入,
+ *         无需关中断;缓冲区满时丢弃新数据并计入overrun
+ */
+typedef struct ads1015_stream_s {
+	ads1015_t *dev;				//实例
+	int16_t *buf;				//环形缓冲区,有符号码值
+	uint16_t mask;				//缓冲区数量-1
+	volatile uint16_t head;		//写位置
+	volatile uint16_t tail;		//读位置
+	volatile uint32_t overrun;	//缓冲区满丢弃数量
+	volatile uint32_t error;	//I2C读取失败数量
+	volatile uint32_t late;		//上次读取未完成时到达的转换数量
+	volatile uint32_t count;	//已写入数量
+	volatile bool running;		//采集中
+	volatile bool busy;			//非阻塞读取进行中
+	uint8_t rx[2];				//非阻塞读取缓冲区
+} ads1015_stream_t;
+
+/**
+ * @brief  数据块统计
+ * @note   单位为码值,乘以量程LSB换算为电压
+ */
+typedef struct ads1015_stream_stats_s {
+	int16_t min;		//最小值
+	int16_t max;		//最大值
+	float mean;			//均值
+	float rms;			//均方根
+	float ac_rms;		//去均值后均方根
+} ads1015_stream_stats_t;
+
+bool ads1015_stream_start(ads1015_stream_t *st, ads1015_t *dev, ads1015_mux_t mux, ads1015_fsr_t fsr,
+                          ads1015_dr_t dr, int16_t *buf, uint16_t size);
+bool ads1015_stream_stop(ads1015_stream_t *st);
+void ads1015_stream_isr(ads1015_stream_t *st);
+void ads1015_stream_rx_done(ads1015_stream_t *st, bool ok);
+uint8_t ads1015_stream_rx_start(ads1015_stream_t *st, I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size);
+uint8_t ads1015_stream_rx_abort(ads1015_stream_t *st, I2c_t *obj, uint8_t addr);
+uint16_t ads1015_stream_available(const ads1015_stream_t *st);
+uint16_t ads1015_stream_read(ads1015_stream_t *st, int16_t *data, uint16_t num);
+bool ads1015_stream_block(ads1015_stream_t *st, int16_t *data, uint16_t num);
+void ads1015_stream_stats(const int16_t *data, uint16_t num, ads1015_stream_stats_t *stats);
+void ads1015_stream_hann(float *window, uint16_t num);
+void ads1015_stream_window(const int16_t *data, const float *window, uint16_t num, float *out);
+#endif
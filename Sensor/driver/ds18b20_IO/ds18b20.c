@@ -14,8 +14,10 @@
 /* Includes ------------------------------------------------------------------*/
 #include "ds18b20.h"
 /* Private includes ----------------------------------------------------------*/
+#include <string.h>
 #include "node_crc.h"
 #include "critical_platform.h"
+#include "sensor_time.h"
 /* Private typedef -----------------------------------------------------------*/
 
 /* Private define ------------------------------------------------------------*/
@@ -32,9 +34,15 @@
 #define DS18B20_CMD_COPY_SCRPAD     0X48    //复制暂存器
 #define DS18B20_CMD_RECALL_E2       0XB8    //EEPROM数据回收
 #define DS18B20_CMD_READ_POWER      0XB4    //读取电源
+
+#define DS18B20_FAMILY_CODE         0X28    //DS18B20家族码
+#define DS18B20_SCRPAD_LEN          9       //暂存器长度
+#define DS18B20_POLL_MS             2       //转换完成轮询间隔(ms)
+#define DS18B20_COPY_MS             10      //复制暂存器到EEPROM时间(ms)
 /* Private macro -------------------------------------------------------------*/
 #define DS18B20_DELAY_US(x)   for(volatile uint32_t i = 0; i < x; i++);//DelayUs（1） 为2.6us
 #define DS18B20_DELAY_MS(ms)  HAL_Delay(ms)
+#define DS18B20_CFG_REG(res)  (((res) << 5) | 0x1F)  //配置寄存器,R1R0位于bit6:5
 //DS18B20 函数宏定义
 #define DS18B20_DQ_0     dq->GPIOx->BRR = (uint32_t)dq->GPIO_Pin;
 #define DS18B20_DQ_1     dq->GPIOx->BSRR = (uint32_t)dq->GPIO_Pin;
@@ -222,41 +230,48 @@ static uint8_t DS18B20_ReadByte(ds18b20_dq_t *dq)
     return dat;
 }
 /**
- * @brief  写一个字节到DS18B20，低位先行
+ * @brief  写一个bit到DS18B20
  * @note   存在阻塞延时63us
  * @param  *dq: 传感器引脚
- * @param  dat: 要写入的数据
+ * @param  bit: 要写入的数据
  * @retval None
  */
-static void DS18B20_WriteByte(ds18b20_dq_t *dq, uint8_t dat)
+static void DS18B20_WriteBit(ds18b20_dq_t *dq, uint8_t bit)
 {
-    uint8_t testb;
     DS18B20_Mode_Out_PP(dq);
+    /* 写0和写1的时间至少要大于60us */
+    if (bit) {
+        //总线控制器要写产生一个写时序，必须把数据线拉到低电平然后释放，且需在 15us 内释放总线。
+        DS18B20_DQ_0;
+        /* 1us < 这个延时 < 15us */
+        DS18B20_DELAY_US(3);
 
-    for(uint8_t i = 0; i < 8; i++) {
+        DS18B20_DQ_1;
+        //总线控制器初始化写时序后，DS18B20 在一个 15us 到 60us 的窗口内对信号线进行采用。如果线上是高电平，就是写 1。反之，如果线上是低电平，就是写 0
+        DS18B20_DELAY_US(60);
+    } else {
+        DS18B20_DQ_0;
+        /* 60us < Tx 0 < 120us */
+        //总线控制器要生成写 0 时序，必须把数据线拉到低电平且继续保持至少 60us。
+        DS18B20_DELAY_US(61);
 
-        testb = dat & 0x01;
+        DS18B20_DQ_1;
+        /* 1us < Trec(恢复时间) < 无穷大*/
+        DS18B20_DELAY_US(2);
+    }
+}
+/**
+ * @brief  写一个字节到DS18B20，低位先行
+ * @note   存在阻塞延时63us/bit
+ * @param  *dq: 传感器引脚
+ * @param  dat: 要写入的数据
+ * @retval None
+ */
+static void DS18B20_WriteByte(ds18b20_dq_t *dq, uint8_t dat)
+{
+    for(uint8_t i = 0; i < 8; i++) {
+        DS18B20_WriteBit(dq, dat & 0x01);
         dat = dat >> 1;
-        /* 写0和写1的时间至少要大于60us */
-        if (testb) {
-            //总线控制器要写产生一个写时序，必须把数据线拉到低电平然后释放，且需在 15us 内释放总线。
-            DS18B20_DQ_0;
-            /* 1us < 这个延时 < 15us */
-            DS18B20_DELAY_US(3);
-
-            DS18B20_DQ_1;
-            //总线控制器初始化写时序后，DS18B20 在一个 15us 到 60us 的窗口内对信号线进行采用。如果线上是高电平，就是写 1。反之，如果线上是低电平，就是写 0
-            DS18B20_DELAY_US(60);
-        } else {
-            DS18B20_DQ_0;
-            /* 60us < Tx 0 < 120us */
-            //总线控制器要生成写 0 时序，必须把数据线拉到低电平且继续保持至少 60us。
-            DS18B20_DELAY_US(61);
-
-            DS18B20_DQ_1;
-            /* 1us < Trec(恢复时间) < 无穷大*/
-            DS18B20_DELAY_US(2);
-        }
     }
 }
 /**
@@ -272,6 +287,77 @@ static bool DS18B20_SkipRom(ds18b20_dq_t *dq)
     DS18B20_WriteByte(dq, DS18B20_CMD_SKIP_ROM);
     return true;
 }
+/**
+ * @brief  匹配 DS18B20 ROM
+ * @note   存在阻塞延时约5.7ms
+ * @param  dq: 传感器引脚
+ * @param  *rom: ROM编码,NULL时跳过匹配
+ * @retval 无
+ */
+static bool DS18B20_MatchRom(ds18b20_dq_t *dq, const uint8_t *rom)
+{
+    if(rom == NULL) {
+        return DS18B20_SkipRom(dq);
+    }
+    DS18B20_Rst(dq);
+    DS18B20_DELAY_US(400);
+    DS18B20_WriteByte(dq, DS18B20_CMD_MATCH_ROM);
+    for(uint8_t i = 0; i < DS18B20_ROM_LEN; i++) {
+        DS18B20_WriteByte(dq, rom[i]);
+    }
+    return true;
+}
+/**
+ * @brief  搜索ROM一次遍历
+ * @note   存在阻塞延时约13ms;每一位读取位与补码位,
+ *         两者不同时所有设备该位相同,相同时存在分歧:小于上次分歧位置沿用上次路径,等于时走1分支,大于时走0分支
+ * @param  dq: 传感器引脚
+ * @param  *rom: 输入上次搜索结果,输出本次搜索结果
+ * @param  last: 上次最后一个走0分支的分歧位置,0表示首次搜索
+ * @retval 本次最后一个走0分支的分歧位置,0表示已搜索完成;-1:无设备或总线错误
+ */
+static int8_t DS18B20_SearchPass(ds18b20_dq_t *dq, uint8_t *rom, int8_t last)
+{
+    int8_t last_zero = 0;
+
+    DS18B20_Mode_Out_PP(dq);
+    DS18B20_DQ_1;
+    DS18B20_Rst(dq);
+    if(DS18B20_Presence(dq) != 0) {
+        return -1;
+    }
+    DS18B20_DELAY_US(400);
+    DS18B20_WriteByte(dq, DS18B20_CMD_SEARCH_ROM);
+    for(int8_t n = 1; n <= DS18B20_ROM_LEN * 8; n++) {
+        uint8_t mask = 1 << ((n - 1) & 0x07);
+        uint8_t *byte = &rom[(n - 1) >> 3];
+        uint8_t bit = DS18B20_ReadBit(dq);
+        uint8_t cmp = DS18B20_ReadBit(dq);
+        uint8_t dir = 0;
+
+        if(bit == 1 && cmp == 1) {
+            return -1;
+        } else if(bit != cmp) {
+            dir = bit;
+        } else {
+            if(n < last) {
+                dir = ((*byte & mask) != 0);
+            } else {
+                dir = (n == last);
+            }
+            if(dir == 0) {
+                last_zero = n;
+            }
+        }
+        if(dir) {
+            *byte |= mask;
+        } else {
+            *byte &= ~mask;
+        }
+        DS18B20_WriteBit(dq, dir);
+    }
+    return last_zero;
+}
 /**
  * @brief 计算温度值
  * 
@@ -302,17 +388,69 @@ float caculate_temp(uint8_t tmh, uint8_t tml)
     return temp;
 }
 /**
- * @brief  在跳过匹配 ROM 情况下获取 DS18B20 温湿度度值
- * @note   存在阻塞延时7562us
+ * @brief  搜索总线上的DS18B20
+ * @note   每个设备一次遍历,存在阻塞延时约13ms/个;CRC错误或非DS18B20的设备被丢弃
  * @param  dq: 传感器引脚
- * @param  temperature: 温度值
- * @retval 读取是否成功 1：成功;0：失败
+ * @param  rom: ROM编码存储
+ * @param  max: 最大搜索数量
+ * @retval 搜索到的设备数量
+ */
+uint8_t DS18B20_Search(ds18b20_dq_t *dq, uint8_t (*rom)[DS18B20_ROM_LEN], uint8_t max)
+{
+    uint8_t id[DS18B20_ROM_LEN] = {0};
+    uint8_t num = 0;
+    int8_t last = 0;
+
+    do {
+        NODE_CRITICAL_SECTION_BEGIN();
+        last = DS18B20_SearchPass(dq, id, last);
+        NODE_CRITICAL_SECTION_END();
+        if(last < 0) {
+            break;
+        }
+        if(crc8_maxim(id, DS18B20_ROM_LEN - 1) == id[DS18B20_ROM_LEN - 1]
+        && id[0] == DS18B20_FAMILY_CODE) {
+            memcpy(rom[num++], id, DS18B20_ROM_LEN);
+        }
+    } while(last != 0 && num < max);
+
+    return num;
+}
+/**
+ * @brief  读取暂存器
+ * @note   存在阻塞延时约10ms
+ * @param  dq: 传感器引脚
+ * @param  *rom: ROM编码,NULL时跳过匹配
+ * @param  *reg: 暂存器9字节
+ * @retval DS18B20_ERR_OK: 成功 DS18B20_ERR_CRC: CRC校验错误
+ */
+static ds18b20_err_t DS18B20_ReadScratchpad(ds18b20_dq_t *dq, const uint8_t *rom, uint8_t *reg)
+{
+{
+    NODE_CRITICAL_SECTION_BEGIN();
+    DS18B20_MatchRom(dq, rom);
+    DS18B20_WriteByte(dq, DS18B20_CMD_READ_SCRPAD);
+    for(uint8_t i = 0; i < DS18B20_SCRPAD_LEN; i++) {
+        reg[i] = DS18B20_ReadByte(dq);
+    }
+    NODE_CRITICAL_SECTION_END();
+}
+    if(crc8_maxim(reg, DS18B20_SCRPAD_LEN - 1) != reg[DS18B20_SCRPAD_LEN - 1]) {
+        return DS18B20_ERR_CRC;
+    }
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief  总线上所有DS18B20开始温度转换
+ * @note   跳过ROM广播转换命令,读时隙轮询转换完成:转换中设备返回0,全部完成后返回1;
+ *         多个设备时按最高分辨率确定超时
+ * @param  dq: 传感器引脚
+ * @param  res: 分辨率,确定最大转换时间
+ * @retval DS18B20_ERR_OK: 成功 DS18B20_ERR_TIMEOUT: 转换超时或截止时间到达
  */
-bool DS18B20_GetTemp_SkipRom(ds18b20_dq_t *dq, float *temperature)
+ds18b20_err_t DS18B20_Convert(ds18b20_dq_t *dq, ds18b20_res_t res)
 {
-    uint8_t tpmsb = 0, tplsb = 0, crc = 0;
-    uint8_t reg[9] = {0};
-    uint8_t crc_data = 0;
+    uint8_t done = 0;
 
 {
     NODE_CRITICAL_SECTION_BEGIN();
@@ -320,26 +458,102 @@ bool DS18B20_GetTemp_SkipRom(ds18b20_dq_t *dq, float *temperature)
     DS18B20_WriteByte(dq, DS18B20_CMD_CONVERT_T); /* 开始转换 */
     NODE_CRITICAL_SECTION_END();
 }
-    //DQ信号至少保持500ms高电平，以确保转换完成
-    DS18B20_DELAY_MS(750);
+    uint32_t start = sensor_time_get();
+    do {
+        DS18B20_DELAY_MS(DS18B20_POLL_MS);
+        NODE_CRITICAL_SECTION_BEGIN();
+        done = DS18B20_ReadBit(dq);
+        NODE_CRITICAL_SECTION_END();
+        //总线时序在临界区内无法检查,仅在轮询间隔检查截止时间
+        if(sensor_deadline_expired() == true) {
+            return DS18B20_ERR_TIMEOUT;
+        }
+    } while(done == 0 && sensor_time_age(start) < DS18B20_CONV_MS(res));
+
+    return (done != 0) ? DS18B20_ERR_OK : DS18B20_ERR_TIMEOUT;
+}
+/**
+ * @brief  设置分辨率
+ * @note   先读取暂存器,配置相同时不写入,避免EEPROM重复擦写;
+ *         不同时保留报警阈值写入配置寄存器,校验后复制到EEPROM,掉电保持
+ * @param  dq: 传感器引脚
+ * @param  *rom: ROM编码,NULL时跳过匹配,总线上仅允许一个设备
+ * @param  res: 分辨率
+ * @retval DS18B20_ERR_OK: 成功 DS18B20_ERR_CRC: 读取暂存器CRC校验错误 DS18B20_ERR_WRITE: 回读配置不一致
+ */
+ds18b20_err_t DS18B20_SetResolution(ds18b20_dq_t *dq, const uint8_t *rom, ds18b20_res_t res)
+{
+    uint8_t reg[DS18B20_SCRPAD_LEN] = {0};
+    uint8_t cfg = DS18B20_CFG_REG(res);
+
+    ds18b20_err_t ret = DS18B20_ReadScratchpad(dq, rom, reg);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    if(reg[4] == cfg) {
+        return DS18B20_ERR_OK;
+    }
 {
     NODE_CRITICAL_SECTION_BEGIN();
-    DS18B20_SkipRom(dq);
-    DS18B20_WriteByte(dq, DS18B20_CMD_READ_SCRPAD); /* 读温度值 */
-    for(uint8_t i = 0; i < 9; i++) {
-        reg[i] = DS18B20_ReadByte(dq);
+    DS18B20_MatchRom(dq, rom);
+    DS18B20_WriteByte(dq, DS18B20_CMD_WRITE_SCRPAD);
+    DS18B20_WriteByte(dq, reg[2]);  //TH
+    DS18B20_WriteByte(dq, reg[3]);  //TL
+    DS18B20_WriteByte(dq, cfg);
+    NODE_CRITICAL_SECTION_END();
+}
+    ret = DS18B20_ReadScratchpad(dq, rom, reg);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    if(reg[4] != cfg) {
+        return DS18B20_ERR_WRITE;
     }
+{
+    NODE_CRITICAL_SECTION_BEGIN();
+    DS18B20_MatchRom(dq, rom);
+    DS18B20_WriteByte(dq, DS18B20_CMD_COPY_SCRPAD);
     NODE_CRITICAL_SECTION_END();
 }
-    tplsb   = reg[0];
-    tpmsb   = reg[1];
-    crc     = reg[8];
+    //EEPROM写入期间保持总线高电平
+    DS18B20_DELAY_MS(DS18B20_COPY_MS);
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief  读取指定 DS18B20 温度值
+ * @note   读取已完成转换的暂存器,存在阻塞延时约10ms;低分辨率时未定义的低位清零
+ * @param  dq: 传感器引脚
+ * @param  *rom: ROM编码,NULL时跳过匹配,总线上仅允许一个设备
+ * @param  temperature: 温度值
+ * @retval DS18B20_ERR_OK: 成功 DS18B20_ERR_CRC: CRC校验错误
+ */
+ds18b20_err_t DS18B20_ReadTemp(ds18b20_dq_t *dq, const uint8_t *rom, float *temperature)
+{
+    uint8_t reg[DS18B20_SCRPAD_LEN] = {0};
 
-    crc_data = crc8_maxim(reg, sizeof(reg) - 1);
-    if(crc_data != crc) {
-        return false;
-    } else {
-        *temperature = caculate_temp(tpmsb, tplsb);
-        return true;
+    ds18b20_err_t ret = DS18B20_ReadScratchpad(dq, rom, reg);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
     }
-}
\ No newline at end of file
+    uint8_t res = (reg[4] >> 5) & 0x03;
+    uint8_t tplsb = reg[0] & (uint8_t)~((1 << (DS18B20_RES_12BIT - res)) - 1);
+    uint8_t tpmsb = reg[1];
+
+    *temperature = caculate_temp(tpmsb, tplsb);
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief  在跳过匹配 ROM 情况下获取 DS18B20 温湿度度值
+ * @note   分辨率未知,按12位最大转换时间超时
+ * @param  dq: 传感器引脚
+ * @param  temperature: 温度值
+ * @retval DS18B20_ERR_OK: 成功 其他: 错误码
+ */
+ds18b20_err_t DS18B20_GetTemp_SkipRom(ds18b20_dq_t *dq, float *temperature)
+{
+    ds18b20_err_t ret = DS18B20_Convert(dq, DS18B20_RES_12BIT);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    return DS18B20_ReadTemp(dq, NULL, temperature);
+}
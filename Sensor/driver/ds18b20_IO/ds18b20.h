@@ -23,10 +23,29 @@ extern "C" {
 #include <stdbool.h>
 #include <stm32wlxx.h>
 /* Exported constants --------------------------------------------------------*/
-
+typedef enum
+{
+    DS18B20_ERR_OK = 0,     //无错误
+    DS18B20_ERR_CRC,        //CRC校验错误
+    DS18B20_ERR_TIMEOUT,    //超时
+    DS18B20_ERR_WRITE,      //写入错误
+}ds18b20_err_t;
 /* Exported macro ------------------------------------------------------------*/
+#define DS18B20_ROM_LEN     8   //ROM编码长度:家族码+48位序列号+CRC
+#define DS18B20_CONV_MS(res) (94U << (res))  //最大转换时间(ms),手册值93.75/187.5/375/750
 
 /* Exported types ------------------------------------------------------------*/
+/**
+ * @brief  温度分辨率
+ * @note   分辨率0.5/0.25/0.125/0.0625℃
+ */
+typedef enum
+{
+    DS18B20_RES_9BIT = 0,
+    DS18B20_RES_10BIT,
+    DS18B20_RES_11BIT,
+    DS18B20_RES_12BIT,
+}ds18b20_res_t;
 typedef struct{
     GPIO_TypeDef    *GPIOx;
     uint32_t        GPIO_Pin;
@@ -37,7 +56,11 @@ typedef struct{
 /* Exported functions prototypes ---------------------------------------------*/
 void DS18B20_GPIO_Config(ds18b20_dq_t *dq);
 int8_t DS18B20_Init(ds18b20_dq_t *dq);
-bool DS18B20_GetTemp_SkipRom(ds18b20_dq_t *dq, float *temperature);
+ds18b20_err_t DS18B20_GetTemp_SkipRom(ds18b20_dq_t *dq, float *temperature);
+uint8_t DS18B20_Search(ds18b20_dq_t *dq, uint8_t (*rom)[DS18B20_ROM_LEN], uint8_t max);
+ds18b20_err_t DS18B20_Convert(ds18b20_dq_t *dq, ds18b20_res_t res);
+ds18b20_err_t DS18B20_SetResolution(ds18b20_dq_t *dq, const uint8_t *rom, ds18b20_res_t res);
+ds18b20_err_t DS18B20_ReadTemp(ds18b20_dq_t *dq, const uint8_t *rom, float *temperature);
 
 #ifdef __cplusplus
 }
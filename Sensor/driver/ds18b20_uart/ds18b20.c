@@ -13,10 +13,14 @@
 /* Includes ------------------------------------------------------------------*/
 #include "ds18b20.h"
 /* Private includes ----------------------------------------------------------*/
+#include <string.h>
+#include "sensor_time.h"
+#include "cmsis_os.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
 /* Private macro -------------------------------------------------------------*/
+#define DS18B20_CFG_REG(res)        (((res) << 5) | 0x1F)  //配置寄存器,R1R0位于bit6:5
 
 /* Private define ------------------------------------------------------------*/
 #define WAIT_TIMEOUT_COUNT          1500    //接收等待超时计数 [测试调试值]
@@ -34,6 +38,12 @@
 #define DS18B20_CMD_RECALL_E2       0XB8    //EEPROM数据回收
 #define DS18B20_CMD_READ_POWER      0XB4    //读取电源
 
+#define DS18B20_FAMILY_CODE         0X28    //DS18B20家族码
+#define DS18B20_SCRPAD_LEN          9       //暂存器长度
+#define DS18B20_POLL_MS             2       //转换完成轮询间隔(ms)
+#define DS18B20_COPY_MS             10      //复制暂存器到EEPROM时间(ms)
+#define DS18B20_TXN_TIMEOUT_MS      50      //DMA事务超时(ms),最长事务160个时隙约14ms
+
 #define WIRE_0                      0x00    //写入0
 #define WIRE_1                      0xff    //写入1
 /*  读脉冲中，串口发送数据0xff，起始位实现读脉冲时序的启动，LSB为1，
@@ -96,6 +106,20 @@ static void usart_setup(ds18b20_t *dev,uint32_t baud)
         Error_Handler();
     }
 }
+/**
+ * @brief 操作结束释放串口
+ * 
+ * 轮询模式释放串口;DMA模式事务之间保持串口与DMA初始化,避免每次操作重新初始化DMA,
+ * 由ds18b20_release在总线关闭时释放
+ */
+static void uart_release(ds18b20_t *dev)
+{
+#if (DS18B20_USE_DMA == 0)
+    HAL_UART_DeInit(dev->huart);
+#else
+    (void)dev;
+#endif /* (DS18B20_USE_DMA == 0) */
+}
 /**
  * @brief 将一个字节转换为位数组
  * 
@@ -115,6 +139,25 @@ static void byte_to_bits(uint8_t ow_byte, uint8_t *bits)
         ow_byte = ow_byte >> 1;
     }
 }
+/**
+ * @brief  单总线一个位时序
+ * @note   写1时隙与读时隙相同,回读数据为总线实际电平
+ * @param  bit: 写入的位
+ * @param  *rx: 回读的位
+ */
+static ds18b20_err_t one_wire_bit(UART_HandleTypeDef *uart, uint8_t bit, uint8_t *rx)
+{
+    uint16_t pause = WAIT_TIMEOUT_COUNT;
+    uart->Instance->TDR = bit ? WIRE_1 : WIRE_0;
+    //等待接收完成
+    while(__HAL_UART_GET_FLAG(uart, UART_FLAG_RXNE) == false && --pause);
+    if(pause == 0) {
+        return DS18B20_ERR_TIMEOUT;
+    }
+    *rx = (uart->Instance->RDR == WIRE_1);
+    return DS18B20_ERR_OK;
+}
+#if (DS18B20_USE_DMA == 0)
 /**
  * @brief  接收数据
  * 
@@ -142,6 +185,7 @@ static ds18b20_err_t one_wire_read(UART_HandleTypeDef *uart, uint8_t *byte)
     }
     return DS18B20_ERR_OK;
 }
+#endif /* (DS18B20_USE_DMA == 0) */
 /**
  * @brief 发送一个字节的数据到单总线设备
  * 
@@ -196,66 +240,467 @@ ds18b20_err_t ds18b20_reset(ds18b20_t *dev)
         return DS18B20_ERR_NO_DEV1;
     }
 }
+#if (DS18B20_USE_DMA == 0)
 /**
- * @brief 通过跳过ROM地址获取温度值
- * @param temperature 存储温度值的指针
- * @return 获取温度值成功返回true，否则返回false
+ * @brief 复位并选择设备
+ * 
+ * @param rom ROM编码,NULL时跳过ROM
  */
-ds18b20_err_t ds18b20_get_temp_skiprom(ds18b20_t *dev, float *temperature)
+static ds18b20_err_t match_rom(ds18b20_t *dev, const uint8_t *rom)
 {
-    uint8_t reg[9] = {0};
-    ds18b20_err_t ret = DS18B20_ERR_OK;
+    if(ds18b20_reset(dev) != DS18B20_ERR_OK) {
+        return DS18B20_ERR_NO_DEV1;
+    }
+    if(rom == NULL) {
+        if(one_wire_send_byte(dev->huart, DS18B20_CMD_SKIP_ROM) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_WRITE;
+        }
+        return DS18B20_ERR_OK;
+    }
+    if(one_wire_send_byte(dev->huart, DS18B20_CMD_MATCH_ROM) != DS18B20_ERR_OK) {
+        return DS18B20_ERR_WRITE;
+    }
+    for (uint8_t i = 0; i < DS18B20_ROM_LEN; i++) {
+        if(one_wire_send_byte(dev->huart, rom[i]) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_WRITE;
+        }
+    }
+    return DS18B20_ERR_OK;
+}
+#endif /* (DS18B20_USE_DMA == 0) */
+/**
+ * @brief 搜索ROM一次遍历
+ * 
+ * 每一位读取位与补码位,两者不同时所有设备该位相同;
+ * 相同时存在分歧:小于上次分歧位置沿用上次路径,等于时走1分支,大于时走0分支
+ * @param rom 输入上次搜索结果,输出本次搜索结果
+ * @param last 上次最后一个走0分支的分歧位置,0表示首次搜索;输出本次位置,0表示已搜索完成
+ */
+static ds18b20_err_t search_pass(ds18b20_t *dev, uint8_t *rom, uint8_t *last)
+{
+    uint8_t last_zero = 0;
 
     if(ds18b20_reset(dev) != DS18B20_ERR_OK) {
-        ret = DS18B20_ERR_NO_DEV1;
-        goto exit;
+        return DS18B20_ERR_NO_DEV1;
     }
-    if(one_wire_send_byte(dev->huart, DS18B20_CMD_SKIP_ROM) != DS18B20_ERR_OK) {
-        ret = DS18B20_ERR_WRITE;
-        goto exit;
+    if(one_wire_send_byte(dev->huart, DS18B20_CMD_SEARCH_ROM) != DS18B20_ERR_OK) {
+        return DS18B20_ERR_WRITE;
+    }
+    for (uint8_t n = 1; n <= DS18B20_ROM_LEN * 8; n++) {
+        uint8_t mask = 1 << ((n - 1) & 0x07);
+        uint8_t *byte = &rom[(n - 1) >> 3];
+        uint8_t bit = 0, cmp = 0, dir = 0;
+
+        if(one_wire_bit(dev->huart, 1, &bit) != DS18B20_ERR_OK
+        || one_wire_bit(dev->huart, 1, &cmp) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_READ;
+        }
+        if(bit == 1 && cmp == 1) {
+            return DS18B20_ERR_NO_DEV1;
+        } else if(bit != cmp) {
+            dir = bit;
+        } else {
+            if(n < *last) {
+                dir = ((*byte & mask) != 0);
+            } else {
+                dir = (n == *last);
+            }
+            if(dir == 0) {
+                last_zero = n;
+            }
+        }
+        if(dir) {
+            *byte |= mask;
+        } else {
+            *byte &= ~mask;
+        }
+        if(one_wire_bit(dev->huart, dir, &bit) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_WRITE;
+        }
+    }
+    *last = last_zero;
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief 搜索总线上的DS18B20
+ * 
+ * 每个设备一次遍历,CRC错误或非DS18B20的设备被丢弃
+ * @param rom ROM编码存储
+ * @param max 最大搜索数量
+ * @param num 搜索到的设备数量
+ * @return 总线无设备或通信失败返回错误
+ */
+ds18b20_err_t ds18b20_search(ds18b20_t *dev, uint8_t (*rom)[DS18B20_ROM_LEN], uint8_t max, uint8_t *num)
+{
+    uint8_t id[DS18B20_ROM_LEN] = {0};
+    uint8_t last = 0;
+    ds18b20_err_t ret = DS18B20_ERR_OK;
+
+    *num = 0;
+    do {
+        ret = search_pass(dev, id, &last);
+        if(ret != DS18B20_ERR_OK) {
+            break;
+        }
+        if(crc8_maxim(id, DS18B20_ROM_LEN - 1) == id[DS18B20_ROM_LEN - 1]
+        && id[0] == DS18B20_FAMILY_CODE) {
+            memcpy(rom[(*num)++], id, DS18B20_ROM_LEN);
+        }
+    } while(last != 0 && *num < max);
+
+    uart_release(dev);
+    //已搜索到设备时忽略后续遍历错误
+    return (*num > 0) ? DS18B20_ERR_OK : ret;
+}
+/**
+ * @brief 生成单总线事务
+ * 
+ * 选择设备(跳过ROM或匹配ROM)、写入命令与数据、读取字节依次展开为时隙,复位不包含在事务中
+ * @param txn 事务
+ * @param rom ROM编码,NULL时跳过ROM
+ * @param tx 写入数据,首字节为功能命令
+ * @param tx_len 写入字节数
+ * @param rx_len 读取字节数
+ * @return 超出事务长度返回false
+ */
+bool ds18b20_txn_build(ow_txn_t *txn, const uint8_t *rom, const uint8_t *tx, uint8_t tx_len, uint8_t rx_len)
+{
+    uint8_t cmd = (rom == NULL) ? DS18B20_CMD_SKIP_ROM : DS18B20_CMD_MATCH_ROM;
+
+    ow_txn_init(txn);
+    if(ow_txn_write(txn, &cmd, 1) == false) {
+        return false;
+    }
+    if(rom != NULL && ow_txn_write(txn, rom, DS18B20_ROM_LEN) == false) {
+        return false;
+    }
+    return ow_txn_write(txn, tx, tx_len) && ow_txn_read(txn, rx_len);
+}
+/**
+ * @brief 暂存器温度值
+ * 
+ * 低分辨率时未定义的低位清零
+ * @param reg 暂存器9字节
+ * @return 温度值
+ */
+static float scratchpad_temp(const uint8_t *reg)
+{
+    uint8_t res = (reg[4] >> 5) & 0x03;
+    uint8_t temp_l = reg[0] & (uint8_t)~((1 << (DS18B20_RES_12BIT - res)) - 1);
+    uint8_t temp_h = reg[1];
+    return caculate_temp(temp_h, temp_l);
+}
+/**
+ * @brief 解析读取暂存器事务的温度值
+ * 
+ * 事务由ds18b20_txn_build(txn, rom, {READ_SCRPAD}, 1, 9)生成,完成回调中调用
+ * @param txn 已完成的事务
+ * @param temperature 存储温度值的指针
+ * @return 解析成功返回DS18B20_ERR_OK
+ */
+ds18b20_err_t ds18b20_txn_temp(const ow_txn_t *txn, float *temperature)
+{
+    if(txn->read_len < DS18B20_SCRPAD_LEN) {
+        return DS18B20_ERR_READ;
+    }
+    if(crc8_maxim(txn->data, DS18B20_SCRPAD_LEN - 1) != txn->data[DS18B20_SCRPAD_LEN - 1]) {
+        return DS18B20_ERR_CRC;
+    }
+    *temperature = scratchpad_temp(txn->data);
+    return DS18B20_ERR_OK;
+}
+#if (DS18B20_USE_DMA == 1)
+/**
+ * @brief 开始DMA事务
+ * 
+ * 复位后DMA发送全部时隙,同时DMA接收回读,传输期间不占用CPU;
+ * 完成后在ds18b20_dma_isr中解码并调用完成回调
+ * @param txn 事务,完成前不可修改
+ * @param done 完成回调,中断中调用,可为NULL
+ * @return 启动成功返回DS18B20_ERR_OK
+ */
+ds18b20_err_t ds18b20_txn_start(ds18b20_t *dev, ow_txn_t *txn, ds18b20_done_t done)
+{
+    if(dev->busy == true) {
+        return DS18B20_ERR_BUSY;
+    }
+    if(txn->len == 0) {
+        return DS18B20_ERR_WRITE;
+    }
+    ds18b20_err_t ret = ds18b20_reset(dev);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    dev->active = txn;
+    dev->done = done;
+    dev->result = DS18B20_ERR_TIMEOUT;
+    dev->busy = true;
+    //先启动接收,避免丢失首个回读
+    if(HAL_UART_Receive_DMA(dev->huart, txn->rx, txn->len) != HAL_OK) {
+        dev->busy = false;
+        return DS18B20_ERR_READ;
+    }
+    if(HAL_UART_Transmit_DMA(dev->huart, txn->tx, txn->len) != HAL_OK) {
+        HAL_UART_Abort(dev->huart);
+        dev->busy = false;
+        return DS18B20_ERR_WRITE;
+    }
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief DMA接收完成处理
+ * 
+ * 在HAL_UART_RxCpltCallback中调用;回读最后一个时隙后事务完成
+ */
+void ds18b20_dma_isr(ds18b20_t *dev)
+{
+    if(dev->busy == false) {
+        return;
+    }
+    dev->result = (ow_txn_decode(dev->active) == true) ? DS18B20_ERR_OK : DS18B20_ERR_WRITE;
+    dev->busy = false;
+    if(dev->done != NULL) {
+        dev->done(dev);
+    }
+}
+/**
+ * @brief DMA传输错误处理
+ * 
+ * 在HAL_UART_ErrorCallback中调用
+ */
+void ds18b20_dma_error(ds18b20_t *dev)
+{
+    if(dev->busy == false) {
+        return;
+    }
+    dev->result = DS18B20_ERR_READ;
+    dev->busy = false;
+    if(dev->done != NULL) {
+        dev->done(dev);
+    }
+}
+/**
+ * @brief 等待DMA事务期间调用
+ * 
+ * 默认延时1ms让出CPU,可重定义为进入睡眠等待中断
+ */
+__weak void ds18b20_txn_idle(void)
+{
+    osDelay(1);
+}
+/**
+ * @brief 执行DMA事务并等待完成
+ * 
+ * @return 事务结果
+ */
+static ds18b20_err_t txn_run(ds18b20_t *dev, ow_txn_t *txn)
+{
+    ds18b20_err_t ret = ds18b20_txn_start(dev, txn, NULL);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    uint32_t start = sensor_time_get();
+    while(dev->busy == true) {
+        if(sensor_time_age(start) > DS18B20_TXN_TIMEOUT_MS) {
+            HAL_UART_Abort(dev->huart);
+            dev->busy = false;
+            return DS18B20_ERR_TIMEOUT;
+        }
+        ds18b20_txn_idle();
+    }
+    return dev->result;
+}
+#endif /* (DS18B20_USE_DMA == 1) */
+/**
+ * @brief 复位后选择设备并收发数据
+ * 
+ * DMA模式整个事务一次传输,否则逐时隙收发
+ * @param rom ROM编码,NULL时跳过ROM
+ * @param tx 写入数据,首字节为功能命令
+ * @param tx_len 写入字节数
+ * @param rx 读取数据
+ * @param rx_len 读取字节数
+ * @return 成功返回DS18B20_ERR_OK,不释放串口
+ */
+static ds18b20_err_t transfer(ds18b20_t *dev, const uint8_t *rom, const uint8_t *tx, uint8_t tx_len,
+                              uint8_t *rx, uint8_t rx_len)
+{
+#if (DS18B20_USE_DMA == 1)
+    if(ds18b20_txn_build(&dev->txn, rom, tx, tx_len, rx_len) == false) {
+        return DS18B20_ERR_WRITE;
     }
+    ds18b20_err_t ret = txn_run(dev, &dev->txn);
+    if(ret == DS18B20_ERR_OK && rx_len > 0) {
+        memcpy(rx, dev->txn.data, rx_len);
+    }
+    return ret;
+#else
+    ds18b20_err_t ret = match_rom(dev, rom);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    for (uint8_t i = 0; i < tx_len; i++) {
+        if(one_wire_send_byte(dev->huart, tx[i]) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_WRITE;
+        }
+    }
+    for (uint8_t i = 0; i < rx_len; i++) {
+        if(one_wire_read(dev->huart, &rx[i]) != DS18B20_ERR_OK) {
+            return DS18B20_ERR_READ;
+        }
+    }
+    return DS18B20_ERR_OK;
+#endif /* (DS18B20_USE_DMA == 1) */
+}
+/**
+ * @brief 读取暂存器
+ * 
+ * @param rom ROM编码,NULL时跳过ROM
+ * @param reg 暂存器9字节
+ * @return 读取成功返回DS18B20_ERR_OK,不释放串口
+ */
+static ds18b20_err_t read_scratchpad(ds18b20_t *dev, const uint8_t *rom, uint8_t *reg)
+{
+    uint8_t cmd = DS18B20_CMD_READ_SCRPAD;
+    ds18b20_err_t ret = transfer(dev, rom, &cmd, 1, reg, DS18B20_SCRPAD_LEN);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    if(crc8_maxim(reg, DS18B20_SCRPAD_LEN - 1) != reg[DS18B20_SCRPAD_LEN - 1]) {
+        return DS18B20_ERR_CRC;
+    }
+    return DS18B20_ERR_OK;
+}
+/**
+ * @brief 总线上所有DS18B20开始温度转换
+ * 
+ * 跳过ROM广播转换命令,读时隙轮询转换完成:转换中设备返回0,全部完成后返回1;
+ * 多个设备时按最高分辨率确定超时
+ * @param res 分辨率,确定最大转换时间
+ * @return 转换成功返回DS18B20_ERR_OK
+ */
+ds18b20_err_t ds18b20_convert(ds18b20_t *dev, ds18b20_res_t res)
+{
+    uint8_t done = 0;
+    uint8_t cmd = DS18B20_CMD_CONVERT_T;
     //开始转换
-    if(one_wire_send_byte(dev->huart, DS18B20_CMD_CONVERT_T) != DS18B20_ERR_OK) {
-        ret = DS18B20_ERR_WRITE;
+    ds18b20_err_t ret = transfer(dev, NULL, &cmd, 1, NULL, 0);
+    if(ret != DS18B20_ERR_OK) {
         goto exit;
     }
-    //等待转换, 最大750ms
-    HAL_Delay(800);
-    //复位
-    if(ds18b20_reset(dev) != DS18B20_ERR_OK) {
-        ret = DS18B20_ERR_NO_DEV2;
+    uint32_t start = sensor_time_get();
+    do {
+        HAL_Delay(DS18B20_POLL_MS);
+        if(one_wire_bit(dev->huart, 1, &done) != DS18B20_ERR_OK) {
+            ret = DS18B20_ERR_READ;
+            goto exit;
+        }
+        if(sensor_deadline_expired() == true) {
+            break;
+        }
+    } while(done == 0 && sensor_time_age(start) < DS18B20_CONV_MS(res));
+
+    if(done == 0) {
+        ret = DS18B20_ERR_TIMEOUT;
+    }
+
+exit:
+    uart_release(dev);
+    return ret;
+}
+/**
+ * @brief 设置分辨率
+ * 
+ * 先读取暂存器,配置相同时不写入,避免EEPROM重复擦写;
+ * 不同时保留报警阈值写入配置寄存器,校验后复制到EEPROM,掉电保持
+ * @param rom ROM编码,NULL时跳过ROM,总线上仅允许一个设备
+ * @param res 分辨率
+ * @return 设置成功返回DS18B20_ERR_OK
+ */
+ds18b20_err_t ds18b20_set_resolution(ds18b20_t *dev, const uint8_t *rom, ds18b20_res_t res)
+{
+    uint8_t reg[DS18B20_SCRPAD_LEN] = {0};
+    uint8_t cfg = DS18B20_CFG_REG(res);
+
+    ds18b20_err_t ret = read_scratchpad(dev, rom, reg);
+    if(ret != DS18B20_ERR_OK || reg[4] == cfg) {
         goto exit;
     }
-    if(one_wire_send_byte(dev->huart, DS18B20_CMD_SKIP_ROM) != DS18B20_ERR_OK) {
-        ret = DS18B20_ERR_WRITE;
+    //TH,TL保持不变
+    uint8_t data[4] = {DS18B20_CMD_WRITE_SCRPAD, reg[2], reg[3], cfg};
+    ret = transfer(dev, rom, data, sizeof(data), NULL, 0);
+    if(ret != DS18B20_ERR_OK) {
+        goto exit;
+    }
+    ret = read_scratchpad(dev, rom, reg);
+    if(ret != DS18B20_ERR_OK) {
         goto exit;
     }
-    //读取温度
-    if(one_wire_send_byte(dev->huart, DS18B20_CMD_READ_SCRPAD) != DS18B20_ERR_OK) {
+    if(reg[4] != cfg) {
         ret = DS18B20_ERR_WRITE;
         goto exit;
     }
-    //读取9字节内存
-    for (uint8_t i = 0; i < 9; i++) {
-        if(one_wire_read(dev->huart, &reg[i]) != DS18B20_ERR_OK) {
-            ret = DS18B20_ERR_READ;
-            goto exit;
-        }
+    uint8_t cmd = DS18B20_CMD_COPY_SCRPAD;
+    ret = transfer(dev, rom, &cmd, 1, NULL, 0);
+    if(ret != DS18B20_ERR_OK) {
+        goto exit;
     }
+    //EEPROM写入期间保持总线高电平
+    HAL_Delay(DS18B20_COPY_MS);
 
-    uint8_t temp_l  = reg[0];
-    uint8_t temp_h  = reg[1];
-    uint8_t crc     = reg[8];
-    uint8_t crc_data = crc8_maxim(reg, sizeof(reg) - 1);
+exit:
+    uart_release(dev);
+    return ret;
+}
+/**
+ * @brief 读取指定DS18B20温度值
+ * 
+ * 读取已完成转换的暂存器,低分辨率时未定义的低位清零
+ * @param rom ROM编码,NULL时跳过ROM,总线上仅允许一个设备
+ * @param temperature 存储温度值的指针
+ * @return 读取成功返回DS18B20_ERR_OK
+ */
+ds18b20_err_t ds18b20_read_temp(ds18b20_t *dev, const uint8_t *rom, float *temperature)
+{
+    uint8_t reg[DS18B20_SCRPAD_LEN] = {0};
+    ds18b20_err_t ret = read_scratchpad(dev, rom, reg);
 
-    if(crc_data != crc) {
-        ret = DS18B20_ERR_CRC;
-    } else {
-        *temperature = caculate_temp(temp_h, temp_l);
-        ret = DS18B20_ERR_OK;
+    if(ret == DS18B20_ERR_NO_DEV1) {
+        //复位无应答按读取阶段无设备处理
+        ret = DS18B20_ERR_NO_DEV2;
+    } else if(ret == DS18B20_ERR_OK) {
+        *temperature = scratchpad_temp(reg);
     }
 
-exit:
-    HAL_UART_DeInit(dev->huart);
+    uart_release(dev);
     return ret;
-}
\ No newline at end of file
+}
+/**
+ * @brief 释放串口
+ * 
+ * 总线关闭时调用;DMA模式下操作之间保持串口初始化,关闭电源前需释放
+ */
+void ds18b20_release(ds18b20_t *dev)
+{
+#if (DS18B20_USE_DMA == 1)
+    if(dev->busy == true) {
+        HAL_UART_Abort(dev->huart);
+        dev->busy = false;
+    }
+#endif /* (DS18B20_USE_DMA == 1) */
+    HAL_UART_DeInit(dev->huart);
+}
+/**
+ * @brief 通过跳过ROM地址获取温度值
+ * @note 分辨率未知,按12位最大转换时间超时
+ * @param temperature 存储温度值的指针
+ * @return 获取温度值成功返回true，否则返回false
+ */
+ds18b20_err_t ds18b20_get_temp_skiprom(ds18b20_t *dev, float *temperature)
+{
+    ds18b20_err_t ret = ds18b20_convert(dev, DS18B20_RES_12BIT);
+    if(ret != DS18B20_ERR_OK) {
+        return ret;
+    }
+    return ds18b20_read_temp(dev, NULL, temperature);
+}
@@ -21,6 +21,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "usart.h"
 #include "node_crc.h"
+#include "ds18b20_ow.h"
 /* Exported constants --------------------------------------------------------*/
 typedef enum
 {
@@ -31,20 +32,60 @@ typedef enum
     DS18B20_ERR_TIMEOUT,    //超时
     DS18B20_ERR_WRITE,      //写入错误
     DS18B20_ERR_READ,       //读取错误
+    DS18B20_ERR_BUSY,       //DMA事务进行中
 }ds18b20_err_t;
 /* Exported macro ------------------------------------------------------------*/
+#define DS18B20_ROM_LEN     8   //ROM编码长度:家族码+48位序列号+CRC
+#define DS18B20_CONV_MS(res) (94U << (res))  //最大转换时间(ms),手册值93.75/187.5/375/750
+//1: 单总线事务使用DMA收发,需配置串口收发DMA 0: 逐时隙轮询收发
+#ifndef DS18B20_USE_DMA
+#define DS18B20_USE_DMA     0
+#endif
 
 /* Exported types ------------------------------------------------------------*/
-typedef struct 
+/**
+ * @brief 温度分辨率
+ * @note 分辨率0.5/0.25/0.125/0.0625℃
+ */
+typedef enum
+{
+    DS18B20_RES_9BIT = 0,
+    DS18B20_RES_10BIT,
+    DS18B20_RES_11BIT,
+    DS18B20_RES_12BIT,
+}ds18b20_res_t;
+typedef struct ds18b20_s ds18b20_t;
+typedef void (*ds18b20_done_t)(ds18b20_t *dev);
+struct ds18b20_s
 {
     UART_HandleTypeDef  *huart;     //串口句柄
     USART_TypeDef       *Instance;  //串口实例
-}ds18b20_t;
+#if (DS18B20_USE_DMA == 1)
+    ow_txn_t            txn;        //阻塞接口使用的事务
+    ow_txn_t            *active;    //进行中的事务
+    ds18b20_done_t      done;       //完成回调,中断中调用
+    volatile bool       busy;       //事务进行中
+    volatile ds18b20_err_t result;  //事务结果
+#endif /* (DS18B20_USE_DMA == 1) */
+};
 /* Exported variables ---------------------------------------------------------*/
 
 /* Exported functions prototypes ---------------------------------------------*/
 ds18b20_err_t ds18b20_reset(ds18b20_t *dev);
 ds18b20_err_t ds18b20_get_temp_skiprom(ds18b20_t *dev, float *temperature);
+ds18b20_err_t ds18b20_search(ds18b20_t *dev, uint8_t (*rom)[DS18B20_ROM_LEN], uint8_t max, uint8_t *num);
+ds18b20_err_t ds18b20_convert(ds18b20_t *dev, ds18b20_res_t res);
+ds18b20_err_t ds18b20_set_resolution(ds18b20_t *dev, const uint8_t *rom, ds18b20_res_t res);
+ds18b20_err_t ds18b20_read_temp(ds18b20_t *dev, const uint8_t *rom, float *temperature);
+bool ds18b20_txn_build(ow_txn_t *txn, const uint8_t *rom, const uint8_t *tx, uint8_t tx_len, uint8_t rx_len);
+ds18b20_err_t ds18b20_txn_temp(const ow_txn_t *txn, float *temperature);
+void ds18b20_release(ds18b20_t *dev);
+#if (DS18B20_USE_DMA == 1)
+ds18b20_err_t ds18b20_txn_start(ds18b20_t *dev, ow_txn_t *txn, ds18b20_done_t done);
+void ds18b20_dma_isr(ds18b20_t *dev);
+void ds18b20_dma_error(ds18b20_t *dev);
+void ds18b20_txn_idle(void);
+#endif /* (DS18B20_USE_DMA == 1) */
 
 #ifdef __cplusplus
 }
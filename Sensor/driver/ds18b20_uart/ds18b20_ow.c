@@ -0,0 +1,109 @@
+/**
+ * @File Name: ds18b20_ow.c
+ * @brief  单总线串口位展开事务编解码
+ * @note   不依赖HAL,可在主机上单独编译测试
+ * @Author : 
+ * @Version : 1.0
+ * @Creat Date : 2024-01-22
+ * 
+ * @copyright Copyright (c) 2024 
+ * @par 修改日志:
+ * Date           Version     Author  Description
+ * 2024-01-22     v1.0        huagnly 内容
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "ds18b20_ow.h"
+/* Private includes ----------------------------------------------------------*/
+#include <string.h>
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#if (OW_TXN_BYTES > 32)
+#error "read_mask holds at most 32 bytes"
+#endif
+/* Private variables ---------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief 初始化事务
+ * 
+ * @param txn 事务
+ */
+void ow_txn_init(ow_txn_t *txn)
+{
+    memset(txn, 0, sizeof(ow_txn_t));
+}
+/**
+ * @brief 添加写入字节
+ * 
+ * 每个字节低位先行展开为8个时隙
+ * @param data 写入数据
+ * @param len 字节数
+ * @return 超出事务长度返回false
+ */
+bool ow_txn_write(ow_txn_t *txn, const uint8_t *data, uint8_t len)
+{
+    if(txn->len + len * 8 > OW_TXN_SLOTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t byte = data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            txn->tx[txn->len++] = (byte & 0x01) ? OW_SLOT_1 : OW_SLOT_0;
+            byte >>= 1;
+        }
+    }
+    return true;
+}
+/**
+ * @brief 添加读取字节
+ * 
+ * 读时隙与写1时隙相同,由读取标记区分
+ * @param len 字节数
+ * @return 超出事务长度返回false
+ */
+bool ow_txn_read(ow_txn_t *txn, uint8_t len)
+{
+    if(txn->len + len * 8 > OW_TXN_SLOTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        txn->read_mask |= 1UL << (txn->len / 8);
+        memset(&txn->tx[txn->len], OW_SLOT_1, 8);
+        txn->len += 8;
+    }
+    return true;
+}
+/**
+ * @brief 解码回读时隙
+ * 
+ * 读取字节:回读为OW_SLOT_1时该位为1,设备拉低总线时为0;
+ * 写入字节:回读应与发送相同,不同说明总线短路或设备冲突
+ * @return 写入回读校验通过返回true,读取结果存放于data
+ */
+bool ow_txn_decode(ow_txn_t *txn)
+{
+    bool ret = true;
+
+    txn->read_len = 0;
+    for (uint8_t i = 0; i < txn->len / 8; i++) {
+        const uint8_t *tx = &txn->tx[i * 8];
+        const uint8_t *rx = &txn->rx[i * 8];
+        if(txn->read_mask & (1UL << i)) {
+            uint8_t byte = 0;
+            for (uint8_t b = 0; b < 8; b++) {
+                if(rx[b] == OW_SLOT_1) {
+                    byte |= 1 << b;
+                }
+            }
+            txn->data[txn->read_len++] = byte;
+        } else if(memcmp(tx, rx, 8) != 0) {
+            ret = false;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,58 @@
+/**
+ * @File Name: ds18b20_ow.h
+ * @brief  单总线串口位展开事务编解码
+ * @Author : 
+ * @Version : 1.0
+ * @Creat Date : 2024-01-22
+ * 
+ * @copyright Copyright (c) 2024 
+ * @par 修改日志:
+ * Date           Version     Author  Description
+ * 2024-01-22     v1.0        huagnly 内容
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DS18B20_OW_H__
+#define __DS18B20_OW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+/* Exported constants --------------------------------------------------------*/
+#define OW_TXN_BYTES        20                  //单次事务最大字节数:匹配ROM+ROM+命令+9字节暂存器
+#define OW_TXN_SLOTS        (OW_TXN_BYTES * 8)  //单次事务最大时隙数,每个时隙一个串口字节
+#define OW_SLOT_0           0x00                //写0时隙
+#define OW_SLOT_1           0xFF                //写1时隙,同时为读时隙
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported types ------------------------------------------------------------*/
+/**
+ * @brief 单总线事务
+ * @note 复位之后的写入与读取展开为时隙序列,115200波特率下一个串口字节为一个时隙;
+ *       发送tx同时接收回读rx,解码后读取字节存放于data
+ */
+typedef struct ow_txn_s
+{
+    uint8_t  tx[OW_TXN_SLOTS];      //发送时隙
+    uint8_t  rx[OW_TXN_SLOTS];      //回读时隙
+    uint8_t  data[OW_TXN_BYTES];    //解码的读取字节
+    uint32_t read_mask;             //第i位为1表示第i个字节为读取
+    uint16_t len;                   //时隙数
+    uint8_t  read_len;              //读取字节数
+}ow_txn_t;
+/* Exported variables ---------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void ow_txn_init(ow_txn_t *txn);
+bool ow_txn_write(ow_txn_t *txn, const uint8_t *data, uint8_t len);
+bool ow_txn_read(ow_txn_t *txn, uint8_t len);
+bool ow_txn_decode(ow_txn_t *txn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DS18B20_OW_H__ */
@@ -21,7 +21,7 @@
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
-static ds18b20_driver_cfg_t ds18b20_cfg  =
+static ds18b20_bus_t ds18b20_bus =
 {
     .power = 
     {
@@ -35,18 +35,12 @@ static ds18b20_driver_cfg_t ds18b20_cfg  =
         .Instance = USART1,
     },
 };
+static ds18b20_driver_cfg_t ds18b20_cfg[DS18B20_MAX_NUM];
+static char ds18b20_name[DS18B20_MAX_NUM][DS18B20_NAME_LEN];
 //传感器操作函数
 static const sensor_ops_t ds18b20_ops;
-ds18b20_device_t ds18b20 =
-{
-    .parent =
-    {
-        .name   = "ds18b20",    //设备名称
-        .ops    = &ds18b20_ops, //操作函数
-        .module = NULL,         //模块
-    },
-    .cfg = &ds18b20_cfg,        //配置信息
-};
+//设备对象池,ds18b20_register根据搜索结果初始化并注册
+ds18b20_device_t ds18b20[DS18B20_MAX_NUM];
 /* Private function prototypes -----------------------------------------------*/
 static bool ds18b20_open(sensor_device_t dev);
 static bool ds18b20_close(sensor_device_t dev);
@@ -76,9 +70,113 @@ static ds18b20_driver_cfg_t *find_cfg(sensor_device_t dev)
     }
     return sensor->cfg;
 }
+/**
+ * @brief  总线电源控制
+ * @note   电源已开启时不再等待上电
+ * @param  *bus: 单总线
+ * @param  flag: true:开启 false:关闭
+ */
+static void power_control(ds18b20_bus_t *bus, bool flag)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    GPIO_InitStruct.Pin = bus->power.pin;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+
+    if(flag == true) {
+        bool powered = (HAL_GPIO_ReadPin(bus->power.port, bus->power.pin) == bus->power.level);
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        HAL_GPIO_Init(bus->power.port, &GPIO_InitStruct);
+        HAL_GPIO_WritePin(bus->power.port, bus->power.pin, bus->power.level);
+        if(powered == false) {
+            HAL_Delay(50);
+        }
+    } else {
+        HAL_GPIO_WritePin(bus->power.port, bus->power.pin, !bus->power.level);
+        GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+        HAL_GPIO_Init(bus->power.port, &GPIO_InitStruct);
+    }
+}
+/**
+ * @brief  批量转换是否有未读取结果
+ * @param  *config: 配置信息
+ * @retval true: 有 false: 无
+ */
+static bool batch_fresh(ds18b20_driver_cfg_t *config)
+{
+    return config->fresh == true && sensor_time_age(config->bus->batch_ts) < DS18B20_BATCH_MS;
+}
+/**
+ * @brief  采集错误统计
+ * @param  dev: 设备句柄
+ * @param  ret: 错误码
+ */
+static void collect_error(sensor_device_t dev, ds18b20_err_t ret)
+{
+    SENSOR_LOG_E("[%s][error]collect:%d\r\n", dev->name, ret);
+    if(ret == DS18B20_ERR_CRC) {
+        sensor_stats_event(dev, SENSOR_STATS_CRC);
+    } else if(ret == DS18B20_ERR_TIMEOUT) {
+        sensor_stats_event(dev, SENSOR_STATS_TIMEOUT);
+    }
+}
+/**
+ * @brief  批量采集
+ * @note   广播一次温度转换,总线上所有设备共用一个转换等待时间,再按ROM编码逐个读取暂存器;
+ *         其他设备的结果保留至各自采集时读取
+ * @param  dev: 发起采集的设备句柄
+ * @param  *config: 发起采集的设备配置
+ * @retval true:发起设备读取成功 false:失败
+ */
+static bool batch_collect(sensor_device_t dev, ds18b20_driver_cfg_t *config)
+{
+    ds18b20_bus_t *bus = config->bus;
+    uint8_t num = (bus->num == 0) ? 1 : bus->num;
+    bool ret = false;
+
+    ds18b20_res_t res = DS18B20_RES_9BIT;
+    ds18b20_err_t err = DS18B20_ERR_OK;
+
+    for(uint8_t i = 0; i < num; i++) {
+        const uint8_t *rom = (bus->num == 0) ? NULL : bus->rom[i];
+        ds18b20_cfg[i].fresh = false;
+        if(ds18b20_cfg[i].res_set == true) {
+            err = ds18b20_set_resolution(&bus->dq, rom, ds18b20_cfg[i].res);
+            if(err == DS18B20_ERR_OK) {
+                ds18b20_cfg[i].res_set = false;
+            } else {
+                SENSOR_LOG_E("[%s][error]resolution:%d\r\n", ds18b20[i].parent.name, err);
+            }
+        }
+        //同时转换,按最高分辨率等待
+        if(ds18b20_cfg[i].res > res) {
+            res = ds18b20_cfg[i].res;
+        }
+    }
+    err = ds18b20_convert(&bus->dq, res);
+    if(err != DS18B20_ERR_OK) {
+        collect_error(dev, err);
+        return false;
+    }
+    bus->batch_ts = sensor_time_get();
+    for(uint8_t i = 0; i < num; i++) {
+        float temperature = 0;
+        const uint8_t *rom = (bus->num == 0) ? NULL : bus->rom[i];
+        err = ds18b20_read_temp(&bus->dq, rom, &temperature);
+        if(err == DS18B20_ERR_OK) {
+            ds18b20_cfg[i].raw = temperature;
+            ds18b20_cfg[i].timestamp = bus->batch_ts;
+            ds18b20_cfg[i].fresh = (&ds18b20_cfg[i] != config);
+            ret |= (&ds18b20_cfg[i] == config);
+            SENSOR_LOG_D("[%s]raw:%.3f\r\n", ds18b20[i].parent.name, ds18b20_cfg[i].raw);
+        } else {
+            collect_error(&ds18b20[i].parent, err);
+        }
+    }
+    return ret;
+}
 /**
  * @brief  DS18B20开启
- * @note   开启电源,并发送
+ * @note   开启电源,并发送;已有批量转换结果时无需上电
  * @param  dev: 设备句柄
  * @retval true:成功 false:失败
  */
@@ -86,49 +184,39 @@ static bool ds18b20_open(sensor_device_t dev)
 {
     FIND_CFG(ds18b20_driver_cfg_t, dev);
 
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-    GPIO_InitStruct.Pin = config->power.pin;
-    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-    GPIO_InitStruct.Pull = GPIO_NOPULL;
-    HAL_GPIO_Init(config->power.port, &GPIO_InitStruct);
-
-    HAL_GPIO_WritePin(config->power.port, config->power.pin, config->power.level);
-    HAL_Delay(50);
+    if(batch_fresh(config) == true) {
+        return true;
+    }
+    power_control(config->bus, true);
 
-    ds18b20_err_t ret = ds18b20_reset(&config->dq);
+    ds18b20_err_t ret = ds18b20_reset(&config->bus->dq);
     if(ret == DS18B20_ERR_OK) {
         return true;
     } else {
-        printf("[%s][error]open:%d\r\n", dev->name, ret);
+        SENSOR_LOG_E("[%s][error]open:%d\r\n", dev->name, ret);
         return false;
     }
 }
 /**
  * @brief  ds18b20数据采集
- * @note  None
+ * @note  同一总线一次转换采集所有设备,结果有效期内其他设备直接读取
  * @param  dev: 设备句柄
- * @param  *data: 数据存储地址
- * @param  len: 数据长度
  * @retval true:成功 false:失败
  */
 static bool ds18b20_collect(sensor_device_t dev)
 {
     FIND_CFG(ds18b20_driver_cfg_t, dev);
-    float temperature = 0;
 
-    ds18b20_err_t ret = ds18b20_get_temp_skiprom(&config->dq, &temperature);
-    if(ret == DS18B20_ERR_OK) {
-        config->raw = temperature;
-        printf("[%s]raw:%s\r\n", dev->name, ftoc(config->raw, 3));
+    if(batch_fresh(config) == true) {
+        config->fresh = false;
+        SENSOR_LOG_D("[%s]batch raw:%.3f\r\n", dev->name, config->raw);
         return true;
-    } else {
-        printf("[%s][error]collect:%d\r\n", dev->name, ret);
-        return false;
     }
+    return batch_collect(dev, config);
 }
 /**
  * @brief  DS18B20关闭
- * @note   关闭电源,并设置为模拟输入
+ * @note   释放串口后关闭电源,并设置为模拟输入
  * @param  dev: 设备句柄
  * @retval true:成功 false:失败
  */
@@ -136,14 +224,8 @@ static bool ds18b20_close(sensor_device_t dev)
 {
     FIND_CFG(ds18b20_driver_cfg_t, dev);
 
-    HAL_GPIO_WritePin(config->power.port, config->power.pin, !config->power.level);
-
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-    GPIO_InitStruct.Pin = config->power.pin;
-    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
-    GPIO_InitStruct.Pull = GPIO_NOPULL;
-    HAL_GPIO_Init(config->power.port, &GPIO_InitStruct);
-
+    ds18b20_release(&config->bus->dq);
+    power_control(config->bus, false);
     return true;
 }
 /**
@@ -192,8 +274,68 @@ static bool dsb1820_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, v
             }
             break;
         }
+        case SENSOR_CMD_TIME_SET:
+        {
+            config->timestamp = *(uint32_t *)data;
+            break;
+        }
+        case SENSOR_CMD_TIME_GET:
+        {
+            *(uint32_t *)data = config->timestamp;
+            break;
+        }
+        case SENSOR_CMD_SET_OTHER:  //设置分辨率
+        {
+            ds18b20_res_t res = *(ds18b20_res_t *)data;
+            if(res > DS18B20_RES_12BIT) {
+                return false;
+            }
+            config->res = res;
+            config->res_set = true;
+            break;
+        }
+        case SENSOR_CMD_GET_OTHER:  //获取分辨率
+        {
+            *(ds18b20_res_t *)data = config->res;
+            break;
+        }
         default:
             break;
     }
     return true;
 }
+/**
+ * @brief  搜索并注册DS18B20
+ * @note   在sensor_register中调用;搜索到的设备依次命名为ds18b20,ds18b20_1...,
+ *         未搜索到设备时按跳过ROM方式注册一个设备
+ * @retval 注册的设备数量
+ */
+uint8_t ds18b20_register(void)
+{
+    ds18b20_bus_t *bus = &ds18b20_bus;
+
+    power_control(bus, true);
+    ds18b20_search(&bus->dq, bus->rom, DS18B20_MAX_NUM, &bus->num);
+    power_control(bus, false);
+
+    uint8_t num = (bus->num == 0) ? 1 : bus->num;
+    for(uint8_t i = 0; i < num; i++) {
+        if(i == 0) {
+            snprintf(ds18b20_name[i], DS18B20_NAME_LEN, "ds18b20");
+        } else {
+            snprintf(ds18b20_name[i], DS18B20_NAME_LEN, "ds18b20_%d", i);
+        }
+        ds18b20_cfg[i].id = i;
+        ds18b20_cfg[i].bus = bus;
+        ds18b20_cfg[i].res = DS18B20_RES_DEFAULT;
+        ds18b20_cfg[i].res_set = true;
+        ds18b20[i].parent.name = ds18b20_name[i];
+        ds18b20[i].parent.ops = &ds18b20_ops;
+        ds18b20[i].parent.module = NULL;
+        ds18b20[i].parent.energy.current = DS18B20_CURRENT_UA;
+        ds18b20[i].cfg = &ds18b20_cfg[i];
+        sensor_register_fun(&ds18b20[i].parent);
+    }
+    SENSOR_LOG_I("[ds18b20]search %d\r\n", bus->num);
+    return num;
+}
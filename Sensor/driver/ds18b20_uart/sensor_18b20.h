@@ -25,12 +25,16 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define DS18B20_CURRENT_UA 1000 //温度转换电流(uA)
 #define DS18B20_DATA_T float
+#define DS18B20_MAX_NUM     4       //单总线最大设备数量
+#define DS18B20_NAME_LEN    12      //设备名称长度
+#define DS18B20_BATCH_MS    10000   //批量转换结果有效时间(ms)
+#define DS18B20_RES_DEFAULT DS18B20_RES_12BIT   //默认分辨率
 /* Exported types ------------------------------------------------------------*/
 /**
- * @brief  GXHT3W设备配置信息
- * @note   None
- * @retval None
+ * @brief  DS18B20单总线
+ * @note   总线上所有设备共用电源与信号引脚
  */
 typedef struct
 {
@@ -40,10 +44,27 @@ typedef struct
         uint32_t        pin;    //控制引脚
         GPIO_PinState   level;  //控制电平
     }power;
+    ds18b20_t dq;               //信号引脚
+    uint8_t rom[DS18B20_MAX_NUM][DS18B20_ROM_LEN];  //搜索到的ROM编码
+    uint8_t num;                //搜索到的设备数量,0时跳过ROM,仅支持单个设备
+    uint32_t batch_ts;          //最近一次批量转换时间戳(ms)
+}ds18b20_bus_t;
+/**
+ * @brief  GXHT3W设备配置信息
+ * @note   None
+ * @retval None
+ */
+typedef struct
+{
     data_status_e status;       //传感器状态
     DS18B20_DATA_T value;       //数据值
     DS18B20_DATA_T raw;         //原始数据
-    ds18b20_t dq;               //信号引脚
+    uint32_t timestamp;         //采集时间戳(ms)
+    uint8_t id;                 //总线上设备序号,对应ROM编码
+    bool fresh;                 //批量转换结果未被采集读取
+    ds18b20_res_t res;          //分辨率,SENSOR_CMD_SET_OTHER设置
+    bool res_set;               //分辨率待写入,总线上电采集时写入
+    ds18b20_bus_t *bus;         //所在总线
 }ds18b20_driver_cfg_t;
 /**
  * @brief  GXHT3W设备对象
@@ -56,8 +77,9 @@ typedef struct
     ds18b20_driver_cfg_t   *cfg;    //配置信息
 }ds18b20_device_t;
 /* Exported variables ---------------------------------------------------------*/
-extern ds18b20_device_t ds18b20;
+extern ds18b20_device_t ds18b20[DS18B20_MAX_NUM];
 /* Exported functions prototypes ---------------------------------------------*/
+uint8_t ds18b20_register(void);
 
 #ifdef __cplusplus
 }
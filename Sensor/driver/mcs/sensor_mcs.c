@@ -13,7 +13,6 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_mcs.h"
 /* Private includes ----------------------------------------------------------*/
-#include <stdio.h>
 #include "critical_platform.h"
 /* Private typedef -----------------------------------------------------------*/
 
@@ -44,6 +43,7 @@ mcs_device_t mcs =
         .name = "mcs",  //设备名称
         .ops    = &mcs_ops, //操作函数
         .module = NULL,     //模块
+        .energy = {.current = MCS_CURRENT_UA}, //工作电流
     },
     .cfg = &mcs_cfg,        //配置信息
 };
@@ -169,6 +169,16 @@ static bool mcs_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, void
             config->isr_callback = data;
             break;
         }
+        case SENSOR_CMD_TIME_SET:
+        {
+            config->timestamp = *(uint32_t *)data;
+            break;
+        }
+        case SENSOR_CMD_TIME_GET:   //电平变化时刻,滤波延时前
+        {
+            *(uint32_t *)data = config->timestamp;
+            break;
+        }
         default:
             break;
     }
@@ -195,8 +205,9 @@ static void mcs_isr(void* context)
     }
 
     config->isr_level = GpioRead(&config->input.obj);
+    config->timestamp = sensor_time_get();
     config->status = MCS_STATUS_COLLECT;
-    printf("[mcs]isr,level:%d\r\n", config->isr_level);
+    SENSOR_LOG_D("[mcs]isr,level:%d\r\n", config->isr_level);
     if(config->isr_callback != NULL) {
         config->isr_callback();
     }
@@ -25,6 +25,7 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define MCS_CURRENT_UA 330 //触点吸合时上拉电阻电流(uA)
 #define MCS_DEBUG 1
 /* Exported types ------------------------------------------------------------*/
 /**
@@ -50,6 +51,7 @@ typedef struct
     GPIO_PinState       isr_level;      //中断电平
     GPIO_PinState       current_level;  //当前电平
     uint16_t            filter;         //滤波时间
+    uint32_t            timestamp;      //中断触发时间戳(ms)
     void    (*isr_callback)(void);      //中断回调函数
 
     struct{
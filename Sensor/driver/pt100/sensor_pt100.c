@@ -13,6 +13,8 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_pt100.h"
 /* Private includes ----------------------------------------------------------*/
+#include <math.h>
+
 #include "node_glbs.h"
 #include "module_ntag.h"
 /* Private typedef -----------------------------------------------------------*/
@@ -25,19 +27,111 @@ enum
     OFF,
     ON,
 };
+/**
+ * @brief  激励电流缓存
+ * @note   按电源通道保存参考电压,电源开关时失效
+ */
+typedef struct
+{
+    bool        valid;      //缓存有效
+    float       voltage;    //参考电压(mV)
+    uint32_t    ts;         //测量时间(ms)
+}pt100_ref_t;
+/**
+ * @brief  上电稳定统计
+ * @note   电源共用,所有通道共用一份统计
+ */
+typedef struct
+{
+    float       typical;    //典型稳定时间(ms),0表示未学习
+    uint32_t    last;       //上次稳定时间(ms)
+    uint32_t    max;        //最长稳定时间(ms)
+    uint32_t    timeout;    //超时次数
+}pt100_settle_t;
 /* Private define ------------------------------------------------------------*/
 //https://us.flukecal.com/pt100-calculator
 //https://www.engineeringtoolbox.com/pt100-electrical-resistance-d_1651.html
 #define A 3.9083e-3
 #define B -5.775e-7
 #define C -4.183e-12
+#define PT100_R0 100.0
+
+#define PT100_R_MIN     18.52f      //-200℃电阻
+#define PT100_R_MAX     390.481f    //850℃电阻
+#define PT100_T_ERR     3276.7f     //超出量程
+#define PT100_LUT_MIN   (-200)      //查表起始温度
+#define PT100_LUT_STEP  5           //查表温度间隔
+
+#ifndef PT100_ADC_ADDR
+#define PT100_ADC_ADDR  ADS1015_ADDR_GND    //ADS1015地址,ADDR引脚接地
+#endif
 
 #define COLLECT_NUM 5
 #define REF_V       1950
 /* Private macro -------------------------------------------------------------*/
 #define POWER_DEBUG 0
-#define POWER_DELAY 300
+#define POWER_DELAY 300     //上电最长等待时间(ms)
+#define PT100_SETTLE_DR     SPS_1600    //上电稳定检测数据率
+#define PT100_SETTLE_AVG    4           //每步平均转换次数
+#define PT100_SETTLE_TOL    (0.5f)      //外推剩余变化量小于0.5mV判定稳定
+#define PT100_SETTLE_SPAN   2           //比较间隔步数,加大基线降低噪声影响
+#define PT100_SETTLE_HIST   (2 * PT100_SETTLE_SPAN + 1)
+#define PT100_SETTLE_RMAX   (0.9f)      //外推衰减比上限,避免噪声导致除零
+#define PT100_SETTLE_SKIP   (0.25f)     //按典型稳定时间的1/4延后开始检测
+#define PT100_SETTLE_ALPHA  (0.125f)    //典型稳定时间平滑系数
+//1: 同一上电区间内各通道复用激励电流测量结果 0: 每次采集均测量
+#ifndef PT100_REF_CACHE
+#define PT100_REF_CACHE     1
+#endif
+#ifndef PT100_REF_REVALID
+#define PT100_REF_REVALID   (60 * 1000)     //激励电流缓存重新测量间隔(ms)
+#endif
+#define PT100_REF_DRIFT     (0.005f)        //重新测量时相对偏差超过0.5%告警
+
+#define PT100_FSR_FINE      FSR_0256        //自动量程最小量程(分辨率最高)
+#define PT100_FSR_COARSE    FSR_1024        //自动量程最大量程
+#define PT100_CODE_FS       (2048)          //满量程码值
+#define PT100_RANGE_UP      (0.90f)         //预测电压超过当前量程90%时切换到更大量程
+#define PT100_RANGE_DOWN    (0.75f)         //预测电压低于更小量程75%时切换到更小量程
+
+//未指定过采样时按以下条件选择数据率与过采样次数
+#define PT100_ADC_NOISE_IN  (1.0f)          //单次转换外部模拟噪声估计(LSB RMS)
+#define PT100_ADC_NOISE     (0.3f)          //每点目标噪声(LSB RMS)
+#define PT100_ADC_LATENCY   (10.0f)         //每点耗时上限(ms)
+//0℃以下Callendar-Van Dusen方程,编译期计算查表电阻
+#define PT100_R(t)  ((float)(PT100_R0 * (1 + A * (t) + B * (t) * (t) + C * ((t) - 100) * (t) * (t) * (t))))
+#define PT100_LUT_R(i)  PT100_R(PT100_LUT_MIN + (i) * PT100_LUT_STEP)
 /* Private variables ---------------------------------------------------------*/
+//-200℃ ~ 0℃电阻表,间隔5℃,线性插值误差小于0.003℃
+static const float pt100_lut[] =
+{
+    PT100_LUT_R(0),  PT100_LUT_R(1),  PT100_LUT_R(2),  PT100_LUT_R(3),  PT100_LUT_R(4),
+    PT100_LUT_R(5),  PT100_LUT_R(6),  PT100_LUT_R(7),  PT100_LUT_R(8),  PT100_LUT_R(9),
+    PT100_LUT_R(10), PT100_LUT_R(11), PT100_LUT_R(12), PT100_LUT_R(13), PT100_LUT_R(14),
+    PT100_LUT_R(15), PT100_LUT_R(16), PT100_LUT_R(17), PT100_LUT_R(18), PT100_LUT_R(19),
+    PT100_LUT_R(20), PT100_LUT_R(21), PT100_LUT_R(22), PT100_LUT_R(23), PT100_LUT_R(24),
+    PT100_LUT_R(25), PT100_LUT_R(26), PT100_LUT_R(27), PT100_LUT_R(28), PT100_LUT_R(29),
+    PT100_LUT_R(30), PT100_LUT_R(31), PT100_LUT_R(32), PT100_LUT_R(33), PT100_LUT_R(34),
+    PT100_LUT_R(35), PT100_LUT_R(36), PT100_LUT_R(37), PT100_LUT_R(38), PT100_LUT_R(39),
+    PT100_LUT_R(40),
+};
+#define PT100_LUT_NUM   (sizeof(pt100_lut) / sizeof(pt100_lut[0]))
+//各量程LSB(mV)
+static const float pt100_lsb[] =
+{
+    [FSR_6144] = 3.0f,
+    [FSR_4096] = 2.0f,
+    [FSR_2048] = 1.0f,
+    [FSR_1024] = 0.5f,
+    [FSR_0512] = 0.25f,
+    [FSR_0256] = 0.125f,
+};
+#if (PT100_REF_CACHE == 1)
+//与pt100_cfg一一对应,电源通道相同的配置共用首个配置的缓存
+static pt100_ref_t pt100_ref[PT100_MAX_NUM];
+#endif
+static pt100_settle_t pt100_settle;
+static ads1015_t pt100_adc;
 static pt100_cfg_t pt100_cfg[PT100_MAX_NUM] =
 {
     //NUM0
@@ -47,7 +141,9 @@ static pt100_cfg_t pt100_cfg[PT100_MAX_NUM] =
             .Id = ADS1015_IIC,
             .scl = ADS1015_SCL_PIN,
             .sda = ADS1015_SDA_PIN,
+            .addr = PT100_ADC_ADDR,
         },
+        .adc = &pt100_adc,
         .collect_ch = PT100_0CH,
         .power =
         {
@@ -65,7 +161,9 @@ static pt100_cfg_t pt100_cfg[PT100_MAX_NUM] =
             .Id = ADS1015_IIC,
             .scl = ADS1015_SCL_PIN,
             .sda = ADS1015_SDA_PIN,
+            .addr = PT100_ADC_ADDR,
         },
+        .adc = &pt100_adc,
         .collect_ch = PT100_1CH,
         .power =
         {
@@ -89,6 +187,7 @@ pt100_device_t pt100[PT100_MAX_NUM] =
             .name = "pt100_0",                  //设备名称
             .ops    = &pt100_ops,               //操作函数
             .module = &ads1015,                 //模块
+            .energy = {.current = PT100_CURRENT_UA}, //工作电流
         },
         .cfg = &pt100_cfg[PT100_0],             //配置信息
     },
@@ -99,6 +198,7 @@ pt100_device_t pt100[PT100_MAX_NUM] =
             .name = "pt100_1",                  //设备名称
             .ops    = &pt100_ops,               //操作函数
             .module = &ads1015,                 //模块
+            .energy = {.current = PT100_CURRENT_UA}, //工作电流
         },
         .cfg = &pt100_cfg[PT100_1],             //配置信息
     },
@@ -117,6 +217,7 @@ static sensor_module_t ads1015 =
     .status     = SENSOR_MODULE_CLOSE,
     .open       = ads1015_open,
     .close      = ads1015_close,
+    .energy     = {.current = ADS1015_CURRENT_UA},
 };
 /* Private function prototypes -----------------------------------------------*/
 static bool pt100_open(sensor_device_t dev);
@@ -131,24 +232,137 @@ static const sensor_ops_t pt100_ops =
     .control    = pt100_control,
 };
 /* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  打印采样原始数据
+ * @note   延迟日志单条记录参数有限,固定输出COLLECT_NUM个数据
+ * @param  dev: 设备句柄
+ * @param  tag: 通道或量程
+ * @param  *data: 采样数据
+ */
+static void glbs_log(sensor_device_t dev, uint8_t tag, const ads1015_data_t *data)
+{
+    for(uint8_t i = 0; i < COLLECT_NUM; i++) {
+        SENSOR_LOG_D("[%s][%d]glbs[%d]:%d\r\n", dev->name, tag, i, data[i].value);
+    }
+    (void)dev; (void)tag; (void)data;
+}
+/**
+ * @brief  判断上电是否稳定
+ * @note   相邻两步变化均小于PT100_SETTLE_TOL时判定:同向按指数衰减外推剩余变化量,反向时噪声主导视为稳定
+ * @param  *v: 最近PT100_SETTLE_HIST步电压(mV)
+ * @retval true: 稳定 false: 未稳定
+ */
+static bool settle_check(const float *v)
+{
+    float d1 = v[PT100_SETTLE_SPAN] - v[0];
+    float d2 = v[2 * PT100_SETTLE_SPAN] - v[PT100_SETTLE_SPAN];
+    if(fabsf(d1) > PT100_SETTLE_TOL || fabsf(d2) > PT100_SETTLE_TOL) {
+        return false;
+    }
+    if(d1 * d2 <= 0) {
+        return true;
+    }
+    float r = d2 / d1;
+    if(r > PT100_SETTLE_RMAX) {
+        r = PT100_SETTLE_RMAX;
+    }
+    return fabsf(d2) * r / (1 - r) <= PT100_SETTLE_TOL;
+}
+/**
+ * @brief  等待上电稳定
+ * @note   以高数据率连续采集电源通道直至稳定,最长等待POWER_DELAY;
+ *         学习典型稳定时间,之后延后开始检测,减少I2C占用
+ * @param  *config: 配置信息
+ */
+static void power_settle(pt100_cfg_t *config)
+{
+    uint32_t start = sensor_time_get();
+    ads1015_data_t data[PT100_SETTLE_AVG] = {0};
+    float v[PT100_SETTLE_HIST] = {0};
+    uint8_t num = 0;
+    bool settled = false;
+
+    if(pt100_settle.typical > 0) {
+        HAL_Delay((uint32_t)(pt100_settle.typical * PT100_SETTLE_SKIP));
+    }
+    //配置后首个结果可能为旧配置,丢弃
+    uint8_t ret = ads1015_config(config->adc, config->power.ch, Continuous_Mode, FSR_2048, PT100_SETTLE_DR);
+    if(ret == 0) {
+        ret = ads1015_collect(config->adc, 1, data);
+    }
+    if(ret != 0) {
+        //总线异常时不再轮询至POWER_DELAY,由后续采集报告错误
+        SENSOR_LOG_E("power settle adc error:%d\r\n", ret);
+        return;
+    }
+    while(sensor_time_age(start) < POWER_DELAY) {
+        float sum = 0;
+        uint8_t n = 0;
+        memset(data, 0, sizeof(data));
+        //单次失败按采样点succ剔除
+        ads1015_collect(config->adc, PT100_SETTLE_AVG, data);
+        for(uint8_t i = 0; i < PT100_SETTLE_AVG; i++) {
+            if(data[i].succ) {
+                sum += data[i].mean;
+                n++;
+            }
+        }
+        if(n == 0) {
+            continue;
+        }
+        //FSR_2048下LSB为1mV
+        memmove(v, &v[1], (PT100_SETTLE_HIST - 1) * sizeof(float));
+        v[PT100_SETTLE_HIST - 1] = sum / n;
+        if(++num >= PT100_SETTLE_HIST && settle_check(v) == true) {
+            settled = true;
+            break;
+        }
+    }
+
+    uint32_t elapsed = sensor_time_age(start);
+    if(settled == false) {
+        pt100_settle.timeout++;
+        SENSOR_LOG_W("power settle timeout,%dmV\r\n", (int)v[PT100_SETTLE_HIST - 1]);
+        return;
+    }
+    pt100_settle.last = elapsed;
+    if(elapsed > pt100_settle.max) {
+        pt100_settle.max = elapsed;
+    }
+    if(pt100_settle.typical == 0) {
+        pt100_settle.typical = elapsed;
+    } else {
+        pt100_settle.typical += PT100_SETTLE_ALPHA * (elapsed - pt100_settle.typical);
+    }
+    SENSOR_LOG_D("power settle %dms,typical %dms\r\n", (int)elapsed, (int)pt100_settle.typical);
+}
 /**
  * @brief  pt100电源控制
- * @note   电源控制需延时400ms
+ * @note   上电后检测电源通道稳定,最长等待POWER_DELAY;电源已开启时无需等待
  * @param  *config: 配置信息
  * @param  flag: true:开启 false:关闭
  * @retval None
  */
 static void power_control(pt100_cfg_t *config, bool flag)
 {
+    bool powered = (HAL_GPIO_ReadPin(config->power.port, config->power.pin) == config->power.on);
+#if (PT100_REF_CACHE == 1)
+    //电源共用,开关后所有通道的激励电流需重新测量
+    if(powered != flag) {
+        memset(pt100_ref, 0, sizeof(pt100_ref));
+    }
+#endif
     if (flag == true) {
         HAL_GPIO_WritePin(config->power.port, config->power.pin, config->power.on);
-        HAL_Delay(POWER_DELAY);
+        if(powered == false) {
+            power_settle(config);
+        }
     } else
     {
         HAL_GPIO_WritePin(config->power.port, config->power.pin, !config->power.on);
     }
 #if(POWER_DEBUG == 1)
-    printf("power %lu\r\n", GpioRead(&config->power.obj));
+    SENSOR_LOG_D("power %d\r\n", HAL_GPIO_ReadPin(config->power.port, config->power.pin));
 #endif /* (POWER_DEBUG == 1) */
 }
 /**
@@ -175,7 +389,7 @@ static bool ads1015_open(sensor_device_t dev)
 {
     FIND_CFG(pt100_cfg_t, dev);
     config->i2c.obj = ntag_i2c_init();
-    ads1015_init(config->i2c.obj);
+    ads1015_init(config->adc, config->i2c.obj, config->i2c.addr);
     return true;
 }
 /**
@@ -223,45 +437,31 @@ static bool pt100_close(sensor_device_t dev)
  * R0 = resistance at temperature 0℃ (ohm)
  * t = temperature (oC)
  * PT100传感器在0°C时的电阻值为100欧姆;在100°C时的电阻值为138.5欧姆
- * 使用迭代公式计算出第二次迭代后的温度值。这个过程会一直重复，直到温度值收敛（即两次迭代后的温度值之差小于0.001）或者达到最大迭代次数（即50次）。
+ * 0℃以上C=0,方程为二次方程,直接求根;根式写为t = 2x/(A + sqrt(A^2 + 4Bx)),x = Rt/R0 - 1,避免单精度相减抵消;
+ * 0℃以下查编译期生成的电阻表,二分查找所在区间后线性插值
  * @param  resistance: 电阻值
  * @retval 温度值;返回3276.7表示错误
  */
 static float pt100_calculation(float resistance)
 {
-    double fT = 0, fR = 0, fT0 = 0;
-
-    //printf("===resistance = %f\n",resistance);
-    fR = resistance;
-    fT0 = (fR / 100 - 1) / A;
-    if(fR >= 18.52 && fR < 100) { //-200C° ~ 0C°
-        //而在0°C以下，使用的是完整版的Callendar-Van Dusen方程，即R(T) = R0(1+AT +B(T)2 +C(T)3(T − 100))。
-        for(int i = 0;i < 50;i++) {
-            //迭代法来求解温度值
-            fT = fT0+(fR-100*(1+A*fT0+B*fT0*fT0-100*C*fT0*fT0*fT0+C*fT0*fT0*fT0*fT0))/(100*(A+2*B*fT0-300*C*fT0*fT0+4*C*fT0*fT0*fT0));
-            if(fabs(fT-fT0 < 0.001)) {
-                break;
+    if(resistance >= 100.0f && resistance <= PT100_R_MAX) { //0C° ~ 850C°
+        float x = resistance / (float)PT100_R0 - 1.0f;
+        return 2.0f * x / ((float)A + sqrtf((float)(A * A) + 4.0f * (float)B * x));
+    } else if(resistance >= PT100_R_MIN && resistance < 100.0f) { //-200C° ~ 0C°
+        uint8_t lo = 0, hi = PT100_LUT_NUM - 1;
+        while(hi - lo > 1) {
+            uint8_t mid = (lo + hi) / 2;
+            if(resistance < pt100_lut[mid]) {
+                hi = mid;
             } else {
-                fT0=fT;
+                lo = mid;
             }
         }
-//      printf("%.3f \r\n",fT);
-    } else if(fR >= 100 && fR <= 390.481) { //0°C ~ 849.99°C
-        //在0°C以上，使用的是简化版的Callendar-Van Dusen方程，即R(T) = R0(1+AT +B(T)2)；
-        for(int i = 0;i < 50;i++) {
-            fT = fT0+(fR-100*(1+A*fT0+B*fT0*fT0))/(100*(A+2*B*fT0));
-            if(fabs(fT - fT0 < 0.001)) {
-                break;
-            } else {
-                fT0=fT;
-            }
-        }
-//      printf("%.3f \r\n",fT);
+        float frac = (resistance - pt100_lut[lo]) / (pt100_lut[hi] - pt100_lut[lo]);
+        return PT100_LUT_MIN + (lo + frac) * PT100_LUT_STEP;
     } else {
-        fT = 3276.7;
+        return PT100_T_ERR;
     }
-
-    return (float)fT;
 }
 /**
  * @brief  滤波
@@ -278,7 +478,7 @@ static bool glbs_filter(ads1015_data_t *data, uint8_t num, float *result)
 
     for(uint8_t i = 0; i < num && i < 10; i++) {
         if(data[i].succ) {
-            buffer[count++] = data[i].value;
+            buffer[count++] = data[i].mean;
         }
     }
 
@@ -290,107 +490,293 @@ static bool glbs_filter(ads1015_data_t *data, uint8_t num, float *result)
     }
 }
 /**
- * @brief  PT100数据采集
- * @note  None
+ * @brief  计算参考电压
+ * @note   参考电阻上的电压,用于计算激励电流
  * @param  dev: 设备句柄
- * @param  *data: 数据存储地址
- * @param  len: 数据长度
- * @retval 错误码
+ * @param  *config: 配置信息
+ * @param  *data: 电源通道采样数据
+ * @param  *ref_voltage: 参考电压(mV)
+ * @retval true: 成功 false: 失败
  */
-static bool pt100_collect(sensor_device_t dev)
+static bool ref_voltage_filter(sensor_device_t dev, pt100_cfg_t *config, ads1015_data_t *data, float *ref_voltage)
 {
-    FIND_CFG(pt100_cfg_t, dev);
+    glbs_log(dev, config->power.ch, data);
+    //滤波
+    if(glbs_filter(data, COLLECT_NUM, ref_voltage) == false) {
+        SENSOR_LOG_E("[%s][error]glbs_filter data error\r\n", dev->name);
+        return false;
+    }
+    return true;
+}
+#if (PT100_REF_CACHE == 1)
+/**
+ * @brief  查找参考电压缓存
+ * @note   电源通道相同的配置共用第一个配置的缓存
+ * @param  *config: 配置信息
+ * @retval 缓存
+ */
+static pt100_ref_t *ref_find(pt100_cfg_t *config)
+{
+    for(uint8_t i = 0; i < PT100_MAX_NUM; i++) {
+        if(pt100_cfg[i].power.ch == config->power.ch) {
+            return &pt100_ref[i];
+        }
+    }
+    return NULL;
+}
+#endif
+/**
+ * @brief  获取缓存的参考电压
+ * @note   PT100_REF_CACHE使能时,同一上电区间内电源通道相同的配置复用测量结果,
+ *         超过PT100_REF_REVALID需重新测量
+ * @param  *config: 配置信息
+ * @param  *ref_voltage: 参考电压(mV)
+ * @retval true: 缓存有效 false: 需重新测量
+ */
+static bool ref_cache_get(pt100_cfg_t *config, float *ref_voltage)
+{
+#if (PT100_REF_CACHE == 1)
+    pt100_ref_t *ref = ref_find(config);
+    if(ref->valid == true && sensor_time_age(ref->ts) < PT100_REF_REVALID) {
+        *ref_voltage = ref->voltage;
+        return true;
+    }
+#endif
+    return false;
+}
+/**
+ * @brief  更新参考电压缓存
+ * @note   与缓存偏差超过PT100_REF_DRIFT时告警
+ * @param  dev: 设备句柄
+ * @param  *config: 配置信息
+ * @param  ref_voltage: 参考电压(mV)
+ * @param  succ: 测量是否成功,失败时缓存失效
+ */
+static void ref_cache_put(sensor_device_t dev, pt100_cfg_t *config, float ref_voltage, bool succ)
+{
+#if (PT100_REF_CACHE == 1)
+    pt100_ref_t *ref = ref_find(config);
+    if(succ == false) {
+        ref->valid = false;
+        return;
+    }
+    if(ref->valid == true && fabsf(ref_voltage - ref->voltage) > ref->voltage * PT100_REF_DRIFT) {
+        SENSOR_LOG_W("[%s]ref voltage drift %.2f -> %.2fmV\r\n", dev->name, ref->voltage, ref_voltage);
+    }
+    ref->valid = true;
+    ref->voltage = ref_voltage;
+    ref->ts = sensor_time_get();
+#endif
+}
+/**
+ * @brief  预测量程
+ * @note   按上次电压与变化趋势预测本次电压,超过当前量程PT100_RANGE_UP时增大一档,
+ *         低于更小量程PT100_RANGE_DOWN时减小一档,两阈值间保持当前量程
+ * @param  *config: 配置信息
+ * @retval 量程
+ */
+static uint8_t range_predict(pt100_cfg_t *config)
+{
+    uint8_t fsr = config->FSR;
+    if(config->last <= 0) {
+        return fsr;
+    }
 
+    float predict = config->last + config->trend;
+    if(fsr > PT100_FSR_COARSE && predict > PT100_RANGE_UP * PT100_CODE_FS * pt100_lsb[fsr]) {
+        fsr--;
+    } else if(fsr < PT100_FSR_FINE && predict < PT100_RANGE_DOWN * PT100_CODE_FS * pt100_lsb[fsr + 1]) {
+        fsr++;
+    }
+    return fsr;
+}
+/**
+ * @brief  判断采样是否削顶
+ * @param  *data: 采样数据
+ * @param  num: 采样数量
+ * @retval true: 削顶 false: 未削顶
+ */
+static bool range_clipped(const ads1015_data_t *data, uint8_t num)
+{
+    for(uint8_t i = 0; i < num; i++) {
+        if(data[i].succ && data[i].clip) {
+            return true;
+        }
+    }
+    return false;
+}
+/**
+ * @brief  PT100温度换算
+ * @note   按参考电压计算激励电流;温度通道削顶时增大量程重采,最大量程仍削顶按超量程输出
+ * @param  dev: 设备句柄
+ * @param  *config: 配置信息
+ * @param  ref_voltage: 参考电压(mV)
+ * @param  *ads1015_data: 温度通道采样数据
+ * @retval true: 成功 false: 失败
+ */
+static bool pt100_convert(sensor_device_t dev, pt100_cfg_t *config, float ref_voltage, ads1015_data_t *ads1015_data)
+{
     HAL_StatusTypeDef ret = HAL_OK;
-
-    float ref_voltage = 0;
     float ref_current = 0;
     float voltage = 0;
     float resistance = 0;
-    ads1015_data_t ads1015_data[COLLECT_NUM] = {0};
-    printf("[%s]collect\r\n", dev->name);
-    //采集电源数据
-    ret = ads1015_extend_collect(config->power.ch, Continuous_Mode, FSR_2048, COLLECT_NUM, ads1015_data);
-    if(ret != HAL_OK) {
-        printf("[error]%s collect power error,ret = %d\r\n", dev->name, ret);
-        return false;
-    }
-    //打印
-    printf("power.ch = %d,ref glbs:", config->power.ch);
-    for(uint8_t i = 0; i < COLLECT_NUM; i++) {
-        printf("%d ", ads1015_data[i].value);
-    }
-    printf("\r\n");
-    //滤波
-    if(glbs_filter(ads1015_data, COLLECT_NUM, &ref_voltage) == false) {
-        printf("[error]%s glbs_filter data error\r\n", dev->name);
-        return false;
-    }
+
     //判断为门磁
     if(ref_voltage >= REF_V) {
         config->raw = 32767;
-        printf("ref_voltage > %dmv is mcs\r\n", REF_V);
+        config->timestamp = sensor_time_get();
+        SENSOR_LOG_I("[%s]ref_voltage > %dmv is mcs\r\n", dev->name, REF_V);
         return true;
     }
     //R10 1.8K
     //由于FSR配置为2.048V,LSB为1mV,所以需要* 1
     ref_current = ref_voltage / 1800 * 1;
-    //清零
-    memset(ads1015_data, 0, sizeof(ads1015_data));
-    //采集温度数据
-    ret = ads1015_extend_collect(config->collect_ch, Continuous_Mode, config->FSR, COLLECT_NUM, ads1015_data);
-    if(ret != HAL_OK) {
-        printf("[error]%s collect data error,ret = %d\r\n", dev->name, ret);
-        return false;
+    //温度数据
+    glbs_log(dev, config->FSR, ads1015_data);
+    while(range_clipped(ads1015_data, COLLECT_NUM) == true && config->FSR > PT100_FSR_COARSE) {
+        config->FSR--;
+        config->resample++;
+        SENSOR_LOG_W("[%s]clipped,FSR -> %d\r\n", dev->name, config->FSR);
+        memset(ads1015_data, 0, COLLECT_NUM * sizeof(ads1015_data_t));
+        ret = ads1015_extend_collect_dr(config->adc, config->collect_ch, Continuous_Mode,
+                                        (ads1015_fsr_t)config->FSR, config->dr, config->oversample,
+                                        COLLECT_NUM, ads1015_data);
+        if(ret != HAL_OK) {
+            SENSOR_LOG_E("[%s][error]collect data error,ret = %d\r\n", dev->name, ret);
+            return false;
+        }
+        glbs_log(dev, config->FSR, ads1015_data);
     }
-    //打印
-    printf("FSR = %d, voltage glbs:", config->FSR);
-    for(uint8_t i = 0; i < COLLECT_NUM; i++) {
-        printf("%d ", ads1015_data[i].value);
+    //最大量程仍削顶,电压超出可测范围(传感器开路等),按超量程输出,不参与量程预测
+    if(range_clipped(ads1015_data, COLLECT_NUM) == true) {
+        config->last = 0;
+        config->trend = 0;
+        config->raw = PT100_T_ERR;
+        config->timestamp = sensor_time_get();
+        SENSOR_LOG_E("[%s][error]clipped at FSR %d\r\n", dev->name, config->FSR);
+        return true;
     }
-    printf("\r\n");
     //滤波
     if(glbs_filter(ads1015_data, COLLECT_NUM, &voltage) == false) {
-        printf("[error]%s glbs_filter data error\r\n", dev->name);
+        SENSOR_LOG_E("[%s][error]glbs_filter data error\r\n", dev->name);
         return false;
     }
-    if(voltage >= 2000 && config->FSR == FSR_0256) {
-        //FSR=256时,计算的电阻值大于250,可以判断为需要切换FSR;
-        //FSR=512时,电阻值不能大于500
-        config->FSR = FSR_0512;
-        ret = ads1015_extend_collect(config->collect_ch, Continuous_Mode, config->FSR, COLLECT_NUM, ads1015_data);
-        if(ret != HAL_OK) {
-            printf("[error]%s collect data error,ret = %d\r\n", dev->name, ret);
-            return false;
-        }
-        //打印
-        printf("FSR = %d, voltage glbs:", config->FSR);
-        for(uint8_t i = 0; i < COLLECT_NUM; i++) {
-            printf("%d ", ads1015_data[i].value);
-        }
-        printf("\r\n");
-        //滤波
-        if(glbs_filter(ads1015_data, COLLECT_NUM, &voltage) == false) {
-            printf("[error]%s glbs_filter data error\r\n", dev->name);
-            return false;
-        }
-    }
-    if (config->FSR == FSR_0256) {
-        //由于FSR配置为256,LSB为0.125mV,所以需要* 0.125
-        voltage *= 0.125;
-    }else if (config->FSR == FSR_0512) {
-        //由于FSR配置为256,LSB为0.25mV,所以需要* 0.25
-        voltage *= 0.25;
+    voltage *= pt100_lsb[config->FSR];
+    if(config->last > 0) {
+        config->trend = voltage - config->last;
     }
+    config->last = voltage;
 
     resistance = voltage / ref_current;
     config->raw = pt100_calculation(resistance);
-    printf("ref_current = %smA\r\n", ftoc(ref_current, 2));
-    printf("voltage     = %smV\r\n", ftoc(voltage, 2));
-    printf("resistance  = %sΩ\r\n",  ftoc(resistance, 2));
-    printf("raw:%s\r\n", ftoc(config->raw, 3));
+    config->timestamp = sensor_time_get();
+    SENSOR_LOG_D("[%s]ref_current = %.2fmA,voltage = %.2fmV,resistance = %.2fΩ\r\n",
+                 dev->name, ref_current, voltage, resistance);
+    SENSOR_LOG_D("[%s]raw:%.3f\r\n", dev->name, config->raw);
     return true;
 }
+/**
+ * @brief  PT100数据采集
+ * @note   模块读取后其他成员的采集被跳过,因此同一ADS1015上已打开的成员一并采集:
+ *         各成员的电源通道与温度通道组成一个扫描列表,一次加锁完成;参考电压已缓存时只采温度通道;
+ *         其他成员失败时按超量程输出,返回值只反映本设备
+ * @param  dev: 设备句柄
+ * @retval true: 成功 false: 失败
+ */
+static bool pt100_collect(sensor_device_t dev)
+{
+    FIND_CFG(pt100_cfg_t, dev);
+
+    HAL_StatusTypeDef ret = HAL_OK;
+    sensor_device_t member[PT100_MAX_NUM];
+    pt100_cfg_t *member_cfg[PT100_MAX_NUM];
+    float ref_voltage[PT100_MAX_NUM] = {0};
+    bool ref_ok[PT100_MAX_NUM] = {0};
+    uint8_t ref_entry[PT100_MAX_NUM];
+    uint8_t rtd_entry[PT100_MAX_NUM];
+    ads1015_data_t scan_data[2 * PT100_MAX_NUM * COLLECT_NUM] = {0};
+    ads1015_scan_t scan[2 * PT100_MAX_NUM];
+    uint8_t member_num = 0;
+    uint8_t scan_num = 0;
+    bool result = true;
+    SENSOR_LOG_D("[%s]collect\r\n", dev->name);
+    //本设备在前,其后为同一ADS1015上已打开的其他成员
+    member[member_num++] = dev;
+    for(uint8_t i = 0; dev->module != NULL && i < dev->module->sen_num; i++) {
+        sensor_device_t sen = dev->module->sen[i];
+        pt100_cfg_t *cfg = (sen != NULL && sen != dev) ? find_cfg(sen) : NULL;
+        if(cfg != NULL && cfg->adc == config->adc && sen->energy.powered == true && member_num < PT100_MAX_NUM) {
+            member[member_num++] = sen;
+        }
+    }
+    for(uint8_t m = 0; m < member_num; m++) {
+        pt100_cfg_t *cfg = find_cfg(member[m]);
+        member_cfg[m] = cfg;
+        if(cfg->oversample == 0) {
+            ads1015_rate_select(cfg->adc, (ads1015_fsr_t)cfg->FSR, PT100_ADC_NOISE_IN, PT100_ADC_NOISE,
+                                PT100_ADC_LATENCY, &cfg->dr, &cfg->oversample);
+            SENSOR_LOG_I("[%s]dr %d,oversample %d\r\n", member[m]->name, cfg->dr, cfg->oversample);
+        }
+        //参考电压已缓存时只采温度通道,电源通道相同的成员共用一项
+        ref_entry[m] = 0xFF;
+        if(ref_cache_get(cfg, &ref_voltage[m]) == false) {
+            for(uint8_t k = 0; k < m; k++) {
+                if(ref_entry[k] != 0xFF && member_cfg[k]->power.ch == cfg->power.ch) {
+                    ref_entry[m] = ref_entry[k];
+                }
+            }
+            if(ref_entry[m] == 0xFF) {
+                ref_entry[m] = scan_num;
+                scan[scan_num++] = (ads1015_scan_t){cfg->power.ch, FSR_2048, SPS_128, 1, COLLECT_NUM};
+            }
+        }
+        //量程按上次结果预测,仅实际削顶时增大量程重采
+        cfg->FSR = range_predict(cfg);
+        rtd_entry[m] = scan_num;
+        scan[scan_num++] = (ads1015_scan_t){cfg->collect_ch, (ads1015_fsr_t)cfg->FSR,
+                                            cfg->dr, cfg->oversample, COLLECT_NUM};
+    }
+    ret = ads1015_scan(config->adc, scan, scan_num, Continuous_Mode, scan_data, 2 * PT100_MAX_NUM * COLLECT_NUM);
+    if(ret != HAL_OK) {
+        SENSOR_LOG_E("[%s][error]collect data error,ret = %d\r\n", dev->name, ret);
+        for(uint8_t m = 0; m < member_num; m++) {
+            if(ref_entry[m] != 0xFF) {
+                ref_cache_put(member[m], member_cfg[m], 0, false);
+            }
+        }
+        return false;
+    }
+    for(uint8_t m = 0; m < member_num; m++) {
+        bool succ = true;
+        //电源数据,共用项只滤波一次
+        if(ref_entry[m] != 0xFF) {
+            uint8_t k = 0;
+            while(ref_entry[k] != ref_entry[m]) {
+                k++;
+            }
+            if(k == m) {
+                ref_ok[m] = ref_voltage_filter(member[m], member_cfg[m], &scan_data[ref_entry[m] * COLLECT_NUM],
+                                               &ref_voltage[m]);
+                ref_cache_put(member[m], member_cfg[m], ref_voltage[m], ref_ok[m]);
+            } else {
+                ref_ok[m] = ref_ok[k];
+                ref_voltage[m] = ref_voltage[k];
+            }
+            succ = ref_ok[m];
+        }
+        if(succ == true) {
+            succ = pt100_convert(member[m], member_cfg[m], ref_voltage[m], &scan_data[rtd_entry[m] * COLLECT_NUM]);
+        }
+        if(m == 0) {
+            result = succ;
+        } else if(succ == false) {
+            member_cfg[m]->raw = PT100_T_ERR;
+            member_cfg[m]->timestamp = sensor_time_get();
+            SENSOR_LOG_E("[%s][error]collect with %s failed\r\n", member[m]->name, dev->name);
+        }
+    }
+    return result;
+}
 /**
  * @brief  传感器数据控制
  * @note   
@@ -437,6 +823,16 @@ static bool pt100_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, voi
             }
             break;
         }
+        case SENSOR_CMD_TIME_SET:
+        {
+            config->timestamp = *(uint32_t *)data;
+            break;
+        }
+        case SENSOR_CMD_TIME_GET:
+        {
+            *(uint32_t *)data = config->timestamp;
+            break;
+        }
         default:
             break;
     }
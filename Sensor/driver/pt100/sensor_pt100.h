@@ -26,6 +26,8 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define ADS1015_CURRENT_UA 150 //ADS1015工作电流(uA)
+#define PT100_CURRENT_UA 1700 //参考电阻与PT100激励电流(uA)
 #define PT100_DATA_T float
 /* Exported types ------------------------------------------------------------*/
 /**
@@ -49,12 +51,15 @@ typedef struct
     data_status_e status;       //传感器状态
     PT100_DATA_T value;         //数据值
     PT100_DATA_T raw;           //原始数据
+    uint32_t timestamp;         //采集时间戳(ms)
     struct{
         I2c_t      *obj;        //I2C对象
         I2cId_t     Id;         //I2C编号
         PinNames    scl;        //SCL引脚
         PinNames    sda;        //SDA引脚
+        uint8_t     addr;       //ADS1015地址
     }i2c;
+    ads1015_t       *adc;       //ADS1015实例,地址相同的配置共用
     ads1015_mux_t   collect_ch; //采集通道
     struct{
         GPIO_TypeDef    *port;  //控制端口
@@ -62,7 +67,12 @@ typedef struct
         GPIO_PinState   on;     //开启电平
         ads1015_mux_t   ch;     //电源通道
     }power;
-    uint8_t             FSR;    //满量程范围
+    uint8_t             FSR;    //满量程范围,自动量程调整
+    float               last;   //上次测量电压(mV)
+    float               trend;  //电压变化趋势(mV/次)
+    uint32_t            resample; //削顶重采次数
+    ads1015_dr_t        dr;     //数据率
+    uint8_t             oversample; //每点过采样次数,0表示首次采集时按目标噪声与耗时选择
 }pt100_cfg_t;
 /**
  * @brief  PT100设备对象
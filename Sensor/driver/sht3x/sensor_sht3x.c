@@ -77,6 +77,7 @@ sht3x_device_t sht3x[SHT3X_MAX_NUM] =
             .name   = "sht3x_0",    //设备名称
             .ops    = &sht3x_ops,   //操作函数
             .module = NULL,         //模块
+            .energy = {.current = SHT3X_CURRENT_UA}, //工作电流
         },
         .cfg = &sht3x_cfg[SHT3X_0], //配置信息
     },
@@ -87,6 +88,7 @@ sht3x_device_t sht3x[SHT3X_MAX_NUM] =
             .name   = "sht3x_1",    //设备名称
             .ops    = &sht3x_ops,   //操作函数
             .module = NULL,         //模块
+            .energy = {.current = SHT3X_CURRENT_UA}, //工作电流
         },
         .cfg = &sht3x_cfg[SHT3X_1], //配置信息
     },
@@ -145,7 +147,7 @@ static void sht3x_delay(uint32_t delay)
 static bool sht3x_i2c_read(I2C_HandleTypeDef *hi2c, uint8_t *data, uint16_t datasize)
 {
     if (HAL_I2C_Master_Receive(hi2c, (0x44<<1 | 1), data, datasize, 100) != HAL_OK) {
-        printf_error("[sht3x]:read failed!\r\n");
+        SENSOR_LOG_E("[sht3x]:read failed!\r\n");
         return false;
     } else {
         return true;
@@ -157,7 +159,7 @@ static bool sht3x_i2c_read(I2C_HandleTypeDef *hi2c, uint8_t *data, uint16_t data
 static bool sht3x_i2c_write(I2C_HandleTypeDef *hi2c, uint8_t *data, uint16_t datasize)
 {
     if (HAL_I2C_Master_Transmit(hi2c, (0x44<<1 | 0), data, datasize, 100) != HAL_OK) {
-        printf_error("[sht3x]:write failed!\r\n");
+        SENSOR_LOG_E("[sht3x]:write failed!\r\n");
         return false;
     } else {
         return true;
@@ -219,10 +221,13 @@ static bool sht3x_collect(sensor_device_t dev)
     if(sht3x_collect_process(&config->device) == false) {
         return false;
     } else {
+        uint32_t ts = sensor_time_get();
+        config->timestamp[SHT3X_DATA_TEMPERATURE] = ts;
+        config->timestamp[SHT3X_DATA_HUMIDITY] = ts;
         sht3x_get_current_temp(&config->device, &config->raw[SHT3X_DATA_TEMPERATURE]);
         sht3x_get_current_humi(&config->device, &config->raw[SHT3X_DATA_HUMIDITY]);
-        printf("[%s]temp raw:%s\r\n", dev->name, ftoc(config->raw[SHT3X_DATA_TEMPERATURE], 3));
-        printf("[%s]humi raw:%s\r\n", dev->name, ftoc(config->raw[SHT3X_DATA_HUMIDITY], 3));
+        SENSOR_LOG_D("[%s]temp raw:%.3f humi raw:%.3f\r\n", dev->name,
+                     config->raw[SHT3X_DATA_TEMPERATURE], config->raw[SHT3X_DATA_HUMIDITY]);
         return true;
     }
 }
@@ -302,6 +307,33 @@ static bool sht3x_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, voi
             }
             break;
         }
+        case SENSOR_CMD_TIME_SET:
+        {
+            uint8_t id = *(uint8_t *)arg;
+            if(id > SENSOR_DATA_GET_RAW - SHT3X_DATA_MAX) {
+                //原始数据与数据值共用时间戳
+                id = SENSOR_DATA_GET_RAW - id;
+            }
+            if(id < SHT3X_DATA_MAX){
+                config->timestamp[id] = *(uint32_t *)data;
+            } else {
+                return false;
+            }
+            break;
+        }
+        case SENSOR_CMD_TIME_GET:
+        {
+            uint8_t id = *(uint8_t *)arg;
+            if(id > SENSOR_DATA_GET_RAW - SHT3X_DATA_MAX) {
+                id = SENSOR_DATA_GET_RAW - id;
+            }
+            if(id < SHT3X_DATA_MAX){
+                *(uint32_t *)data = config->timestamp[id];
+            } else {
+                return false;
+            }
+            break;
+        }
         default:
             break;
     }
@@ -23,6 +23,7 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define SHT3X_CURRENT_UA 800 //测量电流典型值(uA)
 #define SHT3X_DATA_T float
 /* Exported types ------------------------------------------------------------*/
 /**
@@ -55,6 +56,7 @@ typedef struct
     data_status_e status[SHT3X_DATA_MAX];   //传感器状态
     SHT3X_DATA_T value[SHT3X_DATA_MAX];
     SHT3X_DATA_T raw[SHT3X_DATA_MAX];       //原始数据
+    uint32_t timestamp[SHT3X_DATA_MAX];   //采集时间戳(ms)
     sht3x_handle_t  device;
     void (*i2c_init)(void);
 }sht3x_driver_cfg_t;
@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <string.h>
 #include "sht3x.h"
+#include "sensor_log.h"
+#include "sensor_time.h"
 static bool SHT3X_GetTempAndHumi(sht3x_handle_t *dev, uint16_t mode);
 static void sht3x_avg_calculate(sht3x_handle_t *dev);
 static uint8_t SHT3X_CalcCrc(uint8_t data[], uint8_t nbrOfBytes);
@@ -37,7 +39,7 @@ void sht3x_init(sht3x_handle_t *dev)
         }
         if (ret == true) {
             sht3x_avg_calculate(dev);
-            printf("[sht3x]init successful! temp = %d, humi = %d\r\n",
+            SENSOR_LOG_I("[sht3x]init successful! temp = %d, humi = %d\r\n",
                     (int16_t)dev->temp_data.CurValue, (int8_t)dev->humi_data.CurValue);
             return;
         } else {
@@ -45,7 +47,7 @@ void sht3x_init(sht3x_handle_t *dev)
             dev->attempt = true;
         }
     }
-    printf("[sht3x]:init failed!\r\n");
+    SENSOR_LOG_E("[sht3x]:init failed!\r\n");
 }
 
 
@@ -66,10 +68,10 @@ bool sht3x_collect_process(sht3x_handle_t *dev)
         // 只尝试采集一次
         ret = SHT3X_GetTempAndHumi(dev, CMD_MEAS_POLLING_L);
     } else {
-        // 尝试采集三次，都失败时认为采集失败
+        // 尝试采集三次，都失败时认为采集失败;超过截止时间不再重试
         for (uint8_t i = 0; i < 3; i++) {
             ret = SHT3X_GetTempAndHumi(dev, CMD_MEAS_POLLING_L);
-            if (ret == true) {
+            if (ret == true || sensor_deadline_expired() == true) {
                 break;
             } else {
                 dev->reset(dev->hi2c, &dev->power);
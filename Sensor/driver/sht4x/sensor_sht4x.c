@@ -47,6 +47,7 @@ sht4x_device_t sht4x =
         .name   = "sht4x",      //设备名称
         .ops    = &sht4x_ops,   //操作函数
         .module = NULL,         //模块
+        .energy = {.current = SHT4X_CURRENT_UA}, //工作电流
     },
     .cfg = &sht4x_cfg, //配置信息
 };
@@ -98,7 +99,7 @@ static void sht4x_delay(uint32_t delay)
 static bool sht4x_i2c_read(uint8_t address, uint8_t *data, uint16_t datasize)
 {
     if (HAL_I2C_Master_Receive(&SHT4X_I2C, (address << 1 | 1), data, datasize, I2C_TIMEOUT_MS) != HAL_OK) {
-        printf_error("[sht4x]:read failed!\r\n");
+        SENSOR_LOG_E("[sht4x]:read failed!\r\n");
         return false;
     } else {
         return true;
@@ -115,7 +116,7 @@ static bool sht4x_i2c_read(uint8_t address, uint8_t *data, uint16_t datasize)
 static bool sht4x_i2c_write(uint8_t address, uint8_t *data, uint16_t datasize)
 {
     if (HAL_I2C_Master_Transmit(&SHT4X_I2C, (address << 1 | 0), data, datasize, I2C_TIMEOUT_MS) != HAL_OK) {
-        printf_error("[sht4x]:write failed!\r\n");
+        SENSOR_LOG_E("[sht4x]:write failed!\r\n");
         return false;
     } else {
         return true;
@@ -149,11 +150,13 @@ static bool sht4x_collect(sensor_device_t dev)
     if(ret == true) {
         config->raw[SHT4X_DATA_TEMPERATURE] = config->handle.temperature;
         config->raw[SHT4X_DATA_HUMIDITY] = config->handle.humidity;
-        printf("[%s]temp raw:%s\r\n", dev->name, ftoc(config->raw[SHT4X_DATA_TEMPERATURE], 3));
-        printf("[%s]humi raw:%s\r\n", dev->name, ftoc(config->raw[SHT4X_DATA_HUMIDITY], 3));
+        config->timestamp[SHT4X_DATA_TEMPERATURE] = sensor_time_get();
+        config->timestamp[SHT4X_DATA_HUMIDITY] = config->timestamp[SHT4X_DATA_TEMPERATURE];
+        SENSOR_LOG_D("[%s]temp raw:%.3f humi raw:%.3f\r\n", dev->name,
+                     config->raw[SHT4X_DATA_TEMPERATURE], config->raw[SHT4X_DATA_HUMIDITY]);
         return true;
     } else {
-        printf_error("[%s]collect failed\r\n", dev->name);
+        SENSOR_LOG_E("[%s]collect failed\r\n", dev->name);
         return false;
     }
 
@@ -233,6 +236,33 @@ static bool sht4x_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, voi
             }
             break;
         }
+        case SENSOR_CMD_TIME_SET:
+        {
+            uint8_t id = *(uint8_t *)arg;
+            if(id > SENSOR_DATA_GET_RAW - SHT4X_DATA_MAX) {
+                //原始数据与数据值共用时间戳
+                id = SENSOR_DATA_GET_RAW - id;
+            }
+            if(id < SHT4X_DATA_MAX){
+                config->timestamp[id] = *(uint32_t *)data;
+            } else {
+                return false;
+            }
+            break;
+        }
+        case SENSOR_CMD_TIME_GET:
+        {
+            uint8_t id = *(uint8_t *)arg;
+            if(id > SENSOR_DATA_GET_RAW - SHT4X_DATA_MAX) {
+                id = SENSOR_DATA_GET_RAW - id;
+            }
+            if(id < SHT4X_DATA_MAX){
+                *(uint32_t *)data = config->timestamp[id];
+            } else {
+                return false;
+            }
+            break;
+        }
         default:
             break;
     }
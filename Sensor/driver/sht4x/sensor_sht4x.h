@@ -24,6 +24,7 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define SHT4X_CURRENT_UA 500 //测量电流典型值(uA)
 #define SHT4X_DATA_T float
 /* Exported types ------------------------------------------------------------*/
 /**
@@ -47,6 +48,7 @@ typedef struct
     data_status_e status[SHT4X_DATA_MAX];   //传感器状态
     SHT4X_DATA_T value[SHT4X_DATA_MAX];
     SHT4X_DATA_T raw[SHT4X_DATA_MAX];       //原始数据
+    uint32_t timestamp[SHT4X_DATA_MAX];   //采集时间戳(ms)
     void (*i2c_init)(void);
     sht4x_handle_t      handle;
 }sht4x_driver_cfg_t;
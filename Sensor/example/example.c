@@ -13,25 +13,68 @@
 /* Includes ------------------------------------------------------------------*/
 #include "sensor_builder.h"
 #include "sensor_default.h"
+#include "sensor_sched.h"
+#include "sensor_store.h"
 /* Private includes ----------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
+/**
+ * @brief  数据存储记录
+ * @note   每通道一条,时间戳由存储记录头保存
+ */
+typedef struct
+{
+    char     name[12];      //传感器名称
+    uint8_t  id;            //通道
+    uint8_t  status;        //数据状态 data_status_e
+    uint16_t reserved;
+    float    value;         //数据
+}sensor_record_t;
 
 /* Private define ------------------------------------------------------------*/
+#define SENSOR_COLLECT_PERIOD   (60 * 1000) //传感器采集周期(ms)
+#define SENSOR_COLLECT_BUDGET   (3 * 1000)  //采集阶段时间预算(ms),含重采
+#define SENSOR_DAILY_BUDGET     (20 * 1000)         //传感器每日能耗预算(mJ)
+#define SENSOR_PERIOD_MIN       (10 * 1000)         //最小采集周期(ms)
+#define SENSOR_PERIOD_MAX       (10 * 60 * 1000)    //最大采集周期(ms)
+#define SENSOR_SCHED_INTERVAL   (10 * 60 * 1000)    //采集周期重新规划间隔(ms)
+#define SENSOR_LOG_FLUSH_NUM    8                   //每轮输出日志条数上限,避免占用采集时间
+#define SENSOR_STORE_SECTORS    16                  //数据存储扇区数量,每扇区一页
+#ifndef FLASH_SENSOR_STORE_ADDR
+//默认使用Flash末尾,须与用户配置区、升级区不重叠
+#define FLASH_SENSOR_STORE_ADDR (FLASH_END_ADDR + 1 - SENSOR_STORE_SECTORS * FLASH_PAGE_SIZE)
+#endif
 
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
-static void temperature_alarm(sensor_default_cfg_t cfg, void *data);
+static void temperature_alarm(sensor_device_t sensor, sensor_default_cfg_t cfg, const sensor_alarm_event_t *event);
+//温度报警规则:上下限回差1℃,变化率超过0.5℃/s,5次中3次满足报警
+static const sensor_alarm_rule_t temperature_alarm_rule =
+{
+    .enable     = SENSOR_ALARM_HIGH | SENSOR_ALARM_LOW | SENSOR_ALARM_RATE,
+    .high       = 60,
+    .low        = -20,
+    .hysteresis = 1,
+    .rate       = 0.5f,
+    .n          = 3,
+    .m          = 5,
+};
 static bool allow_collect(sensor_device_t sensor, void *cfg);
+static void store_record(sensor_device_t sensor, void *cfg, uint8_t num);
 static sensor_process_ops_t default_process[] = 
 {
     {   .allow      = &allow_collect,
-        .handler    = &default_collect},
+        .handler    = &default_collect,
+        .budget     = SENSOR_COLLECT_BUDGET},
     {   .handler    = &default_calibration},
     {   .handler    = &default_range_check},
     {   .handler    = &default_data_check},
-    {   .handler    = &default_alarm},
+    {   .handler    = &default_alarm_check},
+    {   .handler    = &default_publish},
+    {   .handler    = &store_record},
 };
 };
 /* ------------------------------sht3x--------------------------------------- */
@@ -44,6 +87,7 @@ static sensor_builder_t sht3x_builder[SHT3X_NUM] =
         .process = default_process,
         .process_num = sizeof(default_process) / sizeof(sensor_process_ops_t),
         .ops = &default_builder_ops,
+        .period = SENSOR_COLLECT_PERIOD,
     },
 #endif //I2C1_ENABLE
 #if(I2C3_ENABLE == 1)
@@ -51,6 +95,7 @@ static sensor_builder_t sht3x_builder[SHT3X_NUM] =
         .process = default_process,
         .process_num = sizeof(default_process) / sizeof(sensor_process_ops_t),
         .ops = &default_builder_ops,
+        .period = SENSOR_COLLECT_PERIOD,
     },
 #endif //I2C3_ENABLE
 };
@@ -68,9 +113,13 @@ static struct sensor_default_cfg sht3x_cfg[SHT3X_NUM][2] =
                 .max = 125,
                 .min = -44,
             },
+            .alarm = 
+            {
+                .rule = &temperature_alarm_rule,
+            },
             .ops = 
             {
-                .alarm_handler = temperature_alarm,
+                .alarm_event_handler = temperature_alarm,
             }
         },
         [SENSOR_DATA_HUMIDITY] = 
@@ -98,9 +147,13 @@ static struct sensor_default_cfg sht3x_cfg[SHT3X_NUM][2] =
                 .max = 125,
                 .min = -44,
             },
+            .alarm = 
+            {
+                .rule = &temperature_alarm_rule,
+            },
             .ops = 
             {
-                .alarm_handler = temperature_alarm,
+                .alarm_event_handler = temperature_alarm,
             }
         },
         [SENSOR_DATA_HUMIDITY] = 
@@ -120,16 +173,14 @@ static struct sensor_default_cfg sht3x_cfg[SHT3X_NUM][2] =
 #endif //#(SHT3X_NUM != 0)
 /* ----------------------------ds18b20--------------------------------------- */
 #if(DS18B20_ENABLE == 1)
-//传感器动作构建
-static sensor_builder_t ds18b20_builder = 
-{
-    .allow_mode = false,
-    .process = default_process,
-    .process_num = sizeof(default_process) / sizeof(sensor_process_ops_t),
-    .ops = &default_builder_ops,
-};
+#ifndef DS18B20_MAX_NUM
+#define DS18B20_MAX_NUM     4       //单总线最大设备数量,与驱动一致
+#endif
+//传感器动作构建,搜索到的每个设备一个构建器,注册时初始化
+static sensor_builder_t ds18b20_builder[DS18B20_MAX_NUM];
+static uint8_t ds18b20_num = 0;     //已添加的设备数量
 
-static struct sensor_default_cfg ds18b20_cfg = 
+static const struct sensor_default_cfg ds18b20_cfg_default = 
 {
     .power = DS18B20_CONSUME,
     .unit = 10,//0.1C
@@ -139,12 +190,71 @@ static struct sensor_default_cfg ds18b20_cfg =
         .max = 85,
         .min = -55,
     },
+    .alarm = 
+    {
+        .rule = &temperature_alarm_rule,
+    },
     .ops = 
     {
-        .alarm_handler = temperature_alarm,
+        .alarm_event_handler = temperature_alarm,
     }
 };
+static struct sensor_default_cfg ds18b20_cfg[DS18B20_MAX_NUM];
+#endif //DS18B20_ENABLE == 1
+/* ------------------------------调度---------------------------------------- */
+//未启用任何调度项时不定义调度表,避免空数组
+#define SENSOR_SCHED_ENABLE ((DS18B20_ENABLE == 1) || ((SHT3X_NUM != 0) && ((I2C1_ENABLE == 1) || (I2C3_ENABLE == 1))))
+static sensor_sched_t sensor_sched;
+static bool sensor_sched_ready = false;
+#if (SENSOR_SCHED_ENABLE)
+//DS18B20优先于SHT3X;同一总线的DS18B20按首个设备调度,其余设备由ds18b20_period_sync同步
+static sensor_sched_item_t sensor_sched_item[] =
+{
+#if(DS18B20_ENABLE == 1)
+    {
+        .builder    = &ds18b20_builder[0],
+        .priority   = 2,
+        .min_period = SENSOR_PERIOD_MIN,
+        .max_period = SENSOR_PERIOD_MAX,
+    },
 #endif //DS18B20_ENABLE == 1
+#if (SHT3X_NUM != 0)
+#if(I2C1_ENABLE == 1)
+    {
+        .builder    = &sht3x_builder[SHT3X_ID_I2C1],
+        .priority   = 1,
+        .min_period = SENSOR_PERIOD_MIN,
+        .max_period = SENSOR_PERIOD_MAX,
+    },
+#endif //I2C1_ENABLE
+#if(I2C3_ENABLE == 1)
+    {
+        .builder    = &sht3x_builder[SHT3X_ID_I2C3],
+        .priority   = 1,
+        .min_period = SENSOR_PERIOD_MIN,
+        .max_period = SENSOR_PERIOD_MAX,
+    },
+#endif //I2C3_ENABLE
+#endif //#(SHT3X_NUM != 0)
+};
+#endif //SENSOR_SCHED_ENABLE
+/* ------------------------------存储---------------------------------------- */
+static bool store_flash_read(uint32_t addr, void *data, uint32_t len);
+static bool store_flash_write(uint32_t addr, const void *data, uint32_t len);
+static bool store_flash_erase(uint32_t addr);
+//存储区起始地址由FLASH_SIZE决定,初始化时设置
+static sensor_flash_ops_t sensor_flash =
+{
+    .read           = store_flash_read,
+    .write          = store_flash_write,
+    .erase          = store_flash_erase,
+    .sector_size    = FLASH_PAGE_SIZE,
+    .sector_num     = SENSOR_STORE_SECTORS,
+    .write_align    = 8,
+};
+static sensor_store_t sensor_store;
+static bool sensor_store_ready = false;
+static uint32_t sensor_store_base;  //上电前最新记录时间(s)
 /* Private function prototypes -----------------------------------------------*/
 extern void sensor_register(void);
 /* Private user code ---------------------------------------------------------*/
@@ -161,10 +271,149 @@ static bool allow_collect(sensor_device_t sensor, void *cfg)
 #if (INIT_UART1_ENABLE == 0)
     return true;
 #else
-    printf("[%s]allow %s\r\n", sensor->name, (g_sensor_init_flag == true) ? "true" : "false");
+    SENSOR_LOG_D("[%s]allow %s\r\n", sensor->name, (g_sensor_init_flag == true) ? "true" : "false");
     return g_sensor_init_flag;
 #endif //INIT_UART1_ENABLE == 0
 }
+/* ------------------------------ds18b20---------------------------------------*/
+#if(DS18B20_ENABLE == 1)
+/**
+ * @brief  添加DS18B20传感器
+ * @note   ds18b20_register按搜索结果依次命名为ds18b20,ds18b20_1...,逐个添加至各自构建器
+ */
+static void ds18b20_add(void)
+{
+    char name[12];
+
+    for(uint8_t i = 0; i < DS18B20_MAX_NUM; i++) {
+        if(i == 0) {
+            snprintf(name, sizeof(name), "ds18b20");
+        } else {
+            snprintf(name, sizeof(name), "ds18b20_%d", i);
+        }
+        sensor_device_t sensor = sensor_obj_get(name);
+        if(sensor == NULL) {
+            break;
+        }
+        ds18b20_builder[i].allow_mode = false;
+        ds18b20_builder[i].process = default_process;
+        ds18b20_builder[i].process_num = sizeof(default_process) / sizeof(sensor_process_ops_t);
+        ds18b20_builder[i].ops = &default_builder_ops;
+        ds18b20_builder[i].period = SENSOR_COLLECT_PERIOD;
+        ds18b20_cfg[i] = ds18b20_cfg_default;
+        builder_sensor_add(&ds18b20_builder[i], sensor);
+        builder_config_add(&ds18b20_builder[i], &ds18b20_cfg[i], 1, true);//使用默认配置
+        ds18b20_cfg[i].unit = 10;//0.1C
+        sensor_builder_add(&ds18b20_builder[i]);
+        ds18b20_num++;
+    }
+}
+/**
+ * @brief  DS18B20采集周期同步
+ * @note   调度器只调整首个设备的周期,其余设备沿用首个设备的周期与执行时间,
+ *         同一轮中先执行的设备广播转换,其余设备读取批量转换结果
+ */
+static void ds18b20_period_sync(void)
+{
+    for(uint8_t i = 1; i < ds18b20_num; i++) {
+        ds18b20_builder[i].period = ds18b20_builder[0].period;
+        ds18b20_builder[i].next_run = ds18b20_builder[0].next_run;
+    }
+}
+#endif //DS18B20_ENABLE == 1
+/* ------------------------------存储-----------------------------------------*/
+/**
+ * @brief  读取Flash
+ * @note   Flash按地址映射,直接复制
+ */
+static bool store_flash_read(uint32_t addr, void *data, uint32_t len)
+{
+    memcpy(data, (const void *)addr, len);
+    return true;
+}
+/**
+ * @brief  写入Flash
+ * @note   按双字编程,地址与长度由存储模块按8字节对齐
+ */
+static bool store_flash_write(uint32_t addr, const void *data, uint32_t len)
+{
+    bool ret = true;
+    HAL_FLASH_Unlock();
+    for(uint32_t i = 0; i < len && ret == true; i += 8) {
+        uint64_t dword = 0;
+        memcpy(&dword, (const uint8_t *)data + i, sizeof(dword));
+        ret = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr + i, dword) == HAL_OK);
+    }
+    HAL_FLASH_Lock();
+    return ret;
+}
+/**
+ * @brief  擦除addr所在页
+ */
+static bool store_flash_erase(uint32_t addr)
+{
+    uint32_t error = 0;
+    FLASH_EraseInitTypeDef erase =
+    {
+        .TypeErase  = FLASH_TYPEERASE_PAGES,
+        .Page       = (addr - FLASH_BASE) / FLASH_PAGE_SIZE,
+        .NbPages    = 1,
+    };
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef ret = HAL_FLASHEx_Erase(&erase, &error);
+    HAL_FLASH_Lock();
+    return ret == HAL_OK;
+}
+/**
+ * @brief  存储时间戳(s)
+ * @note   默认以上电前最新记录时间为基准累加运行时间,保证跨上电单调递增;
+ *         平台有RTC时可重写为RTC秒计数
+ * @retval 时间戳
+ */
+__weak uint32_t sensor_store_clock(void)
+{
+    return sensor_store_base + sensor_time_get() / 1000;
+}
+/**
+ * @brief  数据存储处理
+ * @note   置于流程末尾,各通道最终数据与状态追加至Flash日志;存储未就绪时跳过
+ * @param  sensor: 传感器设备
+ * @param  *cfg: 构建器配置
+ */
+static void store_record(sensor_device_t sensor, void *cfg, uint8_t num)
+{
+    if(cfg == NULL || sensor_store_ready == false) {
+        return;
+    }
+    uint32_t ts = sensor_store_clock();
+    for(uint8_t i = 0; i < num; i++) {
+        sensor_record_t record = {0};
+        data_status_e status = DATA_STATUS_NONE;
+        strncpy(record.name, sensor->name, sizeof(record.name) - 1);
+        record.id = i;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &i);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, &record.value, &i);
+        record.status = status;
+        if(sensor_store_append(&sensor_store, ts, &record, sizeof(record)) == false) {
+            SENSOR_LOG_E("[%s][store]append failed\r\n", sensor->name);
+            return;
+        }
+    }
+}
+/**
+ * @brief  数据存储初始化
+ * @note   扫描扇区头恢复索引,记录格式变化时格式化存储区
+ */
+static void store_init(void)
+{
+    sensor_flash.base = FLASH_SENSOR_STORE_ADDR;
+    sensor_store_ready = sensor_store_init(&sensor_store, &sensor_flash, sizeof(sensor_record_t));
+    if(sensor_store_ready == false) {
+        SENSOR_LOG_E("[store]:init failed, samples not logged!\r\n");
+        return;
+    }
+    sensor_store_base = sensor_store_last(&sensor_store) + 1;
+}
 /**
  * @brief 外部调用传感器校准
  * @param *name: 传感器名称
@@ -184,7 +433,7 @@ void sensor_change_to_update(char *name)
  * @note   获取后清除本次采集次数
  * @param  *name: 传感器名称
  * @param  *cnt: 采集次数
- * @param  *power: 采集功耗
+ * @param  *power: 累计能耗(mJ),按上电时间实测,不含模块公共部分
  * @retval 采集次数
  */
 void sensor_get_consume(char *name, uint32_t *cnt, float *power)
@@ -194,7 +443,7 @@ void sensor_get_consume(char *name, uint32_t *cnt, float *power)
         sensor_builder_t *builder = (sensor_builder_t *)sensor->arg;
         sensor_default_cfg_t cfg = (sensor_default_cfg_t )builder->cfg;
         *cnt = cfg->collect.count;
-        *power = cfg->power;
+        *power = sensor_energy_get(sensor);
     }
 }
 /**
@@ -231,6 +480,25 @@ data_status_e sensor_data_get(char *name, float *data, sensor_data_e id)
         return DATA_STATUS_INVALID;
     }
 }
+/**
+ * @brief  获取传感器数据及采集时间戳
+ * @note   时间戳为驱动锁存测量值时刻,数据时长可由sensor_time_age计算
+ * @param  *data: 数据
+ * @param  *ts: 采集时间戳(ms)
+ */
+data_status_e sensor_data_get_ts(char *name, float *data, uint32_t *ts, sensor_data_e id)
+{
+    sensor_device_t sensor = sensor_obj_get(name);
+    if(sensor != NULL) {
+        data_status_e status = DATA_STATUS_NONE;
+        sensor_control(sensor, SENSOR_CMD_STATUS_GET, &status, &id);
+        sensor_control(sensor, SENSOR_CMD_DATA_GET, data, &id);
+        sensor_control(sensor, SENSOR_CMD_TIME_GET, ts, &id);
+        return status;
+    } else {
+        return DATA_STATUS_INVALID;
+    }
+}
 /**
  * @brief  传感器应用任务
  * @note   None
@@ -243,14 +511,8 @@ void StartSensorTask(void *argument)
 
     sensor_register();
 #if(DS18B20_ENABLE == 1)
-    //注册DS18B20传感器
-    sensor = sensor_obj_get("ds18b20");
-    if(sensor != NULL) {
-        builder_sensor_add(&ds18b20_builder, sensor);
-        builder_config_add(&ds18b20_builder, &ds18b20_cfg, sizeof(ds18b20_cfg) / sizeof(struct sensor_default_cfg), true);//使用默认配置
-        ds18b20_cfg.unit = 10;//0.1C
-        sensor_builder_add(&ds18b20_builder);
-    }
+    //注册搜索到的全部DS18B20传感器
+    ds18b20_add();
 #endif  //DS18B20_ENABLE
 #if (INIT_UART1_ENABLE == 0)
 #if (I2C1_ENABLE == 1)
@@ -274,9 +536,27 @@ void StartSensorTask(void *argument)
         sensor_builder_add(&sht3x_builder[SHT3X_ID_I2C3]);
     }
 #endif //I2C3_ENABLE
+    store_init();
     sensor_director_init();
+#if (SENSOR_SCHED_ENABLE)
+    sensor_sched_ready = sensor_sched_init(&sensor_sched, SENSOR_DAILY_BUDGET, SENSOR_SCHED_INTERVAL,
+                                           sensor_sched_item, sizeof(sensor_sched_item) / sizeof(sensor_sched_item_t));
+#endif //SENSOR_SCHED_ENABLE
+    //调度器未启用时构建器按各自周期运行,不按能耗预算调整
+    if(sensor_sched_ready == false) {
+        SENSOR_LOG_E("[sched]:init failed, run with fixed periods!\r\n");
+    }
 
     while (1) {
+        if(sensor_sched_ready == true) {
+            sensor_sched_process(&sensor_sched);
+        }
+#if(DS18B20_ENABLE == 1)
+        ds18b20_period_sync();
+#endif  //DS18B20_ENABLE
         sensor_director_process();
+        //采集动作完成后、进入休眠前输出延迟日志
+        sensor_log_flush(SENSOR_LOG_FLUSH_NUM);
+        sensor_director_sleep();
     }
 }
@@ -0,0 +1,28 @@
+/**
+ * @file NodeSDKConfig.h
+ * @brief 主机测试板级配置桩
+ * @note  仅供Sensor/test下主机测试编译,不参与固件构建
+ */
+#ifndef __NODE_SDK_CONFIG_H__
+#define __NODE_SDK_CONFIG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __weak
+#define __weak __attribute__((weak))
+#endif
+
+//PT100板级引脚与通道
+#define ADS1015_IIC             I2C_2
+#define ADS1015_SCL_PIN         0
+#define ADS1015_SDA_PIN         1
+#define ADS1015_POWER_PORT      ((GPIO_TypeDef *)0)
+#define ADS1015_POWER_PIN       0x0001
+#define ADS1015_POWERON_LEVEL   GPIO_PIN_SET
+#define PT100_0CH               DIFF_0_1
+#define PT100_POWER_0CH         DIFF_2_3
+#define PT100_1CH               DIFF_0_3
+#define PT100_POWER_1CH         DIFF_1_3
+
+#endif /* __NODE_SDK_CONFIG_H__ */
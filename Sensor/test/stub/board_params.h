@@ -0,0 +1,19 @@
+/**
+ * @file board_params.h
+ * @brief 主机测试参数存储桩
+ */
+#ifndef __BOARD_PARAMS_H__
+#define __BOARD_PARAMS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    bool    calibration_enable;
+    int16_t calibration_value;
+}sensor_params_t;
+
+void read_data_from_flash(uint32_t *data, uint32_t len, uint32_t addr);
+
+#endif /* __BOARD_PARAMS_H__ */
@@ -0,0 +1,15 @@
+/**
+ * @file board_system.h
+ * @brief 主机测试系统接口桩
+ */
+#ifndef __BOARD_SYSTEM_H__
+#define __BOARD_SYSTEM_H__
+
+#include <stdint.h>
+#include "stm32wlxx_hal.h"
+
+extern uint32_t host_restart_count;     //设备重启次数
+
+void device_restart(void);
+
+#endif /* __BOARD_SYSTEM_H__ */
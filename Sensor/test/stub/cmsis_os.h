@@ -0,0 +1,19 @@
+/**
+ * @file cmsis_os.h
+ * @brief 主机测试RTOS桩
+ * @note  osDelay推进模拟节拍,不实际等待
+ */
+#ifndef __CMSIS_OS_H__
+#define __CMSIS_OS_H__
+
+#include <stdint.h>
+
+typedef enum
+{
+    osOK = 0,
+    osError = -1,
+}osStatus_t;
+
+osStatus_t osDelay(uint32_t ticks);
+
+#endif /* __CMSIS_OS_H__ */
@@ -0,0 +1,102 @@
+/**
+ * @file host_stub.c
+ * @brief 主机测试平台接口桩
+ * @note  HAL_Delay/osDelay推进模拟节拍,不实际等待;GPIO输出保存在host_gpio;
+ *        HAL_GetTick与HAL库相同为弱定义,忙等查询节拍的测试可重定义为随查询推进;
+ *        NFC共用总线锁加锁次数与持有层数保存在host_lock_count/host_lock_held;
+ *        设备重启不实际执行,次数保存在host_restart_count
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "cmsis_os.h"
+#include "board_system.h"
+#include "board_params.h"
+#include "node_convert.h"
+#include "module_ntag.h"
+#include "node_crc.h"
+
+volatile uint32_t host_tick;
+uint32_t host_gpio;
+uint32_t host_lock_count;
+uint8_t host_lock_held;
+uint32_t host_restart_count;
+
+__weak uint32_t HAL_GetTick(void)
+{
+    return host_tick;
+}
+
+void HAL_Delay(uint32_t ms)
+{
+    host_tick += ms + 1;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+    host_tick += ticks;
+    return osOK;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    (void)port;
+    if(state == GPIO_PIN_SET) {
+        host_gpio |= pin;
+    } else {
+        host_gpio &= ~(uint32_t)pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+    (void)port;
+    return (host_gpio & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+I2c_t *ntag_i2c_init(void)
+{
+    static I2c_t i2c;
+    return &i2c;
+}
+
+void device_restart(void)
+{
+    host_restart_count++;
+}
+
+void read_data_from_flash(uint32_t *data, uint32_t len, uint32_t addr)
+{
+    (void)addr;
+    memset(data, 0, len);
+}
+
+char *ftoc(float value, uint8_t precision)
+{
+    static char buf[24];
+    snprintf(buf, sizeof(buf), "%.*f", precision, value);
+    return buf;
+}
+
+void Error_Handler(void)
+{
+    abort();
+}
+
+uint8_t crc8_maxim(const uint8_t *data, uint16_t len)
+{
+    uint8_t crc = 0;
+    while(len--) {
+        uint8_t byte = *data++;
+        for(uint8_t i = 0; i < 8; i++) {
+            uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if(mix) {
+                crc ^= 0x8C;
+            }
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,10 @@
+/**
+ * @file i2c.h
+ * @brief 主机测试I2C外设桩
+ */
+#ifndef __I2C_H__
+#define __I2C_H__
+
+#include "i2c_sys.h"
+
+#endif /* __I2C_H__ */
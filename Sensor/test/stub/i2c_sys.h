@@ -0,0 +1,28 @@
+/**
+ * @file i2c_sys.h
+ * @brief 主机测试板级I2C接口桩
+ * @note  I2cTransmit/I2cReceive由测试程序按模拟器件实现
+ */
+#ifndef __I2C_SYS_H__
+#define __I2C_SYS_H__
+
+#include <stdint.h>
+
+typedef enum
+{
+    I2C_1 = 0,
+    I2C_2,
+    I2C_3,
+}I2cId_t;
+
+typedef int PinNames;
+
+typedef struct
+{
+    uint8_t id;
+}I2c_t;
+
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size);
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size);
+
+#endif /* __I2C_SYS_H__ */
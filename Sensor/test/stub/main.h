@@ -0,0 +1,12 @@
+/**
+ * @file main.h
+ * @brief 主机测试main.h桩
+ */
+#ifndef __MAIN_H__
+#define __MAIN_H__
+
+#include "stm32wlxx_hal.h"
+
+void Error_Handler(void);
+
+#endif /* __MAIN_H__ */
@@ -0,0 +1,29 @@
+/**
+ * @file module_ntag.h
+ * @brief 主机测试NFC共用总线锁桩
+ * @note  统计加锁次数与当前持有层数,供测试验证总线访问均在锁内
+ */
+#ifndef __MODULE_NTAG_H__
+#define __MODULE_NTAG_H__
+
+#include "i2c_sys.h"
+
+extern uint32_t host_lock_count;    //加锁次数
+extern uint8_t host_lock_held;      //当前持有层数
+
+static inline int ntag_lock(void)
+{
+    host_lock_count++;
+    host_lock_held++;
+    return 0;
+}
+
+static inline int ntag_unlock(void)
+{
+    host_lock_held--;
+    return 0;
+}
+
+I2c_t *ntag_i2c_init(void);
+
+#endif /* __MODULE_NTAG_H__ */
@@ -0,0 +1,12 @@
+/**
+ * @file node_convert.h
+ * @brief 主机测试数据转换桩
+ */
+#ifndef __NODE_CONVERT_H__
+#define __NODE_CONVERT_H__
+
+#include <stdint.h>
+
+char *ftoc(float value, uint8_t precision);
+
+#endif /* __NODE_CONVERT_H__ */
@@ -0,0 +1,12 @@
+/**
+ * @file node_crc.h
+ * @brief 主机测试CRC接口桩
+ */
+#ifndef __NODE_CRC_H__
+#define __NODE_CRC_H__
+
+#include <stdint.h>
+
+uint8_t crc8_maxim(const uint8_t *data, uint16_t len);
+
+#endif /* __NODE_CRC_H__ */
@@ -0,0 +1,13 @@
+/**
+ * @file node_glbs.h
+ * @brief 主机测试格拉布斯滤波桩
+ * @note  由测试程序实现glbs_process
+ */
+#ifndef __NODE_GLBS_H__
+#define __NODE_GLBS_H__
+
+#include <stdint.h>
+
+void glbs_process(float *buf, uint8_t num, float *out);
+
+#endif /* __NODE_GLBS_H__ */
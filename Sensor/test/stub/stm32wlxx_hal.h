@@ -0,0 +1,39 @@
+/**
+ * @file stm32wlxx_hal.h
+ * @brief 主机测试HAL桩
+ * @note  时间由测试程序通过host_tick推进
+ */
+#ifndef __STM32WLXX_HAL_H__
+#define __STM32WLXX_HAL_H__
+
+#include <stdint.h>
+#include "NodeSDKConfig.h"
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT,
+}HAL_StatusTypeDef;
+
+typedef struct
+{
+    uint32_t ODR;
+}GPIO_TypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET,
+}GPIO_PinState;
+
+extern volatile uint32_t host_tick;
+extern uint32_t host_gpio;
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+#endif /* __STM32WLXX_HAL_H__ */
@@ -0,0 +1,57 @@
+/**
+ * @file usart.h
+ * @brief 主机测试串口接口桩
+ * @note  收发由测试程序模拟单总线器件实现:写入TDR后首次查询标志时完成一个时隙并更新RDR
+ */
+#ifndef __USART_H__
+#define __USART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "main.h"
+
+typedef struct
+{
+    volatile uint32_t TDR;
+    volatile uint32_t RDR;
+}USART_TypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+    uint32_t ClockPrescaler;
+}UART_InitTypeDef;
+
+typedef struct
+{
+    USART_TypeDef       *Instance;
+    UART_InitTypeDef    Init;
+}UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B      0
+#define UART_STOPBITS_1         0
+#define UART_PARITY_NONE        0
+#define UART_MODE_TX_RX         0
+#define UART_HWCONTROL_NONE     0
+#define UART_OVERSAMPLING_16    0
+#define UART_PRESCALER_DIV1     0
+
+#define UART_FLAG_RXNE          (1U << 5)
+#define UART_FLAG_TC            (1U << 6)
+
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)   host_uart_flag((__HANDLE__), (__FLAG__))
+
+bool host_uart_flag(UART_HandleTypeDef *huart, uint32_t flag);
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+
+#endif /* __USART_H__ */
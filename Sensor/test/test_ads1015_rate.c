@@ -0,0 +1,210 @@
+/**
+ * @file test_ads1015_rate.c
+ * @brief ADS1015数据率与过采样选择测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 蒙特卡洛仿真(模拟噪声+器件噪声+量化+平均)验证ads1015_rate_noise噪声模型;
+ * 穷举验证ads1015_rate_select;模拟器件验证过采样均值、削顶标记与固定延时耗时模型:
+ * gcc -ISensor/test/stub -ISensor/driver/ads1015 Sensor/test/test_ads1015_rate.c Sensor/test/stub/host_stub.c
+ *     Sensor/driver/ads1015/ads1015.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include "ads1015.h"
+#include "stm32wlxx_hal.h"
+/* Private define ------------------------------------------------------------*/
+#define MC_TRIALS       5000        //每种组合仿真次数
+#define MODEL_TOL       0.10f       //模拟噪声足够时模型与仿真相对偏差上限
+#define SIM_PI          3.14159265358979
+#define CODE_NUM        8           //模拟器件码值序列长度
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static const uint16_t sps[] = {128, 250, 490, 920, 1600, 2400, 3300};
+static uint32_t rand_state = 1;
+static uint16_t sim_reg[4];
+static uint8_t  sim_pointer;
+static int16_t  sim_code[CODE_NUM];
+static uint8_t  sim_code_pos;
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  模拟器件寄存器读写
+ * @note   每次读取转换寄存器返回码值序列中的下一个
+ */
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    sim_pointer = data[0] & 0x03;
+    if(size == 3) {
+        sim_reg[sim_pointer] = (data[1] << 8) | data[2];
+    }
+    return 0;
+}
+
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr; (void)size;
+    uint16_t value = sim_reg[sim_pointer];
+    if(sim_pointer == 0) {
+        value = (uint16_t)(sim_code[sim_code_pos] << 4);
+        sim_code_pos = (sim_code_pos + 1) % CODE_NUM;
+    }
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+    return 0;
+}
+
+static double rand_uniform(void)
+{
+    rand_state = rand_state * 1664525 + 1013904223;
+    return (rand_state + 1.0) / 4294967297.0;
+}
+
+static double rand_gauss(void)
+{
+    return sqrt(-2 * log(rand_uniform())) * cos(2 * SIM_PI * rand_uniform());
+}
+/**
+ * @brief  蒙特卡洛噪声
+ * @param  analog: 模拟噪声(LSB RMS)
+ * @param  adc: 器件噪声(LSB RMS)
+ * @param  n: 过采样次数
+ * @retval 每点噪声(LSB RMS)
+ */
+static double mc_noise(double analog, double adc, uint8_t n)
+{
+    double sum2 = 0;
+    for(uint32_t t = 0; t < MC_TRIALS; t++) {
+        double x = 100 + rand_uniform();
+        double acc = 0;
+        for(uint8_t i = 0; i < n; i++) {
+            acc += floor(x + rand_gauss() * analog + rand_gauss() * adc + 0.5);
+        }
+        acc /= n;
+        sum2 += (acc - x) * (acc - x);
+    }
+    return sqrt(sum2 / MC_TRIALS);
+}
+
+static int test_noise_model(void)
+{
+    static const float analog[] = {1.0f, 0.2f};
+
+    for(uint8_t k = 0; k < 2; k++) {
+        double ratio_min = 1e9, ratio_max = 0;
+        for(uint8_t dr = SPS_128; dr <= SPS_3300; dr++) {
+            //无外部噪声单次转换的模型值去除量化项即为器件噪声
+            float base = ads1015_rate_noise(FSR_0256, 0, (ads1015_dr_t)dr, 1);
+            double adc = sqrt(fmax(base * base - 1.0 / 12, 0));
+            for(uint8_t n = 1; n <= ADS1015_OVERSAMPLE_MAX; n <<= 1) {
+                double model = ads1015_rate_noise(FSR_0256, analog[k], (ads1015_dr_t)dr, n);
+                double mc = mc_noise(analog[k], adc, n);
+                if(analog[k] >= 0.5f) {
+                    //噪声抖动量化误差,模型与仿真一致
+                    TEST_ASSERT(fabs(model - mc) < mc * MODEL_TOL);
+                } else {
+                    //量化误差不随平均下降,模型保守
+                    TEST_ASSERT(model > mc * (1 - MODEL_TOL));
+                }
+                ratio_min = fmin(ratio_min, model / mc);
+                ratio_max = fmax(ratio_max, model / mc);
+            }
+        }
+        printf("noise model: analog %.1f LSB, model/monte carlo %.3f ~ %.3f\r\n", analog[k], ratio_min, ratio_max);
+    }
+    return 0;
+}
+
+static int test_select(void)
+{
+    static ads1015_t dev;
+    static const ads1015_rdy_t rdy[] = {ADS1015_RDY_DELAY, ADS1015_RDY_PIN};
+    //固定延时方式每次转换至少2ms,10ms内只能达到约0.5LSB
+    static const float target[] = {0.6f, 0.3f};
+    ads1015_dr_t dr;
+    uint8_t n;
+
+    for(uint8_t r = 0; r < 2; r++) {
+        ads1015_rdy_set(&dev, rdy[r]);
+        //满足目标的组合中耗时最短
+        TEST_ASSERT(ads1015_rate_select(&dev, FSR_0256, 1.0f, target[r], 10.0f, &dr, &n));
+        float t = ads1015_rate_latency(&dev, dr, n);
+        TEST_ASSERT(t <= 10.0f && ads1015_rate_noise(FSR_0256, 1.0f, dr, n) <= target[r]);
+        for(uint8_t d = SPS_128; d <= SPS_3300; d++) {
+            for(uint16_t k = 1; k <= ADS1015_OVERSAMPLE_MAX; k <<= 1) {
+                if(ads1015_rate_noise(FSR_0256, 1.0f, (ads1015_dr_t)d, k) <= target[r]) {
+                    TEST_ASSERT(ads1015_rate_latency(&dev, (ads1015_dr_t)d, k) >= t);
+                }
+            }
+        }
+        printf("select %s: SPS_%d x%d %.2f ms %.3f LSB\r\n", (r == 0) ? "delay" : "rdy pin",
+               sps[dr], n, t, ads1015_rate_noise(FSR_0256, 1.0f, dr, n));
+
+        //无法满足时选耗时限制内噪声最低者
+        TEST_ASSERT(ads1015_rate_select(&dev, FSR_0256, 1.0f, 0.01f, 10.0f, &dr, &n) == false);
+        float e = ads1015_rate_noise(FSR_0256, 1.0f, dr, n);
+        TEST_ASSERT(ads1015_rate_latency(&dev, dr, n) <= 10.0f);
+        for(uint8_t d = SPS_128; d <= SPS_3300; d++) {
+            for(uint16_t k = 1; k <= ADS1015_OVERSAMPLE_MAX; k <<= 1) {
+                if(ads1015_rate_latency(&dev, (ads1015_dr_t)d, k) <= 10.0f) {
+                    TEST_ASSERT(ads1015_rate_noise(FSR_0256, 1.0f, (ads1015_dr_t)d, k) >= e);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_collect(void)
+{
+    static ads1015_t dev;
+    static I2c_t i2c;
+    static const int16_t codes[CODE_NUM] = {100, 102, 98, 104, -5, -7, 2047, 2045};
+    ads1015_data_t data[2];
+
+    for(uint8_t i = 0; i < CODE_NUM; i++) {
+        sim_code[i] = codes[i];
+    }
+    sim_code_pos = 0;
+    ads1015_init(&dev, &i2c, ADS1015_ADDR_GND);
+    ads1015_rdy_set(&dev, ADS1015_RDY_DELAY);
+    host_tick = 0;
+    TEST_ASSERT(ads1015_extend_collect_dr(&dev, SINGLE_0, SingleShot_Mode, FSR_2048, SPS_1600, 4, 2, data) == 0);
+
+    //每点为4次转换均值,存在满量程码值时标记削顶
+    TEST_ASSERT(data[0].succ && fabsf(data[0].mean - 101.0f) < 1e-4f && data[0].clip == false);
+    TEST_ASSERT(data[0].value == 101);
+    TEST_ASSERT(data[1].succ && fabsf(data[1].mean - 1020.0f) < 1e-4f && data[1].clip == true);
+
+    //固定延时方式实际耗时与耗时模型一致(模型含I2C传输估计)
+    float model = 2 * ads1015_rate_latency(&dev, SPS_1600, 4);
+    printf("collect: 2 points x4 at SPS_1600 took %lu ms, model %.2f ms\r\n", (unsigned long)host_tick, model);
+    TEST_ASSERT(host_tick <= model && model - host_tick < 8 * 0.1f + 1e-3f);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_noise_model();
+    fail |= test_select();
+    fail |= test_collect();
+    printf("test_ads1015_rate %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
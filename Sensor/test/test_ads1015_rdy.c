@@ -0,0 +1,267 @@
+/**
+ * @file test_ads1015_rdy.c
+ * @brief ADS1015转换完成等待测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 模拟器件按数据率转换:配置写入后连续模式重新开始转换,转换寄存器保留旧配置结果直到新转换完成;
+ * 单次模式写OS位触发转换,转换中OS位读0;
+ * 阈值寄存器配置为转换完成信号时每次转换结束调用ads1015_rdy_isr;
+ * 每个转换结果码值唯一,按固定延时、ALERT/RDY引脚、轮询OS位三种方式分别经ads1015_collect、
+ * ads1015_extend_collect_dr与ads1015_scan采集5点,验证无旧配置结果与重复结果、
+ * 连续模式是否丢弃首个结果,并输出各方式耗时:
+ * gcc -ISensor/test/stub -ISensor/driver/ads1015 Sensor/test/test_ads1015_rdy.c Sensor/test/stub/host_stub.c
+ *     Sensor/driver/ads1015/ads1015.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ads1015.h"
+#include "stm32wlxx_hal.h"
+/* Private define ------------------------------------------------------------*/
+#define SAMPLES         5           //每次采集点数
+#define PERIOD_US       7813        //SPS_128转换周期(us)
+#define XFER_US         100         //单次I2C操作耗时(us)
+#define TICK_US         5           //每次查询节拍耗时(us)
+#define CODE_SPAN       100         //每个通道的码值范围,码值为通道*CODE_SPAN+转换序号
+#define EVENT_NONE      0xFFFFFFFF
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief  采集路径
+ */
+typedef enum
+{
+    PATH_COLLECT = 0,   //ads1015_config + ads1015_collect
+    PATH_EXTEND,        //ads1015_extend_collect_dr
+    PATH_SCAN,          //ads1015_scan
+    PATH_NUM,
+}path_e;
+/* Private variables ---------------------------------------------------------*/
+static const char *const rdy_name[] = {"delay", "rdy pin", "poll"};
+static const char *const path_name[] = {"collect", "extend", "scan"};
+static ads1015_t dev;
+static I2c_t i2c;
+static uint32_t sim_frac;           //节拍内时间(us),仿真时间为host_tick*1000+sim_frac
+static uint16_t sim_reg[4];         //器件寄存器
+static uint8_t  sim_pointer;        //器件指针寄存器
+static uint32_t sim_conv_at;        //下一次转换完成时间(us)
+static uint32_t sim_conv;           //转换序号
+static uint32_t sim_reads;          //转换寄存器读取次数
+/* Private user code ---------------------------------------------------------*/
+static uint32_t sim_now(void)
+{
+    return host_tick * 1000 + sim_frac;
+}
+/**
+ * @brief  处理到期的转换
+ * @note   HAL_Delay直接推进host_tick,在下次访问器件或查询节拍时补处理
+ */
+static void sim_update(void)
+{
+    ConfigReg_t reg = {.value = sim_reg[Reg_Config]};
+    while(sim_conv_at != EVENT_NONE && sim_conv_at <= sim_now()) {
+        sim_reg[Reg_Conversion] = (uint16_t)((reg.Bits.Mux * CODE_SPAN + sim_conv % CODE_SPAN) << 4);
+        sim_conv++;
+        if(reg.Bits.Mode == SingleShot_Mode) {
+            sim_conv_at = EVENT_NONE;
+        } else {
+            sim_conv_at += PERIOD_US;
+        }
+        //比较器每次转换触发且阈值配置为转换完成信号
+        if(reg.Bits.CompQue == 0 && sim_reg[Reg_LoThresh] == 0x0000 && sim_reg[Reg_HiThresh] == 0x8000) {
+            ads1015_rdy_isr(&dev);
+        }
+    }
+}
+
+static void sim_step(uint32_t us)
+{
+    sim_frac += us;
+    host_tick += sim_frac / 1000;
+    sim_frac %= 1000;
+    sim_update();
+}
+
+uint32_t HAL_GetTick(void)
+{
+    sim_step(TICK_US);
+    return host_tick;
+}
+/**
+ * @brief  模拟器件寄存器写入
+ * @note   写配置寄存器后按新配置重新开始转换;单次模式OS位置1触发转换
+ */
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    sim_step(XFER_US);
+    sim_pointer = data[0] & 0x03;
+    if(size == 3 && sim_pointer != Reg_Conversion) {
+        sim_reg[sim_pointer] = (data[1] << 8) | data[2];
+        if(sim_pointer == Reg_Config) {
+            sim_reg[Reg_Config] &= ~ADS1015_CONFIG_OS;
+            ConfigReg_t reg = {.value = sim_reg[Reg_Config]};
+            bool trigger = (data[1] & 0x80) != 0;
+            if(reg.Bits.Mode == Continuous_Mode || trigger == true) {
+                sim_conv_at = sim_now() + PERIOD_US;
+            } else {
+                sim_conv_at = EVENT_NONE;
+            }
+        }
+    }
+    return 0;
+}
+/**
+ * @brief  模拟器件寄存器读取
+ * @note   配置寄存器OS位读0表示转换中
+ */
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr; (void)size;
+    sim_step(XFER_US);
+    uint16_t value = sim_reg[sim_pointer];
+    if(sim_pointer == Reg_Config && sim_conv_at == EVENT_NONE) {
+        value |= ADS1015_CONFIG_OS;
+    } else if(sim_pointer == Reg_Conversion) {
+        sim_reads++;
+    }
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+    return 0;
+}
+/**
+ * @brief  器件上电
+ * @note   上一次配置为SINGLE_0连续转换,转换寄存器保留其结果
+ */
+static void sim_reset(ads1015_rdy_t rdy)
+{
+    memset(sim_reg, 0, sizeof(sim_reg));
+    sim_reg[Reg_Config] = ADS1015_CONFIG_ENCODE(SINGLE_0, Continuous_Mode, FSR_2048, SPS_128) | 0x03;
+    sim_reg[Reg_LoThresh] = 0x8000;
+    sim_reg[Reg_HiThresh] = 0x7FF0;
+    sim_reg[Reg_Conversion] = (uint16_t)((SINGLE_0 * CODE_SPAN) << 4);
+    sim_conv_at = EVENT_NONE;
+    sim_conv = 1;
+    host_tick = 0;
+    sim_frac = 0;
+    ads1015_init(&dev, &i2c, ADS1015_ADDR_GND);
+    ads1015_rdy_set(&dev, rdy);
+}
+/**
+ * @brief  按指定路径采集SINGLE_1通道
+ */
+static uint8_t burst(path_e path, ads1015_mode_t mode, ads1015_data_t *data)
+{
+    static const ads1015_scan_t list = {SINGLE_1, FSR_2048, SPS_128, 1, SAMPLES};
+    uint8_t ret;
+
+    switch(path) {
+    case PATH_COLLECT:
+        ret = ads1015_config(&dev, SINGLE_1, mode, FSR_2048, SPS_128);
+        return (ret != 0) ? ret : ads1015_collect(&dev, SAMPLES, data);
+    case PATH_EXTEND:
+        return ads1015_extend_collect_dr(&dev, SINGLE_1, mode, FSR_2048, SPS_128, 1, SAMPLES, data);
+    default:
+        return ads1015_scan(&dev, &list, 1, mode, data, SAMPLES);
+    }
+}
+/**
+ * @brief  采集结果均为新配置下的不同转换
+ */
+static bool data_fresh(const ads1015_data_t *data)
+{
+    for(uint8_t i = 0; i < SAMPLES; i++) {
+        if(data[i].succ == false || data[i].value / CODE_SPAN != SINGLE_1) {
+            return false;
+        }
+        for(uint8_t j = 0; j < i; j++) {
+            if(data[j].value == data[i].value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int test_wait(void)
+{
+    float elapsed[ADS1015_RDY_POLL + 1][2][PATH_NUM];
+
+    for(uint8_t rdy = ADS1015_RDY_DELAY; rdy <= ADS1015_RDY_POLL; rdy++) {
+        for(uint8_t mode = Continuous_Mode; mode <= SingleShot_Mode; mode++) {
+            for(uint8_t path = PATH_COLLECT; path < PATH_NUM; path++) {
+                ads1015_data_t data[SAMPLES] = {0};
+                sim_reset((ads1015_rdy_t)rdy);
+                sim_reads = 0;
+                TEST_ASSERT(burst((path_e)path, (ads1015_mode_t)mode, data) == 0);
+                elapsed[rdy][mode][path] = sim_now() / 1000.0f;
+                if(data_fresh(data) == false) {
+                    printf("%s %s %s: stale or repeated result\r\n", rdy_name[rdy],
+                           (mode == Continuous_Mode) ? "continuous" : "single", path_name[path]);
+                    return 1;
+                }
+                //连续模式无转换完成信号时丢弃配置后首个结果;ads1015_collect不丢弃,首次等待不短于转换周期
+                bool discard = (mode == Continuous_Mode && rdy != ADS1015_RDY_PIN && path != PATH_COLLECT);
+                TEST_ASSERT(sim_reads == SAMPLES + (discard ? 1 : 0));
+                //转换完成信号对应的每个结果都在转换结束后读取,耗时接近转换周期
+                TEST_ASSERT(elapsed[rdy][mode][path] >= SAMPLES * PERIOD_US / 1000.0f);
+                if(rdy == ADS1015_RDY_PIN || (rdy == ADS1015_RDY_POLL && mode == SingleShot_Mode)) {
+                    TEST_ASSERT(elapsed[rdy][mode][path] < SAMPLES * (PERIOD_US + 4 * XFER_US) / 1000.0f + 1);
+                }
+            }
+        }
+    }
+
+    printf("%d-sample burst at SPS_128 (ms)  collect  extend  scan\r\n", SAMPLES);
+    for(uint8_t rdy = ADS1015_RDY_DELAY; rdy <= ADS1015_RDY_POLL; rdy++) {
+        for(uint8_t mode = Continuous_Mode; mode <= SingleShot_Mode; mode++) {
+            printf("  %-8s %-11s %8.1f %7.1f %5.1f\r\n", rdy_name[rdy],
+                   (mode == Continuous_Mode) ? "continuous" : "single", elapsed[rdy][mode][PATH_COLLECT],
+                   elapsed[rdy][mode][PATH_EXTEND], elapsed[rdy][mode][PATH_SCAN]);
+        }
+    }
+    //固定延时每点多等待:ads1015_collect/extend按10ms延时,scan按向上取整的转换周期
+    TEST_ASSERT(elapsed[ADS1015_RDY_PIN][Continuous_Mode][PATH_EXTEND]
+              < elapsed[ADS1015_RDY_DELAY][Continuous_Mode][PATH_EXTEND]);
+    TEST_ASSERT(elapsed[ADS1015_RDY_POLL][SingleShot_Mode][PATH_EXTEND]
+              < elapsed[ADS1015_RDY_DELAY][SingleShot_Mode][PATH_EXTEND]);
+    return 0;
+}
+
+static int test_timeout(void)
+{
+    //引脚未连接:转换完成信号不到达时超时后仍读取数据,结果不重复
+    ads1015_data_t data[SAMPLES] = {0};
+    sim_reset(ADS1015_RDY_PIN);
+    TEST_ASSERT(ads1015_config(&dev, SINGLE_1, SingleShot_Mode, FSR_2048, SPS_128) == 0);
+    sim_reg[Reg_HiThresh] = 0x7FF0;
+    TEST_ASSERT(ads1015_collect(&dev, SAMPLES, data) == 0);
+    TEST_ASSERT(data_fresh(data));
+    printf("rdy pin lost: %d samples in %.1f ms\r\n", SAMPLES, sim_now() / 1000.0f);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_wait();
+    fail |= test_timeout();
+    printf("test_ads1015_rdy %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
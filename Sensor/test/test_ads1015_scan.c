@@ -0,0 +1,355 @@
+/**
+ * @file test_ads1015_scan.c
+ * @brief ADS1015扫描列表与多实例交错扫描测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 同一总线上按地址模拟4片ADS1015,各片寄存器独立,按数据率转换,配置写入后连续模式重新开始转换;
+ * 码值由芯片、通道与转换序号组成,验证结果放置到对应芯片与列表项;
+ * 验证扫描列表按量程、数据率、通道稳定排序执行,与按列表顺序逐项采集对比配置写入、量程切换与加锁次数;
+ * 验证多实例交错扫描与逐片扫描结果一致、总线锁只加一次且所有总线操作在锁内、
+ * 同一实例出现在多个任务时拒绝,并输出三种等待方式下逐片扫描与交错扫描耗时:
+ * gcc -ISensor/test/stub -ISensor/driver/ads1015 Sensor/test/test_ads1015_scan.c Sensor/test/stub/host_stub.c
+ *     Sensor/driver/ads1015/ads1015.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ads1015.h"
+#include "stm32wlxx_hal.h"
+#include "module_ntag.h"
+/* Private define ------------------------------------------------------------*/
+#define CHIP_NUM        4           //芯片数量
+#define ENTRY_NUM       4           //每片扫描项数
+#define SAMPLES         5           //每项采样点数
+#define PERIOD_US       7813        //SPS_128转换周期(us)
+#define XFER_US         100         //单次I2C操作耗时(us)
+#define TICK_US         5           //每次查询节拍耗时(us)
+#define CODE_CHIP       400         //每片码值范围
+#define CODE_MUX        40          //每通道码值范围,码值为芯片*CODE_CHIP+通道*CODE_MUX+转换序号
+#define EVENT_NONE      0xFFFFFFFF
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief  模拟器件
+ */
+typedef struct
+{
+    uint16_t reg[4];        //寄存器
+    uint8_t  pointer;       //指针寄存器
+    uint32_t conv_at;       //下一次转换完成时间(us)
+    uint32_t conv;          //转换序号
+    uint32_t writes;        //配置寄存器写入次数
+    uint32_t pga_change;    //相邻配置写入量程变化次数
+    uint8_t  mux_log[8];    //配置写入通道顺序
+}sim_chip_t;
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t chip_addr[CHIP_NUM] = {ADS1015_ADDR_GND, ADS1015_ADDR_VDD, ADS1015_ADDR_SDA, ADS1015_ADDR_SCL};
+static const char *const rdy_name[] = {"delay continuous", "rdy pin continuous", "poll single"};
+static ads1015_t dev[CHIP_NUM];
+static I2c_t i2c;
+static sim_chip_t chip[CHIP_NUM];
+static uint32_t sim_frac;           //节拍内时间(us),仿真时间为host_tick*1000+sim_frac
+static uint32_t sim_unlocked;       //未持有总线锁时的总线操作次数
+/* Private user code ---------------------------------------------------------*/
+static uint32_t sim_now(void)
+{
+    return host_tick * 1000 + sim_frac;
+}
+/**
+ * @brief  处理各片到期的转换
+ * @note   阈值配置为转换完成信号时调用对应实例的ads1015_rdy_isr
+ */
+static void sim_update(void)
+{
+    for(uint8_t c = 0; c < CHIP_NUM; c++) {
+        sim_chip_t *p = &chip[c];
+        ConfigReg_t reg = {.value = p->reg[Reg_Config]};
+        while(p->conv_at != EVENT_NONE && p->conv_at <= sim_now()) {
+            p->reg[Reg_Conversion] = (uint16_t)((c * CODE_CHIP + reg.Bits.Mux * CODE_MUX + p->conv % CODE_MUX) << 4);
+            p->conv++;
+            p->conv_at = (reg.Bits.Mode == SingleShot_Mode) ? EVENT_NONE : p->conv_at + PERIOD_US;
+            if(reg.Bits.CompQue == 0 && p->reg[Reg_LoThresh] == 0x0000 && p->reg[Reg_HiThresh] == 0x8000) {
+                ads1015_rdy_isr(&dev[c]);
+            }
+        }
+    }
+}
+
+static void sim_step(uint32_t us)
+{
+    sim_frac += us;
+    host_tick += sim_frac / 1000;
+    sim_frac %= 1000;
+    sim_update();
+}
+
+uint32_t HAL_GetTick(void)
+{
+    sim_step(TICK_US);
+    return host_tick;
+}
+
+static sim_chip_t *sim_chip(uint8_t addr)
+{
+    for(uint8_t c = 0; c < CHIP_NUM; c++) {
+        if(chip_addr[c] == addr) {
+            return &chip[c];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief  模拟器件寄存器写入
+ * @note   地址无应答返回错误;写配置寄存器后按新配置重新开始转换,单次模式OS位置1触发转换
+ */
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj;
+    sim_chip_t *p = sim_chip(addr);
+    sim_step(XFER_US);
+    sim_unlocked += (host_lock_held == 0) ? 1 : 0;
+    if(p == NULL) {
+        return 1;
+    }
+    p->pointer = data[0] & 0x03;
+    if(size == 3 && p->pointer != Reg_Conversion) {
+        ConfigReg_t last = {.value = p->reg[Reg_Config]};
+        p->reg[p->pointer] = (data[1] << 8) | data[2];
+        if(p->pointer == Reg_Config) {
+            p->reg[Reg_Config] &= ~ADS1015_CONFIG_OS;
+            ConfigReg_t reg = {.value = p->reg[Reg_Config]};
+            //单次模式触发转换不计为配置写入
+            if((data[1] & 0x80) == 0 || reg.value != last.value) {
+                p->pga_change += (p->writes != 0 && reg.Bits.Pga != last.Bits.Pga) ? 1 : 0;
+                p->mux_log[p->writes % sizeof(p->mux_log)] = reg.Bits.Mux;
+                p->writes++;
+            }
+            bool trigger = (data[1] & 0x80) != 0;
+            p->conv_at = (reg.Bits.Mode == Continuous_Mode || trigger) ? sim_now() + PERIOD_US : EVENT_NONE;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief  模拟器件寄存器读取
+ * @note   配置寄存器OS位读0表示转换中
+ */
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)size;
+    sim_chip_t *p = sim_chip(addr);
+    sim_step(XFER_US);
+    sim_unlocked += (host_lock_held == 0) ? 1 : 0;
+    if(p == NULL) {
+        return 1;
+    }
+    uint16_t value = p->reg[p->pointer];
+    if(p->pointer == Reg_Config && p->conv_at == EVENT_NONE) {
+        value |= ADS1015_CONFIG_OS;
+    }
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+    return 0;
+}
+/**
+ * @brief  各片上电
+ */
+static void sim_reset(ads1015_rdy_t rdy)
+{
+    memset(chip, 0, sizeof(chip));
+    for(uint8_t c = 0; c < CHIP_NUM; c++) {
+        chip[c].reg[Reg_Config] = ADS1015_CONFIG_ENCODE(0, SingleShot_Mode, FSR_2048, SPS_1600) | 0x03;
+        chip[c].reg[Reg_LoThresh] = 0x8000;
+        chip[c].reg[Reg_HiThresh] = 0x7FF0;
+        chip[c].conv_at = EVENT_NONE;
+        ads1015_init(&dev[c], &i2c, chip_addr[c]);
+        ads1015_rdy_set(&dev[c], rdy);
+    }
+    host_tick = 0;
+    sim_frac = 0;
+    host_lock_count = 0;
+    sim_unlocked = 0;
+}
+/**
+ * @brief  校验扫描结果
+ * @note   每个采样点来自对应芯片与通道,同一项内为不同转换
+ */
+static bool scan_check(uint8_t c, const ads1015_scan_t *list, uint8_t num, const ads1015_data_t *data)
+{
+    for(uint8_t e = 0; e < num; e++) {
+        for(uint8_t i = 0; i < list[e].samples; i++) {
+            const ads1015_data_t *d = data++;
+            if(d->succ == false || d->value / CODE_CHIP != c || d->value % CODE_CHIP / CODE_MUX != list[e].mux) {
+                return false;
+            }
+            for(uint8_t j = 0; j < i; j++) {
+                if((d - 1 - j)->value == d->value) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static int test_multi(void)
+{
+    static const ads1015_rdy_t rdy[] = {ADS1015_RDY_DELAY, ADS1015_RDY_PIN, ADS1015_RDY_POLL};
+    static const ads1015_mode_t mode[] = {Continuous_Mode, Continuous_Mode, SingleShot_Mode};
+    static const ads1015_scan_t list[ENTRY_NUM] =
+    {
+        {SINGLE_0, FSR_2048, SPS_128, 1, SAMPLES},
+        {SINGLE_1, FSR_2048, SPS_128, 1, SAMPLES},
+        {SINGLE_2, FSR_2048, SPS_128, 1, SAMPLES},
+        {SINGLE_3, FSR_2048, SPS_128, 1, SAMPLES},
+    };
+    static ads1015_data_t data[CHIP_NUM][ENTRY_NUM * SAMPLES];
+    ads1015_job_t job[CHIP_NUM];
+
+    for(uint8_t c = 0; c < CHIP_NUM; c++) {
+        job[c] = (ads1015_job_t){&dev[c], list, ENTRY_NUM, data[c], ENTRY_NUM * SAMPLES};
+    }
+    printf("%d chips x %d entries x %d samples at SPS_128 (ms)  sequential  interleaved\r\n",
+           CHIP_NUM, ENTRY_NUM, SAMPLES);
+    for(uint8_t r = 0; r < 3; r++) {
+        //逐片扫描,每片一次加锁
+        sim_reset(rdy[r]);
+        memset(data, 0, sizeof(data));
+        for(uint8_t c = 0; c < CHIP_NUM; c++) {
+            TEST_ASSERT(ads1015_scan(&dev[c], list, ENTRY_NUM, mode[r], data[c], ENTRY_NUM * SAMPLES) == 0);
+            TEST_ASSERT(scan_check(c, list, ENTRY_NUM, data[c]));
+        }
+        float seq_ms = sim_now() / 1000.0f;
+        TEST_ASSERT(host_lock_count == CHIP_NUM && sim_unlocked == 0);
+
+        //交错扫描,一次加锁,结果与逐片扫描一致
+        sim_reset(rdy[r]);
+        memset(data, 0, sizeof(data));
+        TEST_ASSERT(ads1015_scan_multi(job, CHIP_NUM, mode[r]) == 0);
+        float multi_ms = sim_now() / 1000.0f;
+        for(uint8_t c = 0; c < CHIP_NUM; c++) {
+            TEST_ASSERT(scan_check(c, list, ENTRY_NUM, data[c]));
+            TEST_ASSERT(dev[c].session == false);
+        }
+        TEST_ASSERT(host_lock_count == 1 && host_lock_held == 0 && sim_unlocked == 0);
+        printf("  %-20s %10.1f %12.1f\r\n", rdy_name[r], seq_ms, multi_ms);
+        //转换等待重叠,交错扫描耗时接近单片
+        TEST_ASSERT(multi_ms * (CHIP_NUM - 1) < seq_ms);
+    }
+    return 0;
+}
+
+static int test_order(void)
+{
+    //PT100两路参考(FSR_2048)与两路温度(FSR_0256)交替排列,末项与首项配置相同
+    static const ads1015_scan_t list[5] =
+    {
+        {SINGLE_0, FSR_2048, SPS_128, 1, SAMPLES},
+        {DIFF_0_1, FSR_0256, SPS_128, 1, SAMPLES},
+        {SINGLE_2, FSR_2048, SPS_128, 1, SAMPLES},
+        {DIFF_2_3, FSR_0256, SPS_128, 1, SAMPLES},
+        {SINGLE_0, FSR_2048, SPS_128, 1, 2},
+    };
+    static const uint8_t order[4] = {SINGLE_0, SINGLE_2, DIFF_0_1, DIFF_2_3};
+    ads1015_data_t data[4 * SAMPLES + 2];
+
+    //按量程、数据率、通道排序,相同配置相邻时跳过写入
+    sim_reset(ADS1015_RDY_DELAY);
+    memset(data, 0, sizeof(data));
+    TEST_ASSERT(ads1015_scan(&dev[0], list, 5, Continuous_Mode, data, 4 * SAMPLES + 2) == 0);
+    TEST_ASSERT(chip[0].writes == 4 && memcmp(chip[0].mux_log, order, sizeof(order)) == 0);
+    uint32_t scan_pga = chip[0].pga_change;
+    uint32_t scan_lock = host_lock_count;
+    TEST_ASSERT(scan_pga == 1 && scan_lock == 1);
+    //结果按列表原顺序存放;相同配置的两项保持列表顺序,末项在首项之后转换
+    TEST_ASSERT(scan_check(0, list, 5, data));
+    TEST_ASSERT(data[4 * SAMPLES].value > data[SAMPLES - 1].value);
+
+    //按列表顺序逐项采集
+    sim_reset(ADS1015_RDY_DELAY);
+    for(uint8_t e = 0; e < 4; e++) {
+        TEST_ASSERT(ads1015_extend_collect_dr(&dev[0], list[e].mux, Continuous_Mode, list[e].fsr, list[e].dr,
+                                              1, SAMPLES, &data[e * SAMPLES]) == 0);
+    }
+    TEST_ASSERT(scan_check(0, list, 4, data));
+    printf("scan order: pga change %lu vs %lu, lock %lu vs %lu\r\n", (unsigned long)scan_pga,
+           (unsigned long)chip[0].pga_change, (unsigned long)scan_lock, (unsigned long)host_lock_count);
+    TEST_ASSERT(chip[0].pga_change == 3 && host_lock_count > scan_lock);
+
+    //采样点数为0的项跳过,不写配置
+    static const ads1015_scan_t skip[2] = {{SINGLE_1, FSR_0512, SPS_128, 1, 0}, {SINGLE_3, FSR_2048, SPS_128, 1, 1}};
+    sim_reset(ADS1015_RDY_DELAY);
+    TEST_ASSERT(ads1015_scan(&dev[0], skip, 2, Continuous_Mode, data, 1) == 0);
+    TEST_ASSERT(chip[0].writes == 1 && chip[0].mux_log[0] == SINGLE_3 && scan_check(0, &skip[1], 1, data));
+    return 0;
+}
+
+static int test_reject(void)
+{
+    static const ads1015_scan_t list[1] = {{SINGLE_0, FSR_2048, SPS_128, 1, SAMPLES}};
+    ads1015_data_t data[2][SAMPLES];
+    ads1015_job_t job[ADS1015_JOB_MAX + 1];
+
+    sim_reset(ADS1015_RDY_DELAY);
+    //同一实例出现在两个任务中
+    job[0] = (ads1015_job_t){&dev[0], list, 1, data[0], SAMPLES};
+    job[1] = (ads1015_job_t){&dev[0], list, 1, data[1], SAMPLES};
+    TEST_ASSERT(ads1015_scan_multi(job, 2, Continuous_Mode) == 0xFF);
+    //任务数超过上限、结果缓冲区不足、空任务
+    for(uint8_t c = 0; c <= ADS1015_JOB_MAX; c++) {
+        job[c] = (ads1015_job_t){&dev[c % CHIP_NUM], list, 1, data[0], SAMPLES};
+    }
+    TEST_ASSERT(ads1015_scan_multi(job, ADS1015_JOB_MAX + 1, Continuous_Mode) == 0xFF);
+    job[1] = (ads1015_job_t){&dev[1], list, 1, data[1], SAMPLES - 1};
+    TEST_ASSERT(ads1015_scan_multi(job, 2, Continuous_Mode) == 0xFF);
+    TEST_ASSERT(ads1015_scan_multi(job, 0, Continuous_Mode) == 0xFF);
+    TEST_ASSERT(ads1015_scan_multi(NULL, 1, Continuous_Mode) == 0xFF);
+    //拒绝时不加锁、不访问总线
+    TEST_ASSERT(host_lock_count == 0 && host_tick == 0 && sim_frac == 0);
+    return 0;
+}
+
+static int test_nack(void)
+{
+    static const ads1015_scan_t list[1] = {{SINGLE_0, FSR_2048, SPS_128, 1, SAMPLES}};
+    ads1015_data_t data[2][SAMPLES];
+    ads1015_t absent;
+    ads1015_job_t job[2];
+
+    //一片无应答:返回错误,另一片结果正常,锁释放
+    sim_reset(ADS1015_RDY_DELAY);
+    ads1015_init(&absent, &i2c, 0x50);
+    job[0] = (ads1015_job_t){&absent, list, 1, data[0], SAMPLES};
+    job[1] = (ads1015_job_t){&dev[1], list, 1, data[1], SAMPLES};
+    TEST_ASSERT(ads1015_scan_multi(job, 2, Continuous_Mode) != 0);
+    TEST_ASSERT(scan_check(1, list, 1, data[1]));
+    TEST_ASSERT(host_lock_count == 1 && host_lock_held == 0 && absent.session == false);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_order();
+    fail |= test_multi();
+    fail |= test_reject();
+    fail |= test_nack();
+    printf("test_ads1015_scan %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,347 @@
+/**
+ * @file test_ads1015_stream.c
+ * @brief ADS1015连续采集吞吐量测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 模拟器件按数据率转换并产生RDY中断,非阻塞读取按I2C时钟计算传输时间后完成;
+ * 以1us为步长的事件仿真,验证各数据率下无丢失且数据按转换顺序与器件一致、
+ * 慢消费者时overrun计数准确、总线过慢时late计数准确;停止时等待进行中读取完成,
+ * 读取挂起时未终止则保持总线锁与busy、不写入掉电配置,终止后忽略迟到的完成回调:
+ * gcc -ISensor/test/stub -ISensor/driver/ads1015 Sensor/test/test_ads1015_stream.c Sensor/test/stub/host_stub.c
+ *     Sensor/driver/ads1015/ads1015.c Sensor/driver/ads1015/ads1015_stream.c -lm
+ * 加-DSTREAM_NO_HOOK编译时不实现板级非阻塞读取接口,验证开始采集返回失败且不占用总线锁
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "ads1015_stream.h"
+#include "stm32wlxx_hal.h"
+#include "module_ntag.h"
+/* Private define ------------------------------------------------------------*/
+#define RING_SIZE       1024        //环形缓冲区数量
+#define BLOCK_SIZE      256         //消费者数据块
+#define RUN_US          2000000     //仿真时长(us)
+#define TONE_HZ         50.0        //测试信号频率
+#define TONE_AMP        600.0       //测试信号幅度(码值)
+#define TONE_OFFSET     100.0       //测试信号偏置(码值)
+#define XFER_BITS       27          //地址+2字节数据,每字节9位
+#define XFER_OVERHEAD   5           //起始/停止与中断响应开销(us)
+#define SIM_PI          3.14159265358979
+#define EVENT_NONE      0xFFFFFFFF
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static uint32_t sim_us;             //仿真时间(us)
+static uint16_t sim_reg[4];         //器件寄存器
+static uint8_t  sim_pointer;        //器件指针寄存器
+static uint32_t rx_done_at;         //进行中读取的完成时间
+static ads1015_stream_t *rx_stream;
+static uint8_t *rx_data;
+static uint32_t config_writes;      //配置寄存器写入次数
+#ifndef STREAM_NO_HOOK
+static uint32_t sim_xfer_us;        //单次读取传输时间(us)
+static bool     rx_hang;            //读取挂起,不完成
+static uint8_t  abort_ret;          //终止读取返回值
+static uint32_t abort_count;        //终止读取次数
+#endif
+/* Private user code ---------------------------------------------------------*/
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    sim_pointer = data[0] & 0x03;
+    if(size == 3 && sim_pointer != Reg_Conversion) {
+        sim_reg[sim_pointer] = (data[1] << 8) | data[2];
+        config_writes += (sim_pointer == Reg_Config);
+    }
+    return 0;
+}
+
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    if(size == 2) {
+        data[0] = sim_reg[sim_pointer] >> 8;
+        data[1] = sim_reg[sim_pointer] & 0xFF;
+    }
+    return 0;
+}
+#ifndef STREAM_NO_HOOK
+/**
+ * @brief  模拟非阻塞读取
+ * @note   记录完成时间,由仿真循环到期后拷贝数据并调用完成回调
+ */
+uint8_t ads1015_stream_rx_start(ads1015_stream_t *st, I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr; (void)size;
+    rx_stream = st;
+    rx_data = data;
+    rx_done_at = (rx_hang == true) ? EVENT_NONE : sim_us + sim_xfer_us;
+    return 0;
+}
+
+uint8_t ads1015_stream_rx_abort(ads1015_stream_t *st, I2c_t *obj, uint8_t addr)
+{
+    (void)st; (void)obj; (void)addr;
+    abort_count++;
+    return abort_ret;
+}
+#endif
+/**
+ * @brief  完成到期的读取
+ */
+static void rx_poll(void)
+{
+    if(rx_done_at != EVENT_NONE && sim_us >= rx_done_at) {
+        rx_done_at = EVENT_NONE;
+        rx_data[0] = sim_reg[Reg_Conversion] >> 8;
+        rx_data[1] = sim_reg[Reg_Conversion] & 0xFF;
+        ads1015_stream_rx_done(rx_stream, true);
+    }
+}
+/**
+ * @brief  节拍查询
+ * @note   停止等待读取完成时忙等查询,每次查询推进1us并完成到期的读取
+ */
+uint32_t HAL_GetTick(void)
+{
+    sim_us++;
+    rx_poll();
+    return sim_us / 1000;
+}
+#ifndef STREAM_NO_HOOK
+/**
+ * @brief  测试信号码值
+ */
+static int16_t tone_code(uint32_t us)
+{
+    return (int16_t)lround(TONE_OFFSET + TONE_AMP * sin(2 * SIM_PI * TONE_HZ * us / 1e6));
+}
+/**
+ * @brief  仿真结果
+ */
+typedef struct
+{
+    uint32_t conversions;   //器件转换次数
+    uint32_t consumed;      //消费者读取数量
+    uint32_t blocks;        //数据块数量
+    uint32_t mismatch;      //与对应转换码值不一致的数量
+    bool     stopped;       //停止成功
+}sim_result_t;
+/**
+ * @brief  执行一次仿真
+ * @param  dr: 数据率
+ * @param  sps: 数据率对应每秒转换次数
+ * @param  i2c_hz: I2C时钟
+ * @param  poll_us: 消费者轮询间隔
+ * @param  *st: 采集流
+ * @param  *res: 仿真结果
+ */
+static void simulate(ads1015_dr_t dr, uint32_t sps, uint32_t i2c_hz, uint32_t poll_us,
+                     ads1015_stream_t *st, sim_result_t *res)
+{
+    static ads1015_t dev;
+    static I2c_t i2c;
+    static int16_t ring[RING_SIZE];
+    static int16_t block[BLOCK_SIZE];
+    uint32_t next_conv = 0;
+    uint32_t next_poll = poll_us;
+
+    sim_us = 0;
+    host_tick = 0;
+    rx_done_at = EVENT_NONE;
+    sim_xfer_us = (uint32_t)((uint64_t)XFER_BITS * 1000000 / i2c_hz) + XFER_OVERHEAD;
+    memset(res, 0, sizeof(sim_result_t));
+    ads1015_init(&dev, &i2c, ADS1015_ADDR_GND);
+    ads1015_rdy_set(&dev, ADS1015_RDY_PIN);
+    ads1015_stream_start(st, &dev, SINGLE_0, FSR_2048, dr, ring, RING_SIZE);
+
+    for(sim_us = 0; sim_us < RUN_US; sim_us++) {
+        host_tick = sim_us / 1000;
+        rx_poll();
+        if(sim_us == next_conv) {
+            res->conversions++;
+            sim_reg[Reg_Conversion] = (uint16_t)(tone_code(sim_us) << 4);
+            ads1015_stream_isr(st);
+            next_conv = (uint32_t)((uint64_t)res->conversions * 1000000 / sps);
+        }
+        if(sim_us == next_poll) {
+            next_poll += poll_us;
+            while(ads1015_stream_block(st, block, BLOCK_SIZE) == true) {
+                //无丢失时第k个数据对应第k次转换
+                for(uint16_t k = 0; k < BLOCK_SIZE; k++) {
+                    uint32_t n = res->consumed + k;
+                    if(block[k] != tone_code((uint32_t)((uint64_t)n * 1000000 / sps))) {
+                        res->mismatch++;
+                    }
+                }
+                res->consumed += BLOCK_SIZE;
+                res->blocks++;
+            }
+        }
+    }
+    res->stopped = ads1015_stream_stop(st);
+    res->consumed += ads1015_stream_read(st, block, BLOCK_SIZE);
+}
+
+static int test_throughput(void)
+{
+    static const struct
+    {
+        ads1015_dr_t dr;
+        uint32_t sps;
+        uint32_t i2c_hz;
+    }cases[] =
+    {
+        {SPS_920,  920,  400000},
+        {SPS_1600, 1600, 400000},
+        {SPS_3300, 3300, 400000},
+        {SPS_3300, 3300, 100000},
+    };
+    for(uint8_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ads1015_stream_t st;
+        sim_result_t res;
+        simulate(cases[i].dr, cases[i].sps, cases[i].i2c_hz, 100, &st, &res);
+        printf("%4lu SPS %3lukHz: conv %lu stored %lu overrun %lu late %lu\r\n",
+               (unsigned long)cases[i].sps, (unsigned long)cases[i].i2c_hz / 1000, (unsigned long)res.conversions,
+               (unsigned long)st.count, (unsigned long)st.overrun, (unsigned long)st.late);
+        TEST_ASSERT(st.overrun == 0 && st.late == 0 && st.error == 0 && res.stopped == true);
+        //停止时最后一次转换的读取可能未完成
+        TEST_ASSERT(st.count + 1 >= res.conversions && st.count <= res.conversions);
+        TEST_ASSERT(res.consumed == st.count);
+        TEST_ASSERT(res.blocks > 0 && res.mismatch == 0);
+    }
+    return 0;
+}
+
+static int test_slow_consumer(void)
+{
+    //消费者每800ms读取一次,1600SPS下每次到达1280个,超出1024缓冲区的部分计入overrun
+    ads1015_stream_t st;
+    sim_result_t res;
+    simulate(SPS_1600, 1600, 400000, 800000, &st, &res);
+    printf("slow consumer: conv %lu stored %lu overrun %lu\r\n",
+           (unsigned long)res.conversions, (unsigned long)st.count, (unsigned long)st.overrun);
+    TEST_ASSERT(st.overrun > 0 && st.late == 0);
+    TEST_ASSERT(st.count + st.overrun + 1 >= res.conversions && st.count + st.overrun <= res.conversions);
+    return 0;
+}
+
+static int test_slow_bus(void)
+{
+    //50kHz下单次读取约545us,超过3300SPS转换周期,未完成期间到达的转换计入late
+    ads1015_stream_t st;
+    sim_result_t res;
+    simulate(SPS_3300, 3300, 50000, 100, &st, &res);
+    printf("slow bus: conv %lu stored %lu late %lu\r\n",
+           (unsigned long)res.conversions, (unsigned long)st.count, (unsigned long)st.late);
+    TEST_ASSERT(st.late > 0 && st.overrun == 0);
+    TEST_ASSERT(st.count + st.late + 1 >= res.conversions && st.count + st.late <= res.conversions);
+    return 0;
+}
+
+static int test_stop(void)
+{
+    static ads1015_t dev;
+    static I2c_t i2c;
+    static int16_t ring[RING_SIZE];
+    ads1015_stream_t st;
+    uint8_t held = host_lock_held;
+
+    sim_us = 0;
+    rx_done_at = EVENT_NONE;
+    sim_xfer_us = (uint32_t)((uint64_t)XFER_BITS * 1000000 / 400000) + XFER_OVERHEAD;
+    ads1015_init(&dev, &i2c, ADS1015_ADDR_GND);
+    ads1015_rdy_set(&dev, ADS1015_RDY_PIN);
+
+    //读取进行中,停止时等待完成回调后掉电并释放总线锁
+    rx_hang = false;
+    TEST_ASSERT(ads1015_stream_start(&st, &dev, SINGLE_0, FSR_2048, SPS_3300, ring, RING_SIZE) == true);
+    ads1015_stream_isr(&st);
+    TEST_ASSERT(st.busy == true && host_lock_held == held + 1);
+    TEST_ASSERT(ads1015_stream_stop(&st) == true);
+    TEST_ASSERT(st.count == 1 && st.busy == false && abort_count == 0);
+    TEST_ASSERT(host_lock_held == held && (sim_reg[Reg_Config] & 0x0100) != 0);
+    //重复停止不再访问器件
+    uint32_t writes = config_writes;
+    TEST_ASSERT(ads1015_stream_stop(&st) == true && config_writes == writes && host_lock_held == held);
+
+    //读取挂起且无法终止:保持busy与总线锁,不写入掉电配置;完成回调后再次停止
+    rx_hang = true;
+    abort_ret = 1;
+    TEST_ASSERT(ads1015_stream_start(&st, &dev, SINGLE_0, FSR_2048, SPS_3300, ring, RING_SIZE) == true);
+    ads1015_stream_isr(&st);
+    writes = config_writes;
+    TEST_ASSERT(ads1015_stream_stop(&st) == false);
+    TEST_ASSERT(st.busy == true && st.running == false && abort_count == 1);
+    TEST_ASSERT(host_lock_held == held + 1 && config_writes == writes);
+    //停止后到达的转换不再启动读取
+    ads1015_stream_isr(&st);
+    TEST_ASSERT(st.late == 0);
+    ads1015_stream_rx_done(&st, true);
+    TEST_ASSERT(st.busy == false && st.count == 1);
+    TEST_ASSERT(ads1015_stream_stop(&st) == true && abort_count == 1);
+    TEST_ASSERT(host_lock_held == held && config_writes == writes + 1);
+
+    //读取挂起,终止成功后掉电,迟到的完成回调被忽略
+    abort_ret = 0;
+    TEST_ASSERT(ads1015_stream_start(&st, &dev, SINGLE_0, FSR_2048, SPS_3300, ring, RING_SIZE) == true);
+    ads1015_stream_isr(&st);
+    TEST_ASSERT(ads1015_stream_stop(&st) == true && abort_count == 2);
+    TEST_ASSERT(st.busy == false && host_lock_held == held && (sim_reg[Reg_Config] & 0x0100) != 0);
+    ads1015_stream_rx_done(&st, true);
+    TEST_ASSERT(st.count == 0);
+    rx_hang = false;
+    printf("stop: wait %luus for in-flight read, hang kept lock, abort %lu\r\n",
+           (unsigned long)sim_xfer_us, (unsigned long)abort_count);
+    return 0;
+}
+
+#else
+static int test_no_hook(void)
+{
+    //板级未实现非阻塞读取,开始采集失败,不加锁不访问器件
+    static ads1015_t dev;
+    static I2c_t i2c;
+    static int16_t ring[RING_SIZE];
+    ads1015_stream_t st;
+    uint32_t locks = host_lock_count;
+
+    ads1015_init(&dev, &i2c, ADS1015_ADDR_GND);
+    uint32_t writes = config_writes;
+    TEST_ASSERT(ads1015_stream_start(&st, &dev, SINGLE_0, FSR_2048, SPS_3300, ring, RING_SIZE) == false);
+    TEST_ASSERT(host_lock_count == locks && host_lock_held == 0 && config_writes == writes);
+    printf("no hook: start rejected\r\n");
+    return 0;
+}
+#endif /* STREAM_NO_HOOK */
+
+int main(void)
+{
+    int fail = 0;
+
+#ifdef STREAM_NO_HOOK
+    fail |= test_no_hook();
+#else
+    fail |= test_throughput();
+    fail |= test_slow_consumer();
+    fail |= test_slow_bus();
+    fail |= test_stop();
+#endif /* STREAM_NO_HOOK */
+    printf("test_ads1015_stream %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,495 @@
+/**
+ * @file test_builder.c
+ * @brief 构建器时间预算故障注入、空闲休眠与低功耗仿真测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 主机端编译运行,时间由host_tick模拟;组策略低功耗遍历全部成员;组策略重采被截止时间中止时记为超时;
+ * 两个传感器按10s/60s周期仿真6小时,输出不休眠、调度休眠下两种电源控制方式的平均电流:
+ * gcc -ISensor/test/stub -ISensor/core Sensor/test/test_builder.c Sensor/test/stub/host_stub.c
+ *     Sensor/core/sensor_builder.c Sensor/core/sensor_group.c Sensor/core/sensor_driver.c
+ *     Sensor/core/sensor_time.c Sensor/core/sensor_log.c Sensor/core/sensor_alarm.c Sensor/core/sensor_bus.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "sensor_builder.h"
+#include "sensor_group.h"
+#include "stm32wlxx_hal.h"
+#include "board_system.h"
+/* Private define ------------------------------------------------------------*/
+#define CH_NUM          2       //每个传感器通道数
+#define HANG_NONE       0       //阶段正常返回
+#define HANG_COOP       1       //阶段挂起,轮询截止时间协作退出
+#define HANG_BLOCK      2       //阶段阻塞500ms后返回,不检查截止时间
+#define DEV_NUM         6       //0~3:预算与组策略测试 4~5:电流仿真
+#define SIM_TIME        (6UL * 3600 * 1000) //电流仿真时长(ms)
+#define SIM_MEASURE_MS  35      //单次采集耗时(ms)
+#define SIM_RUN_UA      4500.0  //MCU运行电流(uA)
+#define SIM_STOP_UA     1.5     //STOP模式电流(uA)
+#define SIM_SENSOR_UA   200.0   //传感器上电电流(uA)
+#define SIM_LOOP_MS     0.2     //每次唤醒调度循环的运行时间(ms),含唤醒与日志检查
+#define POWER_SELF      0       //采集阶段自行开关传感器(default_collect)
+#define POWER_KEEP      1       //采集后保持上电,由调度器低功耗关闭(global_power)
+#define FAIL_COLLECT_MS 60      //注入采集失败时单次采集耗时(ms)
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static data_status_e status[DEV_NUM][CH_NUM];   //各传感器通道状态
+static uint32_t stage_runs[DEV_NUM][3];         //各传感器各阶段执行次数
+static bool     powered[DEV_NUM];               //传感器上电
+static uint32_t power_on[DEV_NUM];              //上电时刻(ms)
+static uint32_t powered_ms[DEV_NUM];            //累计上电时间(ms)
+static uint32_t opens[DEV_NUM];                 //打开调用次数,含已上电时重复打开
+static uint8_t  power_mode;
+static uint8_t hang_mode;
+static uint8_t hang_sensor;
+static bool    collect_fail[DEV_NUM];           //注入驱动采集失败
+static uint32_t collect_ms;                     //注入失败时单次采集耗时(ms)
+/* Private user code ---------------------------------------------------------*/
+static uint8_t sensor_index(sensor_device_t dev)
+{
+    return (uint8_t)(dev->name[0] - '0');
+}
+
+static bool sim_ok(sensor_device_t dev)
+{
+    (void)dev;
+    return true;
+}
+
+static bool sim_open(sensor_device_t dev)
+{
+    uint8_t id = sensor_index(dev);
+    opens[id]++;
+    if(powered[id] == false) {
+        powered[id] = true;
+        power_on[id] = host_tick;
+    }
+    return true;
+}
+
+static bool sim_close(sensor_device_t dev)
+{
+    uint8_t id = sensor_index(dev);
+    if(powered[id] == true) {
+        powered[id] = false;
+        powered_ms[id] += host_tick - power_on[id];
+    }
+    return true;
+}
+
+static bool sim_collect(sensor_device_t dev)
+{
+    uint8_t id = sensor_index(dev);
+    if(collect_fail[id] == true) {
+        host_tick += collect_ms;
+        return false;
+    }
+    return true;
+}
+
+static bool sim_control(sensor_device_t dev, sensor_cmd_e cmd, void *data, void *arg)
+{
+    if(cmd == SENSOR_CMD_STATUS_SET) {
+        status[sensor_index(dev)][*(uint8_t *)arg] = *(data_status_e *)data;
+    }
+    return true;
+}
+
+static const sensor_ops_t sim_ops =
+{
+    .init       = sim_ok,
+    .open       = sim_open,
+    .close      = sim_close,
+    .collect    = sim_collect,
+    .control    = sim_control,
+};
+/**
+ * @brief  采集阶段
+ * @note   通道置为有效,hang_sensor按hang_mode注入故障,其余传感器耗时10ms
+ */
+static void stage_collect(sensor_device_t dev, void *cfg, uint8_t num)
+{
+    uint8_t id = sensor_index(dev);
+    (void)cfg;
+    stage_runs[id][0]++;
+    for(uint8_t i = 0; i < num; i++) {
+        status[id][i] = DATA_STATUS_VALID;
+    }
+    if(id != hang_sensor || hang_mode == HANG_NONE) {
+        host_tick += 10;
+    } else if(hang_mode == HANG_COOP) {
+        while(sensor_deadline_expired() == false) {
+            host_tick++;
+        }
+    } else {
+        host_tick += 500;
+    }
+}
+
+static void stage_check(sensor_device_t dev, void *cfg, uint8_t num)
+{
+    (void)cfg; (void)num;
+    stage_runs[sensor_index(dev)][1]++;
+    host_tick += 5;
+}
+
+static void stage_publish(sensor_device_t dev, void *cfg, uint8_t num)
+{
+    (void)cfg; (void)num;
+    stage_runs[sensor_index(dev)][2]++;
+}
+
+/**
+ * @brief  电流仿真采集阶段
+ * @note   POWER_SELF每次开关传感器;POWER_KEEP未上电时上电,采集后保持
+ */
+static void stage_measure(sensor_device_t dev, void *cfg, uint8_t num)
+{
+    uint8_t id = sensor_index(dev);
+    (void)cfg; (void)num;
+    stage_runs[id][0]++;
+    if(power_mode == POWER_SELF || powered[id] == false) {
+        sensor_open(dev);
+    }
+    host_tick += SIM_MEASURE_MS;
+    if(power_mode == POWER_SELF) {
+        sensor_close(dev);
+    }
+}
+
+static sensor_process_ops_t budget_process[] =
+{
+    {.handler = stage_collect, .budget = 100},
+    {.handler = stage_check},
+    {.handler = stage_publish},
+};
+static sensor_process_ops_t plain_process[] =
+{
+    {.handler = stage_collect},
+    {.handler = stage_check},
+    {.handler = stage_publish},
+};
+
+static sensor_process_ops_t retry_process[] =
+{
+    {.handler = group_collect, .budget = 100},
+};
+
+static sensor_process_ops_t measure_process[] =
+{
+    {.handler = stage_measure},
+};
+
+static struct sensor_device dev[DEV_NUM] =
+{
+    {.name = "0", .ops = &sim_ops},
+    {.name = "1", .ops = &sim_ops},
+    {.name = "2", .ops = &sim_ops},
+    {.name = "3", .ops = &sim_ops},
+    {.name = "4", .ops = &sim_ops},
+    {.name = "5", .ops = &sim_ops},
+};
+static uint8_t single_cfg[2][CH_NUM];
+static struct sensor_group_cfg group_cfg[CH_NUM];
+
+static bool single_add(sensor_builder_t *builder, sensor_device_t sensor)
+{
+    builder->sensor = sensor;
+    sensor->arg = builder;
+    return true;
+}
+static sensor_builder_ops_t single_ops = {.sensor_add = single_add};
+
+static sensor_builder_t budget_builder =
+{
+    .process = budget_process, .process_num = 3, .ops = &single_ops,
+    .cfg = single_cfg[0], .cfg_num = CH_NUM, .period = 1000, .budget = 300,
+};
+static sensor_builder_t plain_builder =
+{
+    .process = plain_process, .process_num = 3, .ops = &single_ops,
+    .cfg = single_cfg[1], .cfg_num = CH_NUM, .period = 1000,
+};
+static sensor_builder_t group_builder =
+{
+    .process = budget_process, .process_num = 3, .ops = &group_builder_ops,
+    .cfg = group_cfg, .cfg_num = CH_NUM, .period = 1000,
+};
+
+static sensor_builder_t measure_builder[2] =
+{
+    {.process = measure_process, .process_num = 1, .ops = &single_ops, .period = 10 * 1000},
+    {.process = measure_process, .process_num = 1, .ops = &single_ops, .period = 60 * 1000},
+};
+
+static bool all_status(uint8_t id, data_status_e st)
+{
+    for(uint8_t i = 0; i < CH_NUM; i++) {
+        if(status[id][i] != st) {
+            return false;
+        }
+    }
+    return true;
+}
+/**
+ * @brief  执行一轮调度
+ * @param  now: 调度时间(ms)
+ * @param  mode: 故障注入方式
+ * @param  id: 注入故障的传感器
+ */
+static void run(uint32_t now, uint8_t mode, uint8_t id)
+{
+    host_tick = now;
+    hang_mode = mode;
+    hang_sensor = id;
+    sensor_director_process();
+}
+
+static int test_single(void)
+{
+    //协作退出:阶段预算处终止,跳过后续阶段,通道无效,相邻构建器不受影响
+    run(0, HANG_COOP, 0);
+    TEST_ASSERT(budget_builder.overrun == 1 && budget_builder.overrun_id == 0);
+    TEST_ASSERT(budget_builder.run_time >= 100 && budget_builder.run_time <= 101);
+    TEST_ASSERT(stage_runs[0][1] == 0 && stage_runs[0][2] == 0);
+    TEST_ASSERT(all_status(0, DATA_STATUS_INVALID));
+    TEST_ASSERT(stage_runs[1][2] == 1 && all_status(1, DATA_STATUS_VALID));
+    TEST_ASSERT(sensor_stats_get(&dev[0])->timeout == 1);
+
+    //阻塞阶段返回后判定超时
+    run(1000, HANG_BLOCK, 0);
+    TEST_ASSERT(budget_builder.overrun == 2 && stage_runs[0][1] == 0);
+    TEST_ASSERT(all_status(0, DATA_STATUS_INVALID));
+
+    //正常执行不触发
+    run(2000, HANG_NONE, 0);
+    TEST_ASSERT(budget_builder.overrun == 2 && stage_runs[0][2] == 1);
+    TEST_ASSERT(all_status(0, DATA_STATUS_VALID));
+
+    //延误后相邻构建器按原周期继续
+    TEST_ASSERT(plain_builder.next_run == 3000);
+    return 0;
+}
+
+static int test_group(void)
+{
+    //组内成员2、3,成员3阻塞超时,两个成员通道均标记为无效
+    for(uint8_t i = 0; i < CH_NUM; i++) {
+        status[2][i] = DATA_STATUS_VALID;
+        status[3][i] = DATA_STATUS_VALID;
+    }
+    run(0, HANG_BLOCK, 3);
+    TEST_ASSERT(group_builder.overrun == 1);
+    TEST_ASSERT(all_status(2, DATA_STATUS_INVALID));
+    TEST_ASSERT(all_status(3, DATA_STATUS_INVALID));
+    return 0;
+}
+
+static int test_group_retry(void)
+{
+    //成员2采集失败,每次耗时60ms,第二次采集后截止时间到达,中止重采
+    sensor_process_ops_t *process = group_builder.process;
+    uint8_t process_num = group_builder.process_num;
+    const sensor_stats_t *stats[2] = {sensor_stats_get(&dev[2]), sensor_stats_get(&dev[3])};
+    uint32_t timeout[2] = {stats[0]->timeout, stats[1]->timeout};
+    uint32_t retry = stats[0]->retry;
+    uint32_t restart = host_restart_count;
+    group_builder.process = retry_process;
+    group_builder.process_num = 1;
+    group_cfg[0].allow_retry_collect_cnt = 3;
+    group_cfg[0].allow_collect_fail_cnt = 0;
+    collect_fail[2] = true;
+    collect_ms = FAIL_COLLECT_MS;
+    run(2000, HANG_NONE, 0);
+    //超时记入成员2,builder->sensor(最后加入的成员3)由构建器阶段判定记录;不计入采集失败,不重启
+    TEST_ASSERT(group_builder.overrun == 2 && stats[0]->retry == retry + 1);
+    TEST_ASSERT(stats[0]->timeout == timeout[0] + 1 && stats[1]->timeout == timeout[1] + 1);
+    TEST_ASSERT(host_restart_count == restart);
+
+    //未到截止时间时重采次数用尽,按采集失败处理
+    collect_ms = 0;
+    run(3000, HANG_NONE, 0);
+    TEST_ASSERT(group_builder.overrun == 2 && stats[0]->retry == retry + 4);
+    TEST_ASSERT(stats[0]->timeout == timeout[0] + 1);
+    TEST_ASSERT(host_restart_count == restart + 1);
+
+    collect_fail[2] = false;
+    group_builder.process = process;
+    group_builder.process_num = process_num;
+    return 0;
+}
+
+static int test_idle(void)
+{
+    //最近执行时间较远时空闲时间按上限截断,默认休眠按空闲时间延时
+    host_tick = 5000;
+    group_builder.next_run = 65000;
+    TEST_ASSERT(sensor_director_idle_time() == 1000);
+    sensor_director_sleep();
+    TEST_ASSERT(host_tick == 6000);
+    group_builder.next_run = 6300;
+    TEST_ASSERT(sensor_director_idle_time() == 300);
+    return 0;
+}
+
+static int test_group_lpm(void)
+{
+    //组策略低功耗遍历全部成员,不只builder->sensor
+    host_tick = 10000;
+    group_builder.next_run = 10500;
+    group_builder.lpm_enable = true;
+    sensor_open(&dev[2]);
+    sensor_open(&dev[3]);
+    sensor_director_sleep();
+    TEST_ASSERT(group_builder.lpm_state == true);
+    TEST_ASSERT(powered[2] == false && powered[3] == false);
+    //到期时全部成员退出低功耗
+    run(10500, HANG_NONE, 0);
+    TEST_ASSERT(group_builder.lpm_state == false);
+    TEST_ASSERT(powered[2] == true && powered[3] == true);
+    group_builder.lpm_enable = false;
+    return 0;
+}
+/**
+ * @brief  仿真结果
+ */
+typedef struct
+{
+    double   current;       //平均电流(uA)
+    uint32_t cycles;        //采集次数
+    uint32_t opens;         //传感器打开次数
+    uint32_t wakes;         //调度循环次数
+}sim_result_t;
+/**
+ * @brief  电流仿真
+ * @param  sleep: true:调度空闲休眠 false:持续运行
+ * @param  mode: 传感器电源控制方式
+ * @param  lpm: 构建器使能低功耗
+ */
+static void simulate(bool sleep, uint8_t mode, bool lpm, sim_result_t *res)
+{
+    uint32_t run_ms = 0;
+    memset(res, 0, sizeof(sim_result_t));
+    power_mode = mode;
+    host_tick = 0;
+    for(uint8_t i = 0; i < 2; i++) {
+        uint8_t id = sensor_index(&dev[4 + i]);
+        measure_builder[i].next_run = 0;
+        measure_builder[i].lpm_enable = lpm;
+        measure_builder[i].lpm_state = false;
+        powered[id] = false;
+        powered_ms[id] = 0;
+        opens[id] = 0;
+        stage_runs[id][0] = 0;
+    }
+    while(host_tick < SIM_TIME) {
+        uint32_t start = host_tick;
+        sensor_director_process();
+        run_ms += host_tick - start;
+        res->wakes++;
+        if(sleep == true) {
+            sensor_director_sleep();
+        } else {
+            host_tick++;
+            run_ms++;
+        }
+    }
+    double sensor_ms = 0;
+    for(uint8_t i = 0; i < 2; i++) {
+        uint8_t id = sensor_index(&dev[4 + i]);
+        sim_close(&dev[4 + i]);
+        sensor_ms += powered_ms[id];
+        res->cycles += stage_runs[id][0];
+        res->opens += opens[id];
+    }
+    //持续运行时调度循环开销已计入运行时间
+    double loop_ms = (sleep == true) ? res->wakes * SIM_LOOP_MS : 0;
+    double stop_ms = SIM_TIME - run_ms - loop_ms;
+    res->current = ((run_ms + loop_ms) * SIM_RUN_UA + stop_ms * SIM_STOP_UA + sensor_ms * SIM_SENSOR_UA) / SIM_TIME;
+}
+
+static int test_current(void)
+{
+    static const struct
+    {
+        const char *name;
+        bool    sleep;
+        uint8_t mode;
+        bool    lpm;
+    }sim[] =
+    {
+        {"no sleep, sensors kept on ", false, POWER_KEEP, false},
+        {"sleep, kept on + LPM      ", true,  POWER_KEEP, true},
+        {"sleep, self power         ", true,  POWER_SELF, false},
+        {"sleep, self power + LPM   ", true,  POWER_SELF, true},
+    };
+    sim_result_t res[4];
+    for(uint8_t i = 0; i < 4; i++) {
+        simulate(sim[i].sleep, sim[i].mode, sim[i].lpm, &res[i]);
+        printf("%s %8.1fuA, %lu cycles, %lu opens, %lu wakes\r\n", sim[i].name, res[i].current,
+               (unsigned long)res[i].cycles, (unsigned long)res[i].opens, (unsigned long)res[i].wakes);
+    }
+    //6小时:10s周期2160次,60s周期360次
+    for(uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT(res[i].cycles == 2520);
+    }
+    //不休眠时MCU与传感器持续运行
+    TEST_ASSERT(res[0].current > SIM_RUN_UA + 2 * SIM_SENSOR_UA - 1);
+    //调度休眠后传感器仅在采集时上电,唤醒次数受空闲时间上限约束
+    TEST_ASSERT(res[1].current < 25 && res[2].current < 25);
+    TEST_ASSERT(res[1].opens == res[1].cycles && res[2].opens == res[2].cycles);
+    TEST_ASSERT(res[2].wakes >= SIM_TIME / 1000 && res[2].wakes <= SIM_TIME / 1000 + res[2].cycles);
+    //采集阶段自行开关时再使能低功耗,调度器唤醒已关闭的传感器,每周期重复打开一次,不降低电流
+    //首次执行前未进入低功耗
+    TEST_ASSERT(res[3].opens == 2 * res[3].cycles - 2);
+    TEST_ASSERT(res[3].current >= res[2].current);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    builder_sensor_add(&budget_builder, &dev[0]);
+    builder_sensor_add(&plain_builder, &dev[1]);
+    sensor_builder_add(&budget_builder);
+    sensor_builder_add(&plain_builder);
+    fail |= test_single();
+
+    //独立构建器移出调度,单独验证组策略
+    budget_builder.sensor = NULL;
+    plain_builder.sensor = NULL;
+    builder_sensor_add(&group_builder, &dev[2]);
+    builder_sensor_add(&group_builder, &dev[3]);
+    sensor_builder_add(&group_builder);
+    fail |= test_group();
+    fail |= test_group_retry();
+    fail |= test_idle();
+    fail |= test_group_lpm();
+
+    //组策略移出调度,单独仿真电流
+    group_builder.sensor = NULL;
+    builder_sensor_add(&measure_builder[0], &dev[4]);
+    builder_sensor_add(&measure_builder[1], &dev[5]);
+    sensor_builder_add(&measure_builder[0]);
+    sensor_builder_add(&measure_builder[1]);
+    fail |= test_current();
+
+    printf("test_builder %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
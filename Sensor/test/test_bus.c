@@ -0,0 +1,214 @@
+/**
+ * @file test_bus.c
+ * @brief 传感器数据总线测试与基准
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 验证只读最新数据、回调、队列三类订阅者的行为与队列满丢弃计数,
+ * 并输出1~32个订阅者时每次发布的耗时(队列订阅者含消费者读取):
+ * gcc -ISensor/test/stub -ISensor/core Sensor/test/test_bus.c Sensor/core/sensor_bus.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <time.h>
+#include "sensor_bus.h"
+/* Private define ------------------------------------------------------------*/
+#define QUEUE_SIZE      16          //队列订阅者缓冲区
+#define BENCH_SUB_MAX   32          //基准最大订阅者数量
+#define BENCH_NUM       1000000     //基准发布次数
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static struct sensor_device dev[2] =
+{
+    {.name = "t0"},
+    {.name = "t1"},
+};
+static sensor_sample_t queue[BENCH_SUB_MAX][QUEUE_SIZE];
+static sensor_bus_sub_t bench_sub[BENCH_SUB_MAX];
+static volatile uint32_t sink;
+/* Private user code ---------------------------------------------------------*/
+static void count_callback(const sensor_sample_t *sample, void *arg)
+{
+    uint32_t *count = (uint32_t *)arg;
+    (*count)++;
+    sink += sample->ts;
+}
+
+static void bench_callback(const sensor_sample_t *sample, void *arg)
+{
+    (void)arg;
+    sink += sample->ts;
+}
+
+static int test_latest(void)
+{
+    sensor_bus_sub_t sub;
+    sensor_sample_t sample;
+
+    TEST_ASSERT(sensor_bus_sub_init(&sub, NULL, NULL, NULL, 0));
+    TEST_ASSERT(sensor_bus_subscribe(&sub, &dev[0], 0));
+    TEST_ASSERT(sensor_bus_subscribe(&sub, &dev[0], 1) == false);   //每个订阅者只订阅一个主题
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample) == false);
+
+    //其他通道与传感器不影响
+    sensor_bus_publish(&dev[0], 1, 1.0f, DATA_STATUS_VALID, 10);
+    sensor_bus_publish(&dev[1], 0, 2.0f, DATA_STATUS_VALID, 10);
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample) == false);
+
+    //只保留最新一次,读取后无新数据
+    sensor_bus_publish(&dev[0], 0, 3.0f, DATA_STATUS_VALID, 20);
+    sensor_bus_publish(&dev[0], 0, 4.0f, DATA_STATUS_OUTRANGE, 30);
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample));
+    TEST_ASSERT(sample.sensor == &dev[0] && sample.id == 0 && sample.value == 4.0f);
+    TEST_ASSERT(sample.status == DATA_STATUS_OUTRANGE && sample.ts == 30);
+    TEST_ASSERT(sensor_bus_latest(&sub, NULL) == false);
+
+    //写入中读取不等待,直接返回
+    sensor_bus_publish(&dev[0], 0, 5.0f, DATA_STATUS_VALID, 40);
+    sub.topic->seq++;
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample) == false);
+    sub.topic->seq++;
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample) && sample.value == 5.0f);
+
+    sensor_bus_unsubscribe(&sub);
+    TEST_ASSERT(sensor_bus_latest(&sub, &sample) == false);
+    return 0;
+}
+
+static int test_callback(void)
+{
+    sensor_bus_sub_t sub[2];
+    uint32_t count[2] = {0, 0};
+
+    for(uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT(sensor_bus_sub_init(&sub[i], count_callback, &count[i], NULL, 0));
+        TEST_ASSERT(sensor_bus_subscribe(&sub[i], &dev[1], 2));
+    }
+    sensor_bus_publish(&dev[1], 2, 1.0f, DATA_STATUS_VALID, 10);
+    sensor_bus_publish(&dev[1], 2, 2.0f, DATA_STATUS_VALID, 20);
+    TEST_ASSERT(count[0] == 2 && count[1] == 2);
+
+    sensor_bus_unsubscribe(&sub[0]);
+    sensor_bus_publish(&dev[1], 2, 3.0f, DATA_STATUS_VALID, 30);
+    TEST_ASSERT(count[0] == 2 && count[1] == 3);
+    sensor_bus_unsubscribe(&sub[1]);
+    return 0;
+}
+
+static int test_queue(void)
+{
+    sensor_bus_sub_t sub;
+    sensor_sample_t sample;
+
+    TEST_ASSERT(sensor_bus_sub_init(&sub, NULL, NULL, queue[0], 12) == false);    //大小须为2的幂
+    TEST_ASSERT(sensor_bus_sub_init(&sub, NULL, NULL, queue[0], QUEUE_SIZE));
+    TEST_ASSERT(sensor_bus_subscribe(&sub, &dev[1], 3));
+    TEST_ASSERT(sensor_bus_pop(&sub, &sample) == false);
+
+    //超出队列容量的新数据丢弃并计数,已入队数据按顺序读出
+    for(uint32_t i = 0; i < QUEUE_SIZE + 5; i++) {
+        sensor_bus_publish(&dev[1], 3, (float)i, DATA_STATUS_VALID, i);
+    }
+    TEST_ASSERT(sub.drop == 5);
+    for(uint32_t i = 0; i < QUEUE_SIZE; i++) {
+        TEST_ASSERT(sensor_bus_pop(&sub, &sample) && sample.ts == i);
+    }
+    TEST_ASSERT(sensor_bus_pop(&sub, &sample) == false);
+
+    //读出后恢复入队
+    sensor_bus_publish(&dev[1], 3, 100.0f, DATA_STATUS_VALID, 100);
+    TEST_ASSERT(sensor_bus_pop(&sub, &sample) && sample.value == 100.0f);
+    TEST_ASSERT(sub.drop == 5);
+    sensor_bus_unsubscribe(&sub);
+    return 0;
+}
+
+static int test_topic_full(void)
+{
+    static struct sensor_device full_dev = {.name = "full"};
+    sensor_bus_sub_t sub;
+    uint8_t id = 0;
+
+    //主题表写满后订阅失败
+    while(1) {
+        sensor_bus_sub_init(&sub, NULL, NULL, NULL, 0);
+        if(sensor_bus_subscribe(&sub, &full_dev, id) == false) {
+            break;
+        }
+        sensor_bus_unsubscribe(&sub);
+        TEST_ASSERT(++id <= SENSOR_BUS_TOPIC_MAX);
+    }
+    TEST_ASSERT(id > 0);
+    return 0;
+}
+/**
+ * @brief  发布耗时
+ * @param  mode: 0: 只读最新数据 1: 回调 2: 队列
+ * @param  num: 订阅者数量
+ * @retval 每次发布耗时(ns)
+ */
+static double bench(uint8_t mode, uint8_t num)
+{
+    sensor_sample_t sample;
+
+    for(uint8_t i = 0; i < num; i++) {
+        sensor_bus_sub_init(&bench_sub[i], (mode == 1) ? bench_callback : NULL, NULL,
+                            (mode == 2) ? queue[i] : NULL, QUEUE_SIZE);
+        sensor_bus_subscribe(&bench_sub[i], &dev[0], 0);
+    }
+    clock_t start = clock();
+    for(uint32_t k = 0; k < BENCH_NUM; k++) {
+        sensor_bus_publish(&dev[0], 0, (float)k, DATA_STATUS_VALID, k);
+        if(mode == 2) {
+            for(uint8_t i = 0; i < num; i++) {
+                sensor_bus_pop(&bench_sub[i], &sample);
+            }
+        }
+    }
+    double ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_NUM;
+    for(uint8_t i = 0; i < num; i++) {
+        sensor_bus_unsubscribe(&bench_sub[i]);
+    }
+    return ns;
+}
+
+static int test_bench(void)
+{
+    static const char *name[] = {"latest", "callback", "queue"};
+
+    for(uint8_t mode = 0; mode < 3; mode++) {
+        printf("bench %-8s:", name[mode]);
+        for(uint8_t num = 1; num <= BENCH_SUB_MAX; num *= 2) {
+            printf(" %d subs %.1f ns", num, bench(mode, num));
+        }
+        printf("\r\n");
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_latest();
+    fail |= test_callback();
+    fail |= test_queue();
+    fail |= test_bench();
+    fail |= test_topic_full();
+    printf("test_bus %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file test_compress.c
+ * @brief 压缩块编解码测试与基准
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 按现场记录特征生成一天序列:60s周期、偶发±1s抖动与漏采、少量无效与超量程;
+ * 温度:日周期变化叠加0.1C随机游走;PT100:150C工况,单次转换0.4C/LSB量化与0.5LSB噪声,
+ * 20次转换平均后按0.01C记录;SHT3x:16位温湿度码值量化与重复性噪声,温度0.1C、湿度1%记录,
+ * 偶发CRC错误;验证逐点还原、大于8KB存储区与样本数量上限,并输出各序列压缩率与编解码耗时:
+ * gcc -ISensor/test/stub -ISensor/core Sensor/test/test_compress.c Sensor/core/sensor_compress.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <time.h>
+#include "sensor_compress.h"
+/* Private define ------------------------------------------------------------*/
+#define TRACE_NUM       1440        //一天样本数量
+#define TRACE_PERIOD    60          //采集周期(s)
+#define TRACE_UNIT      10          //0.1C
+#define RAW_BYTES       9           //未压缩样本:时间戳4字节+数据4字节+状态1字节
+#define BENCH_ROUNDS    200         //基准重复次数
+#define SIM_PI          3.14159265358979
+#define PT100_LSB       0.4         //PT100单次转换温度分辨率(C/LSB)
+#define PT100_NOISE     0.5         //PT100单次转换噪声(LSB)
+#define PT100_AVG       20          //PT100每次读取平均转换次数
+#define PT100_UNIT      100         //0.01C
+#define SHT3X_T_NOISE   0.04        //SHT3x高重复性温度噪声(C)
+#define SHT3X_RH_NOISE  0.08        //SHT3x高重复性湿度噪声(%RH)
+#define SHT3X_T_UNIT    10          //0.1C
+#define SHT3X_RH_UNIT   1           //1%
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint32_t      ts;
+    float         value;
+    data_status_e status;
+}sample_t;
+
+typedef struct
+{
+    const char *name;
+    sample_t   *trace;
+    float       unit;
+}trace_info_t;
+/* Private variables ---------------------------------------------------------*/
+static sample_t trace[TRACE_NUM];
+static sample_t pt100_trace[TRACE_NUM];
+static sample_t sht3x_t_trace[TRACE_NUM];
+static sample_t sht3x_rh_trace[TRACE_NUM];
+static const trace_info_t trace_list[] =
+{
+    {"temp",     trace,          TRACE_UNIT},
+    {"pt100",    pt100_trace,    PT100_UNIT},
+    {"sht3x_t",  sht3x_t_trace,  SHT3X_T_UNIT},
+    {"sht3x_rh", sht3x_rh_trace, SHT3X_RH_UNIT},
+};
+static uint8_t  store_buf[16384];
+static uint8_t  large_buf[32768];
+static uint32_t rand_state = 1;
+/* Private user code ---------------------------------------------------------*/
+static uint32_t rand_next(void)
+{
+    rand_state = rand_state * 1103515245 + 12345;
+    return (rand_state >> 16) & 0x7FFF;
+}
+/**
+ * @brief  标准正态分布随机数
+ */
+static double rand_gauss(void)
+{
+    double u1 = (rand_next() + 1.0) / 32769.0;
+    double u2 = (rand_next() + 1.0) / 32769.0;
+    return sqrt(-2 * log(u1)) * cos(2 * SIM_PI * u2);
+}
+/**
+ * @brief  下一个采集时间戳
+ * @note   偶发任务调度抖动与漏采
+ */
+static uint32_t ts_next(uint32_t ts)
+{
+    uint32_t r = rand_next() % 100;
+    ts += TRACE_PERIOD;
+    if(r < 5) {
+        ts += (r & 1) ? 1 : -1;             //任务调度抖动
+    } else if(r == 5) {
+        ts += TRACE_PERIOD;                 //漏采一次
+    }
+    return ts;
+}
+/**
+ * @brief  生成一天温度序列
+ */
+static void trace_make(void)
+{
+    uint32_t ts = 1760000000;
+    float    noise = 0;
+
+    for(uint16_t i = 0; i < TRACE_NUM; i++) {
+        ts = ts_next(ts);
+        if(rand_next() % 4 == 0) {
+            noise += (rand_next() & 1) ? 0.1f : -0.1f;
+        }
+        trace[i].ts = ts;
+        trace[i].value = (float)(20.0 + 6.0 * sin(2 * SIM_PI * i / TRACE_NUM)) + noise;
+        trace[i].status = DATA_STATUS_VALID;
+        uint32_t r = rand_next() % 200;
+        if(r == 0) {
+            trace[i].status = DATA_STATUS_INVALID;
+        } else if(r == 1) {
+            trace[i].status = DATA_STATUS_OUTRANGE;
+        }
+    }
+}
+/**
+ * @brief  生成一天PT100序列
+ * @note   150C工况缓慢漂移;每次读取为PT100_AVG次转换码值平均,
+ *         转换码值为温度加噪声后按PT100_LSB量化;少量开路按超量程
+ */
+static void pt100_trace_make(void)
+{
+    uint32_t ts = 1760000000;
+
+    for(uint16_t i = 0; i < TRACE_NUM; i++) {
+        double t = 150.0 + 2.0 * sin(2 * SIM_PI * i / TRACE_NUM) + 0.5 * sin(2 * SIM_PI * i / 97);
+        long sum = 0;
+        for(uint8_t n = 0; n < PT100_AVG; n++) {
+            sum += lround(t / PT100_LSB + PT100_NOISE * rand_gauss());
+        }
+        ts = ts_next(ts);
+        pt100_trace[i].ts = ts;
+        pt100_trace[i].value = (float)((double)sum / PT100_AVG * PT100_LSB);
+        pt100_trace[i].status = (rand_next() % 500 == 0) ? DATA_STATUS_OUTRANGE : DATA_STATUS_VALID;
+    }
+}
+/**
+ * @brief  生成一天SHT3x温湿度序列
+ * @note   室内温度日变化,湿度随温度反向变化;按sht3x.c换算16位码值,
+ *         偶发CRC错误时温湿度均无效
+ */
+static void sht3x_trace_make(void)
+{
+    uint32_t ts = 1760000000;
+
+    for(uint16_t i = 0; i < TRACE_NUM; i++) {
+        double phase = sin(2 * SIM_PI * i / TRACE_NUM);
+        double t = 22.0 + 3.0 * phase + SHT3X_T_NOISE * rand_gauss();
+        double rh = 50.0 - 10.0 * phase + SHT3X_RH_NOISE * rand_gauss();
+        uint16_t temp_value = (uint16_t)lround((t + 45.0) * 65535.0 / 175.0);
+        uint16_t humi_value = (uint16_t)lround(rh * 65535.0 / 100.0);
+        data_status_e status = (rand_next() % 500 == 0) ? DATA_STATUS_INVALID : DATA_STATUS_VALID;
+        ts = ts_next(ts);
+        sht3x_t_trace[i].ts = ts;
+        sht3x_t_trace[i].value = 175.0f * (float)temp_value / 65535.0f - 45.0f;
+        sht3x_t_trace[i].status = status;
+        sht3x_rh_trace[i].ts = ts;
+        sht3x_rh_trace[i].value = 100.0f * (float)humi_value / 65535.0f;
+        sht3x_rh_trace[i].status = status;
+    }
+}
+
+static int test_trace(const trace_info_t *info)
+{
+    const sample_t *trace = info->trace;
+    sensor_compress_t block;
+    sensor_compress_iter_t iter;
+
+    sensor_compress_init(&block, store_buf, sizeof(store_buf), info->unit);
+    for(uint16_t i = 0; i < TRACE_NUM; i++) {
+        TEST_ASSERT(sensor_compress_append(&block, trace[i].ts, trace[i].value, trace[i].status));
+    }
+    TEST_ASSERT(block.count == TRACE_NUM);
+
+    sensor_compress_iter_init(&block, &iter);
+    for(uint16_t i = 0; i < TRACE_NUM; i++) {
+        uint32_t ts = 0;
+        float value = 0;
+        data_status_e status = DATA_STATUS_NONE;
+        TEST_ASSERT(sensor_compress_next(&block, &iter, &ts, &value, &status));
+        TEST_ASSERT(ts == trace[i].ts && status == trace[i].status);
+        if(status == DATA_STATUS_VALID) {
+            TEST_ASSERT(fabsf(value - trace[i].value) <= 0.5f / info->unit + 1e-4f);
+        }
+    }
+    TEST_ASSERT(sensor_compress_next(&block, &iter, NULL, NULL, NULL) == false);
+
+    uint16_t bytes = sensor_compress_bytes(&block);
+    printf("%s: %d samples %d bytes, %.2f bytes/sample, ratio %.1fx\r\n", info->name, TRACE_NUM, bytes,
+           (float)bytes / TRACE_NUM, (float)TRACE_NUM * RAW_BYTES / bytes);
+    TEST_ASSERT(bytes * 4 < TRACE_NUM * RAW_BYTES);
+    return 0;
+}
+
+static int test_large(void)
+{
+    sensor_compress_t block;
+    sensor_compress_iter_t iter;
+    uint32_t n = 0;
+
+    //数据逐点变化,写满16KB存储区,写入位置超出16位
+    sensor_compress_init(&block, store_buf, sizeof(store_buf), TRACE_UNIT);
+    while(sensor_compress_append(&block, n * TRACE_PERIOD, (float)(n % 200) / TRACE_UNIT, DATA_STATUS_VALID)) {
+        n++;
+    }
+    TEST_ASSERT(block.bit_pos > 0xFFFF && block.bit_pos <= sizeof(store_buf) * 8);
+    TEST_ASSERT(sensor_compress_bytes(&block) <= sizeof(store_buf));
+    sensor_compress_iter_init(&block, &iter);
+    for(uint32_t i = 0; i < n; i++) {
+        uint32_t ts = 0;
+        float value = 0;
+        TEST_ASSERT(sensor_compress_next(&block, &iter, &ts, &value, NULL));
+        TEST_ASSERT(ts == i * TRACE_PERIOD && lroundf(value * TRACE_UNIT) == (long)(i % 200));
+    }
+
+    //恒定数据每个样本3bit,样本数量先于空间达到上限
+    sensor_compress_init(&block, large_buf, sizeof(large_buf), TRACE_UNIT);
+    for(n = 0; n < UINT16_MAX; n++) {
+        TEST_ASSERT(sensor_compress_append(&block, n * TRACE_PERIOD, 0, DATA_STATUS_VALID));
+    }
+    TEST_ASSERT(sensor_compress_append(&block, n * TRACE_PERIOD, 0, DATA_STATUS_VALID) == false);
+    TEST_ASSERT(block.count == UINT16_MAX);
+    return 0;
+}
+
+static int test_bench(const trace_info_t *info)
+{
+    const sample_t *trace = info->trace;
+    sensor_compress_t block;
+    sensor_compress_iter_t iter;
+    uint32_t decoded = 0;
+
+    clock_t start = clock();
+    for(uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        sensor_compress_init(&block, store_buf, sizeof(store_buf), info->unit);
+        for(uint16_t i = 0; i < TRACE_NUM; i++) {
+            sensor_compress_append(&block, trace[i].ts, trace[i].value, trace[i].status);
+        }
+    }
+    double append_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)BENCH_ROUNDS * TRACE_NUM);
+
+    start = clock();
+    for(uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        sensor_compress_iter_init(&block, &iter);
+        while(sensor_compress_next(&block, &iter, NULL, NULL, NULL)) {
+            decoded++;
+        }
+    }
+    double next_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / ((double)BENCH_ROUNDS * TRACE_NUM);
+    printf("%s bench: append %.0f ns/sample, next %.0f ns/sample\r\n", info->name, append_ns, next_ns);
+    TEST_ASSERT(decoded == (uint32_t)BENCH_ROUNDS * TRACE_NUM);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    trace_make();
+    pt100_trace_make();
+    sht3x_trace_make();
+    for(uint8_t i = 0; i < sizeof(trace_list) / sizeof(trace_list[0]); i++) {
+        fail |= test_trace(&trace_list[i]);
+    }
+    fail |= test_large();
+    for(uint8_t i = 0; i < sizeof(trace_list) / sizeof(trace_list[0]); i++) {
+        fail |= test_bench(&trace_list[i]);
+    }
+    printf("test_compress %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
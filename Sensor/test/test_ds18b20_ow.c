@@ -0,0 +1,104 @@
+/**
+ * @file test_ds18b20_ow.c
+ * @brief 单总线事务编解码测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 验证写入字节低位先行展开为时隙、读取标记、回读解码(器件拉低时回读值不固定)、
+ * 写入时隙回读不一致时报告冲突,以及事务长度上限:
+ * gcc -ISensor/driver/ds18b20_uart Sensor/test/test_ds18b20_ow.c
+ *     Sensor/driver/ds18b20_uart/ds18b20_ow.c
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ds18b20_ow.h"
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static ow_txn_t txn;
+/* Private user code ---------------------------------------------------------*/
+static int test_encode(void)
+{
+    //跳过ROM+读取暂存器,读取2字节
+    static const uint8_t cmd[2] = {0xCC, 0xBE};
+    //0xCC低位先行: 0,0,1,1,0,0,1,1
+    static const uint8_t slots[8] = {OW_SLOT_0, OW_SLOT_0, OW_SLOT_1, OW_SLOT_1,
+                                     OW_SLOT_0, OW_SLOT_0, OW_SLOT_1, OW_SLOT_1};
+    ow_txn_init(&txn);
+    TEST_ASSERT(ow_txn_write(&txn, cmd, sizeof(cmd)) == true);
+    TEST_ASSERT(ow_txn_read(&txn, 2) == true);
+    TEST_ASSERT(txn.len == 32);
+    TEST_ASSERT(memcmp(txn.tx, slots, sizeof(slots)) == 0);
+    for(uint8_t i = 16; i < 32; i++) {
+        TEST_ASSERT(txn.tx[i] == OW_SLOT_1);
+    }
+    TEST_ASSERT(txn.read_mask == 0x0C);
+    return 0;
+}
+
+static int test_decode(void)
+{
+    //写入时隙回读与发送相同;读取时隙器件拉低时回读值随拉低时刻不同
+    static const uint8_t data[2] = {0xA5, 0x3C};
+    static const uint8_t low[3] = {0x00, 0xF0, 0xFE};
+    memcpy(txn.rx, txn.tx, 16);
+    for(uint8_t k = 0; k < 2; k++) {
+        for(uint8_t b = 0; b < 8; b++) {
+            txn.rx[16 + k * 8 + b] = ((data[k] >> b) & 0x01) ? OW_SLOT_1 : low[(k + b) % 3];
+        }
+    }
+    TEST_ASSERT(ow_txn_decode(&txn) == true);
+    TEST_ASSERT(txn.read_len == 2 && txn.data[0] == 0xA5 && txn.data[1] == 0x3C);
+
+    //写1时隙被拉低,总线冲突
+    txn.rx[2] = 0xF8;
+    TEST_ASSERT(ow_txn_decode(&txn) == false);
+    //写0时隙回读为高,总线未被驱动
+    txn.rx[2] = OW_SLOT_1;
+    txn.rx[0] = OW_SLOT_1;
+    TEST_ASSERT(ow_txn_decode(&txn) == false);
+    return 0;
+}
+
+static int test_capacity(void)
+{
+    //写满后不能再添加,失败时事务不变
+    static const uint8_t fill[OW_TXN_BYTES] = {0};
+    ow_txn_init(&txn);
+    TEST_ASSERT(ow_txn_write(&txn, fill, OW_TXN_BYTES) == true);
+    TEST_ASSERT(ow_txn_read(&txn, 1) == false);
+    TEST_ASSERT(ow_txn_write(&txn, fill, 1) == false);
+    TEST_ASSERT(txn.len == OW_TXN_SLOTS && txn.read_mask == 0);
+
+    //匹配ROM读取暂存器为最长事务:命令+ROM+命令+9字节
+    ow_txn_init(&txn);
+    TEST_ASSERT(ow_txn_write(&txn, fill, 1 + 8 + 1) == true);
+    TEST_ASSERT(ow_txn_read(&txn, 9) == true);
+    TEST_ASSERT(txn.len == 19 * 8);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_encode();
+    fail |= test_decode();
+    fail |= test_capacity();
+    printf("test_ds18b20_ow %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
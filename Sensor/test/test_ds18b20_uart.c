@@ -0,0 +1,632 @@
+/**
+ * @file test_ds18b20_uart.c
+ * @brief DS18B20串口单总线仿真测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 按时隙模拟总线上0~8个DS18B20:串口写入时隙后各器件按状态机输出,总线为线与;
+ * 9600波特率的0xF0为复位脉冲。随机ROM(含长公共前缀)下验证搜索枚举完整、
+ * 非DS18B20与CRC错误的器件被丢弃、搜索数量上限,以及转换后按ROM读取温度;
+ * 9~12位分辨率设置与掉电保存、配置相同时不重复写EEPROM、轮询转换完成的耗时与超时。
+ * 加-DDS18B20_USE_DMA=1编译DMA模式:DMA发送时逐字节经过总线模型写入接收缓冲区,
+ * 完成中断在等待钩子中投递;另验证异步事务、忙状态、DMA无响应超时与释放,以及操作之间串口保持初始化:
+ * gcc -ISensor/test/stub -ISensor/core -ISensor/driver/ds18b20_uart Sensor/test/test_ds18b20_uart.c
+ *     Sensor/test/stub/host_stub.c Sensor/core/sensor_time.c Sensor/driver/ds18b20_uart/ds18b20.c
+ *     Sensor/driver/ds18b20_uart/ds18b20_ow.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ds18b20.h"
+/* Private typedef -----------------------------------------------------------*/
+/**
+ * @brief  器件状态
+ */
+typedef enum
+{
+    OW_ROM = 0,     //接收ROM指令
+    OW_SEARCH,      //搜索ROM
+    OW_MATCH,       //匹配ROM
+    OW_FUNC,        //接收功能命令
+    OW_READ,        //输出暂存器
+    OW_WRITE,       //写入暂存器
+    OW_CONVERT,     //转换中,读时隙返回转换状态
+    OW_IDLE,        //未选中,等待复位
+}ow_state_t;
+/**
+ * @brief  模拟器件
+ */
+typedef struct
+{
+    uint8_t     rom[DS18B20_ROM_LEN];
+    uint8_t     pad[9];         //暂存器
+    int16_t     temp;           //当前温度(1/16℃)
+    ow_state_t  state;
+    uint8_t     cmd;            //接收中的命令
+    uint8_t     bits;           //已接收命令位数
+    uint8_t     bit;            //ROM/暂存器位位置
+    uint8_t     phase;          //搜索:0输出位 1输出补码 2接收方向
+    bool        converting;     //转换进行中
+    uint32_t    conv_end;       //转换完成时间(ms)
+    uint32_t    copies;         //复制到EEPROM次数
+}sim_dev_t;
+/* Private define ------------------------------------------------------------*/
+#define SIM_DEV_MAX     8           //总线器件数量上限
+#define SEARCH_TRIALS   1800        //搜索测试次数
+#define UART_TX_IDLE    0x1FF       //TDR无待发送数据
+#define RX_LOW          0xF8        //读时隙被器件拉低时的回读
+#define RX_PRESENCE     0xE0        //复位时存在脉冲的回读
+#define FAMILY_DS18S20  0x10
+//DMA模式操作之间保持串口初始化,轮询模式每次操作后释放
+#define UART_KEEP       (DS18B20_USE_DMA == 1)
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static sim_dev_t sim_dev[SIM_DEV_MAX];
+static uint8_t   sim_num;           //总线器件数量
+static uint32_t  sim_slots;         //时隙数量
+static bool      sim_uart_ready;    //串口已初始化
+static uint32_t  sim_polled;        //CPU逐个轮询的时隙数量,不含复位
+static uint32_t  sim_deinit;        //串口释放次数
+static uint32_t  sim_conv_extra;    //附加转换时间(ms),模拟器件异常
+static uint32_t  sim_seed = 1;
+static USART_TypeDef sim_usart = {.TDR = UART_TX_IDLE};
+static UART_HandleTypeDef sim_huart;
+static ds18b20_t sim_bus = {.huart = &sim_huart, .Instance = &sim_usart};
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  随机数
+ * @note   线性同余,保证结果可复现
+ */
+static uint8_t sim_rand(void)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return (uint8_t)(sim_seed >> 16);
+}
+/**
+ * @brief  器件转换时间
+ * @note   取手册最大转换时间的80%
+ */
+static uint32_t sim_conv_ms(const sim_dev_t *d)
+{
+    return DS18B20_CONV_MS((d->pad[4] >> 5) & 0x03) * 4 / 5 + sim_conv_extra;
+}
+/**
+ * @brief  转换完成后更新暂存器温度
+ * @note   低分辨率时未定义的低位置1,由驱动清零
+ */
+static void sim_latch(sim_dev_t *d)
+{
+    if(d->converting == false || host_tick < d->conv_end) {
+        return;
+    }
+    uint8_t res = (d->pad[4] >> 5) & 0x03;
+    uint16_t raw = (uint16_t)d->temp | ((1 << (DS18B20_RES_12BIT - res)) - 1);
+    d->pad[0] = raw & 0xFF;
+    d->pad[1] = raw >> 8;
+    d->pad[8] = crc8_maxim(d->pad, 8);
+    d->converting = false;
+}
+
+static uint8_t rom_bit(const sim_dev_t *d, uint8_t n)
+{
+    return (d->rom[n >> 3] >> (n & 0x07)) & 0x01;
+}
+/**
+ * @brief  读时隙器件输出
+ * @retval 0: 拉低 1: 释放
+ */
+static uint8_t sim_out(sim_dev_t *d)
+{
+    switch(d->state) {
+    case OW_SEARCH:
+        if(d->phase == 0) {
+            return rom_bit(d, d->bit);
+        } else if(d->phase == 1) {
+            return !rom_bit(d, d->bit);
+        }
+        return 1;
+    case OW_READ:
+        return (d->pad[d->bit >> 3] >> (d->bit & 0x07)) & 0x01;
+    case OW_CONVERT:
+        return d->converting == false;
+    default:
+        return 1;
+    }
+}
+/**
+ * @brief  功能命令处理
+ */
+static void sim_func(sim_dev_t *d)
+{
+    d->bit = 0;
+    switch(d->cmd) {
+    case 0xBE:
+        d->state = OW_READ;
+        break;
+    case 0x44:
+        d->state = OW_CONVERT;
+        d->converting = true;
+        d->conv_end = host_tick + sim_conv_ms(d);
+        break;
+    case 0x4E:
+        d->state = OW_WRITE;
+        break;
+    case 0x48:
+        d->copies++;
+        d->state = OW_IDLE;
+        break;
+    default:
+        d->state = OW_IDLE;
+        break;
+    }
+}
+/**
+ * @brief  器件接收一个时隙
+ * @param  v: 总线电平
+ */
+static void sim_in(sim_dev_t *d, uint8_t v)
+{
+    switch(d->state) {
+    case OW_ROM:
+    case OW_FUNC:
+        d->cmd |= v << d->bits;
+        if(++d->bits < 8) {
+            break;
+        }
+        d->bits = 0;
+        d->bit = 0;
+        d->phase = 0;
+        if(d->state == OW_FUNC) {
+            sim_func(d);
+        } else if(d->cmd == 0xF0) {
+            d->state = OW_SEARCH;
+        } else if(d->cmd == 0x55) {
+            d->state = OW_MATCH;
+        } else if(d->cmd == 0xCC) {
+            d->state = OW_FUNC;
+        } else {
+            d->state = OW_IDLE;
+        }
+        d->cmd = 0;
+        break;
+    case OW_SEARCH:
+        if(d->phase < 2) {
+            d->phase++;
+            break;
+        }
+        d->phase = 0;
+        //方向与自身不同的器件退出本次搜索
+        if(v != rom_bit(d, d->bit)) {
+            d->state = OW_IDLE;
+        } else if(++d->bit == DS18B20_ROM_LEN * 8) {
+            d->state = OW_FUNC;
+        }
+        break;
+    case OW_MATCH:
+        if(v != rom_bit(d, d->bit)) {
+            d->state = OW_IDLE;
+        } else if(++d->bit == DS18B20_ROM_LEN * 8) {
+            d->state = OW_FUNC;
+        }
+        break;
+    case OW_WRITE:
+    {
+        //TH,TL,配置寄存器;配置寄存器低5位读为1,最高位读为0
+        uint8_t *reg = &d->pad[2 + (d->bit >> 3)];
+        uint8_t mask = 1 << (d->bit & 0x07);
+        *reg = v ? (*reg | mask) : (*reg & ~mask);
+        if(++d->bit == 24) {
+            d->pad[4] = (d->pad[4] & 0x60) | 0x1F;
+            d->pad[8] = crc8_maxim(d->pad, 8);
+            d->state = OW_IDLE;
+        }
+        break;
+    }
+    case OW_READ:
+        if(++d->bit == sizeof(d->pad) * 8) {
+            d->state = OW_IDLE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+/**
+ * @brief  总线一个时隙
+ * @param  baud: 波特率,9600时为复位脉冲
+ * @param  tx: 串口发送字节
+ * @retval 串口回读字节
+ */
+static uint8_t sim_slot(uint32_t baud, uint8_t tx)
+{
+    for(uint8_t i = 0; i < sim_num; i++) {
+        sim_latch(&sim_dev[i]);
+    }
+    if(baud == 9600) {
+        for(uint8_t i = 0; i < sim_num; i++) {
+            sim_dev[i].state = OW_ROM;
+            sim_dev[i].cmd = 0;
+            sim_dev[i].bits = 0;
+        }
+        return (sim_num > 0) ? RX_PRESENCE : tx;
+    }
+    sim_slots++;
+    uint8_t line = (tx == 0xFF);
+    for(uint8_t i = 0; i < sim_num; i++) {
+        if(line == 1) {
+            line = sim_out(&sim_dev[i]);
+        }
+    }
+    for(uint8_t i = 0; i < sim_num; i++) {
+        sim_in(&sim_dev[i], line);
+    }
+    return (tx == 0x00) ? 0x00 : (line ? 0xFF : RX_LOW);
+}
+
+bool host_uart_flag(UART_HandleTypeDef *huart, uint32_t flag)
+{
+    USART_TypeDef *uart = huart->Instance;
+    (void)flag;
+    if(sim_uart_ready == false) {
+        return false;
+    }
+    if(uart->TDR != UART_TX_IDLE) {
+        sim_polled += (huart->Init.BaudRate != 9600);
+        uart->RDR = sim_slot(huart->Init.BaudRate, (uint8_t)uart->TDR);
+        uart->TDR = UART_TX_IDLE;
+    }
+    return true;
+}
+
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    sim_uart_ready = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    sim_uart_ready = false;
+    sim_deinit++;
+    return HAL_OK;
+}
+#if (DS18B20_USE_DMA == 1)
+static uint8_t  *dma_rx;            //DMA接收缓冲区
+static bool     dma_pending;        //接收完成中断待投递
+static bool     dma_stall;          //DMA无响应
+static uint32_t dma_xfers;          //DMA传输次数
+static uint8_t  txn_done;           //异步事务完成回调次数
+static float    txn_temp;           //异步事务读取的温度
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size)
+{
+    (void)huart; (void)size;
+    dma_rx = data;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size)
+{
+    dma_xfers++;
+    if(dma_stall == true) {
+        return HAL_OK;
+    }
+    for(uint16_t i = 0; i < size; i++) {
+        dma_rx[i] = sim_slot(huart->Init.BaudRate, data[i]);
+    }
+    dma_pending = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    dma_pending = false;
+    return HAL_OK;
+}
+/**
+ * @brief  等待DMA事务期间调用
+ * @note   传输在启动时已经过总线模型,此处投递接收完成中断
+ */
+void ds18b20_txn_idle(void)
+{
+    host_tick++;
+    if(dma_pending == true) {
+        dma_pending = false;
+        ds18b20_dma_isr(&sim_bus);
+    }
+}
+
+static void txn_callback(ds18b20_t *dev)
+{
+    txn_done++;
+    if(dev->result != DS18B20_ERR_OK || ds18b20_txn_temp(dev->active, &txn_temp) != DS18B20_ERR_OK) {
+        txn_temp = NAN;
+    }
+}
+#endif /* (DS18B20_USE_DMA == 1) */
+/**
+ * @brief  总线上放置器件
+ * @param  num: 器件数量
+ * @param  prefix: 非0时ROM序列号前部相同,分歧集中在低位
+ */
+static void sim_setup(uint8_t num, bool prefix)
+{
+    sim_num = num;
+    memset(sim_dev, 0, sizeof(sim_dev));
+    for(uint8_t i = 0; i < num; i++) {
+        sim_dev_t *d = &sim_dev[i];
+        d->rom[0] = 0x28;
+        for(uint8_t k = 1; k < DS18B20_ROM_LEN - 1; k++) {
+            d->rom[k] = prefix ? 0xA5 : sim_rand();
+        }
+        if(prefix == true) {
+            d->rom[6] = (sim_rand() & 0xF0) | i;
+        }
+        d->rom[7] = crc8_maxim(d->rom, 7);
+        //-55℃~125℃
+        d->temp = (int16_t)(((sim_rand() << 8) | sim_rand()) % (180 * 16) - 55 * 16);
+        d->pad[0] = 0x50;       //上电值85℃
+        d->pad[1] = 0x05;
+        d->pad[2] = 0x4B;
+        d->pad[3] = 0x46;
+        d->pad[4] = 0x7F;
+        d->pad[5] = 0xFF;
+        d->pad[7] = 0x10;
+        d->pad[8] = crc8_maxim(d->pad, 8);
+    }
+}
+/**
+ * @brief  按ROM查找器件
+ */
+static sim_dev_t *sim_find(const uint8_t *rom)
+{
+    for(uint8_t i = 0; i < sim_num; i++) {
+        if(memcmp(sim_dev[i].rom, rom, DS18B20_ROM_LEN) == 0) {
+            return &sim_dev[i];
+        }
+    }
+    return NULL;
+}
+
+static int test_search(void)
+{
+    uint32_t slots = 0, found = 0;
+    for(uint16_t trial = 0; trial < SEARCH_TRIALS; trial++) {
+        uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+        uint8_t num = 0xFF;
+        uint32_t seen = 0;
+        sim_setup(trial % (SIM_DEV_MAX + 1), (trial % 3) == 0);
+        uint32_t start = sim_slots;
+        ds18b20_err_t ret = ds18b20_search(&sim_bus, rom, SIM_DEV_MAX, &num);
+        slots += sim_slots - start;
+        found += num;
+        TEST_ASSERT(num == sim_num);
+        TEST_ASSERT(ret == ((sim_num > 0) ? DS18B20_ERR_OK : DS18B20_ERR_NO_DEV1));
+        TEST_ASSERT(sim_uart_ready == UART_KEEP);
+        for(uint8_t k = 0; k < num; k++) {
+            sim_dev_t *d = sim_find(rom[k]);
+            TEST_ASSERT(d != NULL);
+            seen |= 1U << (d - sim_dev);
+        }
+        TEST_ASSERT(seen == (1U << sim_num) - 1);
+    }
+    printf("search: %u trials, %lu devices, %.0f slots per device\r\n",
+           SEARCH_TRIALS, (unsigned long)found, (double)slots / found);
+    return 0;
+}
+
+static int test_read(void)
+{
+    for(uint16_t trial = 0; trial < 200; trial++) {
+        uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+        uint8_t num = 0;
+        sim_setup(1 + trial % SIM_DEV_MAX, (trial % 3) == 0);
+        TEST_ASSERT(ds18b20_search(&sim_bus, rom, SIM_DEV_MAX, &num) == DS18B20_ERR_OK);
+        TEST_ASSERT(ds18b20_convert(&sim_bus, DS18B20_RES_12BIT) == DS18B20_ERR_OK);
+        for(uint8_t k = 0; k < num; k++) {
+            float temp = 0;
+            TEST_ASSERT(ds18b20_read_temp(&sim_bus, rom[k], &temp) == DS18B20_ERR_OK);
+            TEST_ASSERT(temp == sim_find(rom[k])->temp / 16.0f);
+        }
+    }
+    //单个器件跳过ROM
+    float temp = 0;
+    sim_setup(1, false);
+    TEST_ASSERT(ds18b20_get_temp_skiprom(&sim_bus, &temp) == DS18B20_ERR_OK);
+    TEST_ASSERT(temp == sim_dev[0].temp / 16.0f);
+    return 0;
+}
+
+static int test_filter(void)
+{
+    //DS18S20家族码与ROM CRC错误的器件参与搜索但被丢弃
+    uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+    uint8_t num = 0;
+    sim_setup(5, false);
+    sim_dev[1].rom[0] = FAMILY_DS18S20;
+    sim_dev[1].rom[7] = crc8_maxim(sim_dev[1].rom, 7);
+    sim_dev[3].rom[7] ^= 0x01;
+    TEST_ASSERT(ds18b20_search(&sim_bus, rom, SIM_DEV_MAX, &num) == DS18B20_ERR_OK);
+    TEST_ASSERT(num == 3);
+    for(uint8_t k = 0; k < num; k++) {
+        sim_dev_t *d = sim_find(rom[k]);
+        TEST_ASSERT(d != NULL && d != &sim_dev[1] && d != &sim_dev[3]);
+    }
+    return 0;
+}
+
+static int test_max(void)
+{
+    //达到数量上限后停止搜索,结果互不相同
+    uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+    uint8_t num = 0;
+    sim_setup(SIM_DEV_MAX, true);
+    TEST_ASSERT(ds18b20_search(&sim_bus, rom, 4, &num) == DS18B20_ERR_OK);
+    TEST_ASSERT(num == 4);
+    for(uint8_t k = 0; k < num; k++) {
+        TEST_ASSERT(sim_find(rom[k]) != NULL);
+        for(uint8_t j = 0; j < k; j++) {
+            TEST_ASSERT(memcmp(rom[j], rom[k], DS18B20_ROM_LEN) != 0);
+        }
+    }
+    return 0;
+}
+
+static int test_resolution(void)
+{
+    static const float lsb[] = {0.5f, 0.25f, 0.125f, 0.0625f};
+    uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+    uint8_t num = 0;
+    sim_setup(3, false);
+    TEST_ASSERT(ds18b20_search(&sim_bus, rom, SIM_DEV_MAX, &num) == DS18B20_ERR_OK && num == 3);
+    for(uint8_t res = DS18B20_RES_9BIT; res <= DS18B20_RES_12BIT; res++) {
+        for(uint8_t k = 0; k < num; k++) {
+            TEST_ASSERT(ds18b20_set_resolution(&sim_bus, rom[k], (ds18b20_res_t)res) == DS18B20_ERR_OK);
+        }
+        //写入配置并复制到EEPROM,报警阈值保持不变
+        uint32_t copies = 0;
+        for(uint8_t i = 0; i < num; i++) {
+            TEST_ASSERT(sim_dev[i].pad[4] == ((res << 5) | 0x1F));
+            TEST_ASSERT(sim_dev[i].pad[2] == 0x4B && sim_dev[i].pad[3] == 0x46);
+            copies += sim_dev[i].copies;
+        }
+        //配置相同时只读取暂存器,不写入也不复制
+        uint32_t slots = sim_slots;
+        TEST_ASSERT(ds18b20_set_resolution(&sim_bus, rom[0], (ds18b20_res_t)res) == DS18B20_ERR_OK);
+        slots = sim_slots - slots;
+        for(uint8_t i = 0; i < num; i++) {
+            copies -= sim_dev[i].copies;
+        }
+        TEST_ASSERT(copies == 0);
+        TEST_ASSERT(slots == (1 + DS18B20_ROM_LEN + 1 + 9) * 8);
+
+        //轮询在器件完成后一个轮询间隔内返回
+        uint32_t start = host_tick;
+        TEST_ASSERT(ds18b20_convert(&sim_bus, (ds18b20_res_t)res) == DS18B20_ERR_OK);
+        uint32_t elapsed = host_tick - start;
+        printf("%u bit: convert %lums, max %ums\r\n", 9 + res, (unsigned long)elapsed, DS18B20_CONV_MS(res));
+        TEST_ASSERT(elapsed >= sim_conv_ms(&sim_dev[0]) && elapsed <= sim_conv_ms(&sim_dev[0]) + 6);
+        TEST_ASSERT(elapsed < DS18B20_CONV_MS(res));
+        //未定义的低位清零,结果为按分辨率截断的温度
+        for(uint8_t k = 0; k < num; k++) {
+            float temp = 0;
+            int16_t raw = sim_find(rom[k])->temp;
+            TEST_ASSERT(ds18b20_read_temp(&sim_bus, rom[k], &temp) == DS18B20_ERR_OK);
+            TEST_ASSERT(temp == (raw & ~((1 << (DS18B20_RES_12BIT - res)) - 1)) / 16.0f);
+            TEST_ASSERT(fabsf(temp - raw / 16.0f) < lsb[res]);
+        }
+    }
+    return 0;
+}
+
+static int test_convert_timeout(void)
+{
+    //器件超过最大转换时间未完成时返回超时,不无限等待
+    sim_setup(2, false);
+    sim_dev[0].pad[4] = 0x3F;
+    sim_dev[1].pad[4] = 0x3F;
+    sim_conv_extra = 1000;
+    uint32_t start = host_tick;
+    ds18b20_err_t ret = ds18b20_convert(&sim_bus, DS18B20_RES_10BIT);
+    uint32_t elapsed = host_tick - start;
+    sim_conv_extra = 0;
+    printf("stuck device: %lums\r\n", (unsigned long)elapsed);
+    TEST_ASSERT(ret == DS18B20_ERR_TIMEOUT);
+    TEST_ASSERT(elapsed >= DS18B20_CONV_MS(DS18B20_RES_10BIT) && elapsed <= DS18B20_CONV_MS(DS18B20_RES_10BIT) + 6);
+    TEST_ASSERT(sim_uart_ready == UART_KEEP);
+
+    //不同分辨率混用时按最高分辨率等待,全部完成后返回
+    sim_setup(2, false);
+    sim_dev[0].pad[4] = 0x1F;
+    start = host_tick;
+    TEST_ASSERT(ds18b20_convert(&sim_bus, DS18B20_RES_12BIT) == DS18B20_ERR_OK);
+    TEST_ASSERT(host_tick - start >= sim_conv_ms(&sim_dev[1]));
+    return 0;
+}
+
+#if (DS18B20_USE_DMA == 1)
+static int test_dma(void)
+{
+    static ow_txn_t txn;
+    uint8_t rom[SIM_DEV_MAX][DS18B20_ROM_LEN];
+    uint8_t num = 0;
+    uint8_t cmd = 0xBE;
+    float temp = 0;
+    sim_setup(3, false);
+    uint32_t deinit = sim_deinit;
+    TEST_ASSERT(ds18b20_search(&sim_bus, rom, SIM_DEV_MAX, &num) == DS18B20_ERR_OK && num == 3);
+    TEST_ASSERT(ds18b20_convert(&sim_bus, DS18B20_RES_12BIT) == DS18B20_ERR_OK);
+
+    //阻塞读取整个事务一次DMA传输,CPU不逐个轮询时隙
+    uint32_t polled = sim_polled, xfers = dma_xfers;
+    TEST_ASSERT(ds18b20_read_temp(&sim_bus, rom[1], &temp) == DS18B20_ERR_OK);
+    TEST_ASSERT(temp == sim_find(rom[1])->temp / 16.0f);
+    TEST_ASSERT(sim_polled == polled && dma_xfers == xfers + 1);
+
+    //异步事务:进行中再次启动返回忙,完成中断中回调解析温度
+    TEST_ASSERT(ds18b20_txn_build(&txn, rom[2], &cmd, 1, 9) == true);
+    TEST_ASSERT(ds18b20_txn_start(&sim_bus, &txn, txn_callback) == DS18B20_ERR_OK);
+    TEST_ASSERT(ds18b20_txn_start(&sim_bus, &txn, txn_callback) == DS18B20_ERR_BUSY);
+    TEST_ASSERT(sim_bus.busy == true && txn_done == 0);
+    ds18b20_txn_idle();
+    TEST_ASSERT(sim_bus.busy == false && txn_done == 1);
+    TEST_ASSERT(txn_temp == sim_find(rom[2])->temp / 16.0f);
+
+    //DMA无响应时超时返回并中止传输
+    dma_stall = true;
+    uint32_t start = host_tick;
+    ds18b20_err_t ret = ds18b20_read_temp(&sim_bus, rom[0], &temp);
+    uint32_t elapsed = host_tick - start;
+    dma_stall = false;
+    printf("dma stall: %lums\r\n", (unsigned long)elapsed);
+    TEST_ASSERT(ret == DS18B20_ERR_TIMEOUT && sim_bus.busy == false);
+    TEST_ASSERT(elapsed > 40 && elapsed < 70);
+
+    //操作之间保持串口初始化,释放时中止进行中的事务
+    TEST_ASSERT(sim_deinit == deinit && sim_uart_ready == true);
+    TEST_ASSERT(ds18b20_txn_start(&sim_bus, &txn, txn_callback) == DS18B20_ERR_OK);
+    ds18b20_release(&sim_bus);
+    ds18b20_txn_idle();
+    TEST_ASSERT(sim_bus.busy == false && txn_done == 1);
+    TEST_ASSERT(sim_deinit == deinit + 1 && sim_uart_ready == false);
+    //释放后重新复位即可继续使用
+    TEST_ASSERT(ds18b20_read_temp(&sim_bus, rom[0], &temp) == DS18B20_ERR_OK);
+    TEST_ASSERT(temp == sim_find(rom[0])->temp / 16.0f);
+    return 0;
+}
+#endif /* (DS18B20_USE_DMA == 1) */
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_search();
+    fail |= test_read();
+    fail |= test_filter();
+    fail |= test_max();
+    fail |= test_resolution();
+    fail |= test_convert_timeout();
+#if (DS18B20_USE_DMA == 1)
+    fail |= test_dma();
+#endif /* (DS18B20_USE_DMA == 1) */
+    printf("test_ds18b20_uart %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
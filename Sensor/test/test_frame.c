@@ -0,0 +1,353 @@
+/**
+ * @file test_frame.c
+ * @brief 上行数据帧编解码测试与基准
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 通道组合为PT100、SHT3X温湿度、DS18B20、门磁,设备端编码、主机端解码。
+ * 验证关键帧与差分帧还原、超量程与无效通道、确认丢失与迟到、主机重启后关键帧重新同步;
+ * 随机丢失上行帧与确认仿真,输出每帧字节数与编码耗时:
+ * gcc -ISensor/core Sensor/test/test_frame.c Sensor/core/sensor_frame.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "sensor_frame.h"
+/* Private define ------------------------------------------------------------*/
+#define CH_NUM          5
+#define CH_PT100        0
+#define CH_SHT_T        1
+#define CH_SHT_RH       2
+#define CH_DS18B20      3
+#define CH_MCS          4
+#define FRAME_SIZE      64
+#define SIM_CYCLES      10000       //仿真采集周期数
+#define SIM_UP_LOSS     10          //上行帧丢失率(%)
+#define SIM_ACK_LOSS    20          //确认丢失率(%)
+#define BENCH_NUM       1000000     //编码耗时统计次数
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static const sensor_frame_field_t field[CH_NUM] =
+{
+    [CH_PT100]   = {.unit = 10, .width = 2},    //0.1℃
+    [CH_SHT_T]   = {.unit = 10, .width = 2},    //0.1℃
+    [CH_SHT_RH]  = {.unit = 1,  .width = 1},    //1%
+    [CH_DS18B20] = {.unit = 10, .width = 2},    //0.1℃
+    [CH_MCS]     = {.unit = 1,  .width = 1},    //吸合/释放
+};
+static const sensor_frame_schema_t schema =
+{
+    .id = 0x21, .num = CH_NUM, .key_interval = 0, .field = field,
+};
+static sensor_frame_t dev;      //设备端
+static sensor_frame_t host;     //主机端
+static uint8_t buf[FRAME_SIZE];
+static uint32_t sim_seed = 1;
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  随机数
+ * @note   线性同余,保证结果可复现
+ */
+static uint32_t sim_rand(void)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return sim_seed >> 8;
+}
+
+static double sim_uniform(void)
+{
+    return (sim_rand() & 0xFFFF) / 65536.0;
+}
+/**
+ * @brief  解码结果与编码输入按通道分辨率比较
+ */
+static bool frame_equal(const float *in, const uint8_t *in_st, const float *out, const uint8_t *out_st)
+{
+    for(uint8_t i = 0; i < CH_NUM; i++) {
+        if(in_st[i] != out_st[i]) {
+            return false;
+        }
+        if(in_st[i] == SENSOR_FRAME_ST_VALID
+        && lroundf(in[i] * field[i].unit) != lroundf(out[i] * field[i].unit)) {
+            return false;
+        }
+    }
+    return true;
+}
+/**
+ * @brief  编码并解码一帧
+ * @retval 帧长度,解码失败返回0
+ */
+static uint16_t round_trip(const float *value, const uint8_t *status, float *out, uint8_t *out_st, uint8_t *seq)
+{
+    uint16_t len = sensor_frame_encode(&dev, value, status, buf, sizeof(buf));
+    if(len == 0 || sensor_frame_decode(&host, buf, len, out, out_st, seq) == false) {
+        return 0;
+    }
+    return len;
+}
+
+static void link_init(void)
+{
+    sensor_frame_init(&dev, &schema);
+    sensor_frame_init(&host, &schema);
+}
+
+static int test_keyframe(void)
+{
+    float value[CH_NUM] = {25.34f, 22.1f, 48.0f, -10.5f, 1};
+    uint8_t status[CH_NUM] = {1, 1, 1, 1, 1};
+    float out[CH_NUM];
+    uint8_t out_st[CH_NUM];
+    uint8_t seq = 0xFF;
+
+    link_init();
+    //无参考帧时为关键帧:头2字节 + 位图1字节 + 2+2+1+2+1
+    uint16_t len = round_trip(value, status, out, out_st, &seq);
+    TEST_ASSERT(len == 11 && (buf[1] & 0x80) != 0 && seq == 0);
+    TEST_ASSERT(frame_equal(value, status, out, out_st));
+    TEST_ASSERT(out[CH_PT100] == 25.3f && out[CH_DS18B20] == -10.5f);
+    //模式ID不一致
+    buf[0] = 0x22;
+    TEST_ASSERT(sensor_frame_decode(&host, buf, len, out, out_st, NULL) == false);
+    return 0;
+}
+
+static int test_delta(void)
+{
+    float value[CH_NUM] = {25.3f, 22.1f, 48.0f, -10.5f, 1};
+    uint8_t status[CH_NUM] = {1, 1, 1, 1, 1};
+    float out[CH_NUM];
+    uint8_t out_st[CH_NUM];
+    uint8_t seq = 0;
+
+    link_init();
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) != 0);
+    TEST_ASSERT(sensor_frame_ack(&host, seq) && sensor_frame_ack(&dev, seq));
+    //小变化:每通道1字节变长整数,另加参考序号
+    value[CH_PT100] += 0.2f;
+    value[CH_SHT_RH] -= 1;
+    uint16_t len = round_trip(value, status, out, out_st, &seq);
+    TEST_ASSERT(len == 2 + 1 + 1 + CH_NUM && (buf[1] & 0x80) == 0 && buf[2] == 0);
+    TEST_ASSERT(frame_equal(value, status, out, out_st));
+    //大跳变使用多字节变长整数
+    value[CH_DS18B20] = 80.0f;
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) == len + 1);
+    TEST_ASSERT(frame_equal(value, status, out, out_st));
+    return 0;
+}
+
+static int test_outrange(void)
+{
+    //超出定宽范围按超量程处理,超量程与无效通道不占数据字节
+    float value[CH_NUM] = {3300.0f, 22.1f, 300.0f, 0, 0};
+    uint8_t status[CH_NUM] = {1, SENSOR_FRAME_ST_OUTRANGE, 1, SENSOR_FRAME_ST_INVALID, 1};
+    float out[CH_NUM];
+    uint8_t out_st[CH_NUM];
+    uint8_t seq = 0;
+
+    link_init();
+    uint16_t len = round_trip(value, status, out, out_st, &seq);
+    TEST_ASSERT(len == 2 + 1 + 1 + 1 && (buf[1] & 0x40) != 0);
+    TEST_ASSERT(out_st[CH_PT100] == SENSOR_FRAME_ST_OUTRANGE && out_st[CH_SHT_T] == SENSOR_FRAME_ST_OUTRANGE);
+    TEST_ASSERT(out_st[CH_SHT_RH] == SENSOR_FRAME_ST_OUTRANGE && out_st[CH_DS18B20] == SENSOR_FRAME_ST_INVALID);
+    TEST_ASSERT(out_st[CH_MCS] == SENSOR_FRAME_ST_VALID && out[CH_MCS] == 0);
+
+    //参考帧中无效的通道恢复有效,差分帧仍可还原
+    TEST_ASSERT(sensor_frame_ack(&host, seq) && sensor_frame_ack(&dev, seq));
+    float next[CH_NUM] = {25.3f, 22.1f, 48.0f, -10.5f, 1};
+    uint8_t next_st[CH_NUM] = {1, 1, 1, 1, 1};
+    TEST_ASSERT(round_trip(next, next_st, out, out_st, &seq) != 0 && (buf[1] & 0x80) == 0);
+    TEST_ASSERT(frame_equal(next, next_st, out, out_st));
+    return 0;
+}
+
+static int test_lost_ack(void)
+{
+    float value[CH_NUM] = {25.3f, 22.1f, 48.0f, -10.5f, 1};
+    uint8_t status[CH_NUM] = {1, 1, 1, 1, 1};
+    float out[CH_NUM];
+    uint8_t out_st[CH_NUM];
+    uint8_t seq0 = 0, seq1 = 0, seq2 = 0;
+
+    link_init();
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq0) != 0);
+    TEST_ASSERT(sensor_frame_ack(&host, seq0) && sensor_frame_ack(&dev, seq0));
+
+    //帧1的确认丢失:主机参考前进,设备仍以帧0为参考,主机在最近帧中找到帧0
+    value[CH_PT100] += 0.1f;
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq1) != 0);
+    TEST_ASSERT(sensor_frame_ack(&host, seq1));
+    value[CH_PT100] += 0.1f;
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq2) != 0);
+    TEST_ASSERT(buf[2] == seq0 && frame_equal(value, status, out, out_st));
+
+    //帧1的确认迟到(帧2已发送)仍可匹配,之后差分以帧1为参考
+    TEST_ASSERT(sensor_frame_ack(&dev, seq1));
+    TEST_ASSERT(dev.unacked == 1);
+    //更早的确认与重复确认忽略
+    TEST_ASSERT(sensor_frame_ack(&dev, seq0) == false);
+    TEST_ASSERT(sensor_frame_ack(&dev, seq1) == false);
+    value[CH_PT100] += 0.1f;
+    TEST_ASSERT(round_trip(value, status, out, out_st, NULL) != 0);
+    TEST_ASSERT(buf[2] == seq1 && frame_equal(value, status, out, out_st));
+    //未发送过的帧不能确认
+    TEST_ASSERT(sensor_frame_ack(&dev, (dev.seq + 5) & SENSOR_FRAME_SEQ_MASK) == false);
+    return 0;
+}
+
+static int test_resync(void)
+{
+    float value[CH_NUM] = {25.3f, 22.1f, 48.0f, -10.5f, 1};
+    uint8_t status[CH_NUM] = {1, 1, 1, 1, 1};
+    float out[CH_NUM];
+    uint8_t out_st[CH_NUM];
+    uint8_t seq = 0;
+
+    link_init();
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) != 0);
+    TEST_ASSERT(sensor_frame_ack(&host, seq) && sensor_frame_ack(&dev, seq));
+
+    //主机重启丢失参考:差分帧无法解码,设备连续未确认后发送关键帧重新同步
+    sensor_frame_init(&host, &schema);
+    uint8_t fail = 0;
+    for(uint8_t i = 0; i < SENSOR_FRAME_UNACK_MAX; i++) {
+        uint16_t len = sensor_frame_encode(&dev, value, status, buf, sizeof(buf));
+        TEST_ASSERT(len != 0 && (buf[1] & 0x80) == 0);
+        if(sensor_frame_decode(&host, buf, len, out, out_st, NULL) == false) {
+            fail++;
+        }
+    }
+    TEST_ASSERT(fail == SENSOR_FRAME_UNACK_MAX);
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) != 0 && (buf[1] & 0x80) != 0);
+    TEST_ASSERT(frame_equal(value, status, out, out_st));
+    TEST_ASSERT(sensor_frame_ack(&host, seq) && sensor_frame_ack(&dev, seq));
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) != 0 && (buf[1] & 0x80) == 0);
+
+    //reset后下一帧为关键帧
+    sensor_frame_reset(&dev);
+    TEST_ASSERT(round_trip(value, status, out, out_st, &seq) != 0 && (buf[1] & 0x80) != 0);
+    return 0;
+}
+/**
+ * @brief  生成一个采集周期数据
+ * @note   PT100与SHT3X温度缓慢漂移加噪声,湿度随温度反向变化,DS18B20按0.0625℃量化,门磁偶尔翻转
+ */
+static void trace_next(float *value, uint8_t *status, uint32_t n)
+{
+    double drift = 3.0 * sin(n * 2 * 3.14159265 / 1440);
+    value[CH_PT100]   = (float)(60.0 + 2 * drift + (sim_uniform() - 0.5) * 0.2);
+    value[CH_SHT_T]   = (float)(22.0 + drift + (sim_uniform() - 0.5) * 0.1);
+    value[CH_SHT_RH]  = (float)(50.0 - 2 * drift + (sim_uniform() - 0.5) * 1.0);
+    value[CH_DS18B20] = roundf((float)(8.0 + drift / 2) * 16) / 16;
+    if(sim_rand() % 200 == 0) {
+        value[CH_MCS] = (value[CH_MCS] == 0) ? 1 : 0;
+    }
+    for(uint8_t i = 0; i < CH_NUM; i++) {
+        status[i] = SENSOR_FRAME_ST_VALID;
+    }
+    //DS18B20偶尔读取失败
+    if(sim_rand() % 100 == 0) {
+        status[CH_DS18B20] = SENSOR_FRAME_ST_INVALID;
+    }
+}
+
+static int test_link(void)
+{
+    float value[CH_NUM] = {0}, out[CH_NUM];
+    uint8_t status[CH_NUM], out_st[CH_NUM];
+    uint32_t sent = 0, received = 0, decoded = 0, keys = 0, bytes = 0;
+    uint32_t key_bytes = 0, delta_bytes = 0;
+
+    link_init();
+    for(uint32_t n = 0; n < SIM_CYCLES; n++) {
+        trace_next(value, status, n);
+        uint16_t len = sensor_frame_encode(&dev, value, status, buf, sizeof(buf));
+        TEST_ASSERT(len != 0);
+        sent++;
+        bytes += len;
+        if(buf[1] & 0x80) {
+            keys++;
+            key_bytes += len;
+        } else {
+            delta_bytes += len;
+        }
+        if(sim_rand() % 100 < SIM_UP_LOSS) {
+            continue;
+        }
+        received++;
+        uint8_t seq = 0;
+        if(sensor_frame_decode(&host, buf, len, out, out_st, &seq) == false) {
+            continue;
+        }
+        TEST_ASSERT(frame_equal(value, status, out, out_st));
+        decoded++;
+        sensor_frame_ack(&host, seq);
+        if(sim_rand() % 100 >= SIM_ACK_LOSS) {
+            sensor_frame_ack(&dev, seq);
+        }
+    }
+    //设备端参考均为主机已解码的帧,收到的帧全部可解码
+    printf("link: %lu sent, %lu received, %lu decoded, %lu keyframes\r\n",
+           (unsigned long)sent, (unsigned long)received, (unsigned long)decoded, (unsigned long)keys);
+    printf("bytes/frame: %.2f average, keyframe %.2f, delta %.2f (float+status %u)\r\n",
+           (double)bytes / sent, (double)key_bytes / keys, (double)delta_bytes / (sent - keys),
+           (unsigned)(CH_NUM * (sizeof(float) + 1)));
+    TEST_ASSERT(decoded == received);
+    TEST_ASSERT((double)delta_bytes / (sent - keys) < (double)key_bytes / keys);
+    return 0;
+}
+
+static int bench_encode(void)
+{
+    float value[CH_NUM] = {0};
+    uint8_t status[CH_NUM];
+    volatile uint32_t sink = 0;
+
+    link_init();
+    trace_next(value, status, 0);
+    TEST_ASSERT(sensor_frame_encode(&dev, value, status, buf, sizeof(buf)) != 0);
+    sensor_frame_ack(&dev, 0);
+    //确认每帧,保持差分编码
+    clock_t t0 = clock();
+    for(uint32_t n = 0; n < BENCH_NUM; n++) {
+        value[CH_PT100] += (n & 1) ? 0.1f : -0.1f;
+        sink += sensor_frame_encode(&dev, value, status, buf, sizeof(buf));
+        sensor_frame_ack(&dev, (dev.seq - 1) & SENSOR_FRAME_SEQ_MASK);
+    }
+    double ns = (double)(clock() - t0) * 1e9 / CLOCKS_PER_SEC / BENCH_NUM;
+    printf("encode+ack: %.0fns per frame\r\n", ns);
+    TEST_ASSERT(sink != 0);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_keyframe();
+    fail |= test_delta();
+    fail |= test_outrange();
+    fail |= test_lost_ack();
+    fail |= test_resync();
+    fail |= test_link();
+    fail |= bench_encode();
+    printf("test_frame %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
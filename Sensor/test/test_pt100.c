@@ -0,0 +1,485 @@
+/**
+ * @file test_pt100.c
+ * @brief PT100温度换算精度测试与基准
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 直接包含sensor_pt100.c以测试内部换算函数与电阻表;以双精度Callendar-Van Dusen方程为参考,
+ * 验证-200℃~850℃全量程换算误差、编译期电阻表与超量程处理,并输出与牛顿迭代求解的耗时对比;
+ * 模拟ADS1015按通道与量程返回码值,验证自动量程削顶后增大量程重采、最大量程仍削顶时按超量程输出;
+ * -200℃~850℃往返扫描验证量程只在回差阈值处单向切换、阈值附近往复不抖动,输出各量程每次读取转换次数、
+ * 重采次数与℃/LSB;
+ * 冷启动与参考电压已缓存时单次采集的I2C传输次数,以及两路同时打开时模块一次扫描采集两路:
+ * gcc -ISensor/test/stub -ISensor/core -ISensor/driver/ads1015 -ISensor/driver/pt100 Sensor/test/test_pt100.c
+ *     Sensor/test/stub/host_stub.c Sensor/core/sensor_driver.c Sensor/core/sensor_time.c Sensor/core/sensor_log.c
+ *     Sensor/core/sensor_alarm.c Sensor/core/sensor_bus.c Sensor/driver/ads1015/ads1015.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <time.h>
+#include "../driver/pt100/sensor_pt100.c"
+/* Private define ------------------------------------------------------------*/
+#define SWEEP_STEP      0.01        //全量程扫描步长(℃)
+#define TEMP_TOL        0.005       //换算误差上限(℃),远小于0.1℃显示精度
+#define LUT_TOL         1e-4        //电阻表相对误差上限
+#define BENCH_NUM       1000000     //基准换算次数
+#define SIM_REF_MV      1500.0      //参考电阻电压(mV)
+#define SIM_TEMP_TOL    0.3         //采集温度误差上限(℃),FSR_0256下半LSB约0.19℃
+#define SWEEP_DT        5           //往返扫描每次采集温度变化(℃)
+#define DWELL_NUM       20          //阈值附近往复采集次数
+#define DWELL_DT        3           //阈值附近往复幅度(℃)
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static uint16_t sim_config;         //器件配置寄存器
+static uint8_t  sim_pointer;        //器件指针寄存器
+static double   sim_rtd_mv;         //PT100_0两端电压(mV)
+static double   sim_rtd1_mv;        //PT100_1两端电压(mV)
+static uint32_t sim_bus;            //I2C总线操作次数(发送与接收分别计数)
+static uint32_t sim_conv;           //转换结果读取次数
+static uint32_t sim_writes;         //配置寄存器写入次数(不含单次模式触发)
+static uint32_t sim_pga_change;     //相邻配置写入量程变化次数
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  模拟节拍
+ * @note   扫描采集不经总线忙等转换时间,每次查询推进0.1ms
+ */
+uint32_t HAL_GetTick(void)
+{
+    static uint32_t frac;
+    if(++frac == 10) {
+        frac = 0;
+        host_tick++;
+    }
+    return host_tick;
+}
+
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    sim_bus++;
+    sim_pointer = data[0] & 0x03;
+    if(size == 3 && sim_pointer == Reg_Config) {
+        ConfigReg_t last = {.value = sim_config};
+        ConfigReg_t reg = {.value = (data[1] << 8) | data[2]};
+        sim_writes++;
+        sim_pga_change += (reg.Bits.Pga != last.Bits.Pga) ? 1 : 0;
+        sim_config = reg.value;
+    }
+    return 0;
+}
+/**
+ * @brief  模拟转换结果
+ * @note   电源通道返回参考电压,温度通道返回PT100电压,按量程量化并限幅
+ */
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr; (void)size;
+    sim_bus++;
+    uint16_t raw = sim_config;
+    if(sim_pointer == Reg_Conversion) {
+        ConfigReg_t reg = {.value = sim_config};
+        sim_conv++;
+        double mv = (reg.Bits.Mux == PT100_POWER_0CH || reg.Bits.Mux == PT100_POWER_1CH) ? SIM_REF_MV
+                  : (reg.Bits.Mux == PT100_1CH) ? sim_rtd1_mv : sim_rtd_mv;
+        long code = lround(mv / pt100_lsb[reg.Bits.Pga]);
+        code = (code > 2047) ? 2047 : (code < -2048) ? -2048 : code;
+        raw = (uint16_t)(code << 4);
+    }
+    data[0] = raw >> 8;
+    data[1] = raw & 0xFF;
+    return 0;
+}
+
+void glbs_process(float *buf, uint8_t num, float *out)
+{
+    float sum = 0;
+    for(uint8_t i = 0; i < num; i++) {
+        sum += buf[i];
+    }
+    *out = (num != 0) ? sum / num : 0;
+}
+/**
+ * @brief  参考电阻
+ * @note   双精度Callendar-Van Dusen方程,0℃以上C项为0
+ */
+static double cvd_resistance(double t)
+{
+    double r = 1 + A * t + B * t * t;
+    if(t < 0) {
+        r += C * (t - 100) * t * t * t;
+    }
+    return PT100_R0 * r;
+}
+/**
+ * @brief  参考温度
+ * @note   双精度牛顿迭代求解,收敛到1e-9℃
+ */
+static double cvd_temperature(double r)
+{
+    double t = (r / PT100_R0 - 1) / A;
+    for(uint8_t i = 0; i < 50; i++) {
+        double dr = PT100_R0 * (A + 2 * B * t);
+        if(t < 0) {
+            dr += PT100_R0 * C * (4 * t * t * t - 300 * t * t);
+        }
+        double step = (cvd_resistance(t) - r) / dr;
+        t -= step;
+        if(fabs(step) < 1e-9) {
+            break;
+        }
+    }
+    return t;
+}
+
+static int test_accuracy(void)
+{
+    double max_err[2] = {0, 0};     //0℃以下查表,0℃以上闭式解
+    double max_at[2] = {0, 0};
+
+    for(double t = -200; t <= 850; t += SWEEP_STEP) {
+        float r = (float)cvd_resistance(t);
+        if(r < PT100_R_MIN || r > PT100_R_MAX) {
+            continue;
+        }
+        //以单精度电阻对应的参考温度比较,排除电阻量化误差
+        double err = fabs(pt100_calculation(r) - cvd_temperature(r));
+        uint8_t id = (r >= 100.0f) ? 1 : 0;
+        if(err > max_err[id]) {
+            max_err[id] = err;
+            max_at[id] = t;
+        }
+    }
+    printf("accuracy: lut max err %.5f C at %.2f C, closed form max err %.5f C at %.2f C\r\n",
+           max_err[0], max_at[0], max_err[1], max_at[1]);
+    TEST_ASSERT(max_err[0] < TEMP_TOL && max_err[1] < TEMP_TOL);
+
+    //量程边界与超量程
+    TEST_ASSERT(fabs(pt100_calculation(100.0f)) < TEMP_TOL);
+    TEST_ASSERT(fabs(pt100_calculation(PT100_R_MIN) + 200) < 0.01);
+    TEST_ASSERT(fabs(pt100_calculation(PT100_R_MAX) - 850) < 0.01);
+    TEST_ASSERT(pt100_calculation(PT100_R_MIN - 0.01f) == PT100_T_ERR);
+    TEST_ASSERT(pt100_calculation(PT100_R_MAX + 0.01f) == PT100_T_ERR);
+    TEST_ASSERT(pt100_calculation(0) == PT100_T_ERR);
+    return 0;
+}
+
+static int test_table(void)
+{
+    //编译期电阻表覆盖-200℃~0℃,与参考方程一致且单调递增
+    TEST_ASSERT(PT100_LUT_NUM == (0 - PT100_LUT_MIN) / PT100_LUT_STEP + 1);
+    for(uint8_t i = 0; i < PT100_LUT_NUM; i++) {
+        double ref = cvd_resistance(PT100_LUT_MIN + i * PT100_LUT_STEP);
+        TEST_ASSERT(fabs(pt100_lut[i] - ref) / ref < LUT_TOL);
+        if(i != 0) {
+            TEST_ASSERT(pt100_lut[i] > pt100_lut[i - 1]);
+        }
+    }
+    TEST_ASSERT(fabs(pt100_lut[PT100_LUT_NUM - 1] - PT100_R0) < 1e-4);
+    return 0;
+}
+
+static int test_bench(void)
+{
+    volatile float sink = 0;
+    volatile double dsink = 0;
+    float span = PT100_R_MAX - PT100_R_MIN;
+
+    clock_t start = clock();
+    for(uint32_t i = 0; i < BENCH_NUM; i++) {
+        sink += pt100_calculation(PT100_R_MIN + span * (float)(i % 1000) / 1000.0f);
+    }
+    double calc_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_NUM;
+
+    start = clock();
+    for(uint32_t i = 0; i < BENCH_NUM; i++) {
+        dsink += cvd_temperature(PT100_R_MIN + span * (float)(i % 1000) / 1000.0f);
+    }
+    double newton_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_NUM;
+    printf("bench: closed form/lut %.1f ns, newton %.1f ns\r\n", calc_ns, newton_ns);
+    (void)sink; (void)dsink;
+    return 0;
+}
+
+/**
+ * @brief  设置PT100温度
+ */
+static void sim_temp_set(double t)
+{
+    sim_rtd_mv = cvd_resistance(t) * SIM_REF_MV / 1800;
+}
+
+static int test_autorange(void)
+{
+    sensor_device_t dev = &pt100[PT100_0].parent;
+    pt100_cfg_t *config = &pt100_cfg[PT100_0];
+    ads1015_init(&pt100_adc, ntag_i2c_init(), PT100_ADC_ADDR);
+
+    //100℃约115mV,最小量程内直接采集
+    sim_temp_set(100);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(fabs(config->raw - 100) < SIM_TEMP_TOL);
+    TEST_ASSERT(config->FSR == PT100_FSR_FINE && config->resample == 0);
+
+    //600℃约260mV,超出FSR_0256削顶,增大一档重采
+    sim_temp_set(600);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(fabs(config->raw - 600) < SIM_TEMP_TOL * 2);
+    TEST_ASSERT(config->FSR == FSR_0512 && config->resample == 1);
+
+    //开路时最大量程仍削顶,按超量程输出且不参与量程预测
+    sim_rtd_mv = 3000;
+    TEST_ASSERT(pt100_collect(dev) == true);
+    printf("autorange: open circuit FSR %d resample %lu raw %.1f\r\n",
+           config->FSR, (unsigned long)config->resample, config->raw);
+    TEST_ASSERT(config->FSR == PT100_FSR_COARSE && config->resample == 2);
+    TEST_ASSERT(config->raw == PT100_T_ERR && config->last == 0 && config->trend == 0);
+
+    //恢复后在当前量程采集有效数据,之后按预测逐档减小量程
+    sim_temp_set(25);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(fabs(config->raw - 25) < SIM_TEMP_TOL * 4);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(config->FSR == PT100_FSR_FINE && fabs(config->raw - 25) < SIM_TEMP_TOL);
+    return 0;
+}
+
+/**
+ * @brief  温度分辨率
+ * @note   量程LSB对应的温度变化,按该温度下电阻斜率计算
+ * @retval ℃/LSB
+ */
+static double sweep_resolution(uint8_t fsr, double t)
+{
+    double dv_dt = (cvd_resistance(t + 0.01) - cvd_resistance(t - 0.01)) / 0.02 * SIM_REF_MV / 1800;
+    return pt100_lsb[fsr] / dv_dt;
+}
+
+static int test_sweep(void)
+{
+    sensor_device_t dev = &pt100[PT100_0].parent;
+    pt100_cfg_t *config = &pt100_cfg[PT100_0];
+    struct
+    {
+        uint32_t reads;     //读取次数
+        uint32_t conv;      //转换次数
+        double   t_min;     //覆盖温度
+        double   t_max;
+        double   res_max;   //最大℃/LSB
+    }range[PT100_FSR_FINE + 1] = {0};
+    uint32_t switches[2] = {0, 0};
+    uint32_t resample = config->resample;
+
+    ads1015_init(&pt100_adc, ntag_i2c_init(), PT100_ADC_ADDR);
+    for(uint8_t i = 0; i <= PT100_FSR_FINE; i++) {
+        range[i].t_min = 1e9;
+        range[i].t_max = -1e9;
+    }
+    sim_temp_set(-200);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    //-200℃->850℃->-200℃,每次采集变化SWEEP_DT
+    for(uint8_t dir = 0; dir < 2; dir++) {
+        for(int t = (dir == 0) ? -200 : 850; (dir == 0) ? (t <= 850) : (t >= -200); t += (dir == 0) ? SWEEP_DT : -SWEEP_DT) {
+            uint8_t fsr = config->FSR;
+            uint32_t conv = sim_conv;
+            sim_temp_set(t);
+            TEST_ASSERT(pt100_collect(dev) == true);
+            //升温只增大量程,降温只减小量程
+            if(config->FSR != fsr) {
+                TEST_ASSERT((dir == 0) ? (config->FSR < fsr) : (config->FSR > fsr));
+                switches[dir]++;
+            }
+            double res = sweep_resolution(config->FSR, t);
+            //量程端点处量化误差可能使电阻超出量程,按超量程输出
+            if(t == -200 || t == 850) {
+                TEST_ASSERT(fabs(config->raw - t) < res || config->raw == PT100_T_ERR);
+            } else {
+                TEST_ASSERT(fabs(config->raw - t) < res);
+            }
+            range[config->FSR].reads++;
+            range[config->FSR].conv += sim_conv - conv;
+            range[config->FSR].t_min = fmin(range[config->FSR].t_min, t);
+            range[config->FSR].t_max = fmax(range[config->FSR].t_max, t);
+            range[config->FSR].res_max = fmax(range[config->FSR].res_max, res);
+        }
+    }
+    resample = config->resample - resample;
+    printf("sweep -200 -> 850 -> -200 C, %d C per read: %lu up-switch, %lu down-switch, %lu resample\r\n",
+           SWEEP_DT, (unsigned long)switches[0], (unsigned long)switches[1], (unsigned long)resample);
+    for(uint8_t i = PT100_FSR_COARSE; i <= PT100_FSR_FINE; i++) {
+        if(range[i].reads == 0) {
+            printf("  FSR %d: unused\r\n", i);
+            continue;
+        }
+        printf("  FSR %d: %.0f ~ %.0f C, %lu reads, %.1f conversions per read, max %.3f C/LSB\r\n", i,
+               range[i].t_min, range[i].t_max, (unsigned long)range[i].reads,
+               (double)range[i].conv / range[i].reads, range[i].res_max);
+    }
+    //850℃约325mV,FSR_0512足够;每个方向只切换一次,预测提前增大量程,不削顶重采
+    TEST_ASSERT(switches[0] == 1 && switches[1] == 1 && resample == 0);
+    TEST_ASSERT(range[PT100_FSR_COARSE].reads == 0);
+
+    //切换阈值附近±DWELL_DT往复,从两侧进入,最多切换一次且之后保持
+    double t_up = cvd_temperature(PT100_RANGE_UP * PT100_CODE_FS * pt100_lsb[PT100_FSR_FINE] * 1800 / SIM_REF_MV);
+    double t_down = cvd_temperature(PT100_RANGE_DOWN * PT100_CODE_FS * pt100_lsb[PT100_FSR_FINE] * 1800 / SIM_REF_MV);
+    uint32_t change_max = 0;
+    for(uint8_t k = 0; k < 4; k++) {
+        double center = (k < 2) ? t_up : t_down;
+        //从量程一端按SWEEP_DT逐步接近阈值
+        for(double t = (k & 1) ? 850 : -200; (k & 1) ? (t > center) : (t < center); t += (k & 1) ? -SWEEP_DT : SWEEP_DT) {
+            sim_temp_set(t);
+            TEST_ASSERT(pt100_collect(dev) == true);
+        }
+        sim_temp_set(center);
+        TEST_ASSERT(pt100_collect(dev) == true);
+        uint8_t fsr = config->FSR;
+        uint32_t change = 0;
+        for(uint8_t i = 0; i < DWELL_NUM; i++) {
+            sim_temp_set(center + ((i & 1) ? DWELL_DT : -DWELL_DT));
+            TEST_ASSERT(pt100_collect(dev) == true);
+            if(config->FSR != fsr) {
+                fsr = config->FSR;
+                change++;
+            }
+        }
+        change_max = (change > change_max) ? change : change_max;
+    }
+    printf("  switch up at %.0f C, down at %.0f C, dwell +-%d C x%d: max %lu switch\r\n",
+           t_up, t_down, DWELL_DT, DWELL_NUM, (unsigned long)change_max);
+    TEST_ASSERT(change_max <= 1);
+    //恢复量程与预测状态
+    config->last = 0;
+    config->trend = 0;
+    config->FSR = PT100_FSR_FINE;
+    return 0;
+}
+/**
+ * @brief  单次采集的I2C传输次数
+ * @note   连续模式、固定延时等待;每项扫描为配置写入(与影子一致时跳过)、丢弃首个结果、
+ *         COLLECT_NUM*过采样次数次读取;指针已指向转换寄存器时读取为一次接收,
+ *         否则默认实现为指针写与接收两次总线操作
+ */
+static int test_xfer(void)
+{
+    sensor_device_t dev = &pt100[PT100_0].parent;
+    pt100_cfg_t *config = &pt100_cfg[PT100_0];
+
+    //重新上电:影子与指针失效,参考电压缓存失效
+    ads1015_init(&pt100_adc, ntag_i2c_init(), PT100_ADC_ADDR);
+    memset(pt100_ref, 0, sizeof(pt100_ref));
+    sim_temp_set(25);
+    TEST_ASSERT(pt100_collect(dev) == true && config->FSR == PT100_FSR_FINE);
+    uint32_t reads = COLLECT_NUM * config->oversample;
+
+    //冷启动:参考通道与温度通道各写一次配置并丢弃首个结果
+    memset(pt100_ref, 0, sizeof(pt100_ref));
+    uint32_t xfer = ads1015_xfer_count(&pt100_adc);
+    uint32_t bus = sim_bus;
+    TEST_ASSERT(pt100_collect(dev) == true);
+    uint32_t cold = ads1015_xfer_count(&pt100_adc) - xfer;
+    uint32_t cold_bus = sim_bus - bus;
+    TEST_ASSERT(cold == (2 + COLLECT_NUM) + (2 + reads));
+    //两次配置写入后首个读取需先写指针
+    TEST_ASSERT(cold_bus == cold + 2);
+
+    //参考电压已缓存:配置与上次温度通道一致,写入跳过,只读转换寄存器
+    xfer = ads1015_xfer_count(&pt100_adc);
+    bus = sim_bus;
+    TEST_ASSERT(pt100_collect(dev) == true);
+    uint32_t cached = ads1015_xfer_count(&pt100_adc) - xfer;
+    uint32_t cached_bus = sim_bus - bus;
+    TEST_ASSERT(cached == 1 + reads && cached_bus == cached);
+    TEST_ASSERT(fabs(config->raw - 25) < SIM_TEMP_TOL);
+
+    //缓存超过PT100_REF_REVALID后重新测量参考电压
+    host_tick += PT100_REF_REVALID;
+    xfer = ads1015_xfer_count(&pt100_adc);
+    TEST_ASSERT(pt100_collect(dev) == true);
+    TEST_ASSERT(ads1015_xfer_count(&pt100_adc) - xfer == cold);
+
+    printf("xfer: oversample %d, cold %lu (bus %lu), cached ref %lu (bus %lu)\r\n", config->oversample,
+           (unsigned long)cold, (unsigned long)cold_bus, (unsigned long)cached, (unsigned long)cached_bus);
+    return 0;
+}
+
+/**
+ * @brief  模块采集
+ * @note   两路共用电源同时打开时,模块读取后第二路的采集被跳过,两路参考与温度通道在一次扫描中完成
+ */
+static int test_module(void)
+{
+    sensor_device_t dev0 = &pt100[PT100_0].parent;
+    sensor_device_t dev1 = &pt100[PT100_1].parent;
+
+    sim_temp_set(25);
+    sim_rtd1_mv = cvd_resistance(80) * SIM_REF_MV / 1800;
+    TEST_ASSERT(sensor_close(dev0) && sensor_close(dev1));
+    TEST_ASSERT(sensor_open(dev0) && sensor_open(dev1));
+
+    //冷启动:两路参考(FSR_2048)在前,两路温度(FSR_0256)在后,量程只切换一次
+    uint32_t lock = host_lock_count;
+    uint32_t writes = sim_writes;
+    uint32_t pga = sim_pga_change;
+    uint32_t xfer = ads1015_xfer_count(&pt100_adc);
+    TEST_ASSERT(sensor_collect(dev0) == true);
+    uint32_t cold_xfer = ads1015_xfer_count(&pt100_adc) - xfer;
+    TEST_ASSERT(host_lock_count - lock == 1 && sim_writes - writes == 4 && sim_pga_change - pga == 1);
+    //第二路不再访问总线
+    xfer = ads1015_xfer_count(&pt100_adc);
+    TEST_ASSERT(sensor_collect(dev1) == true && ads1015_xfer_count(&pt100_adc) == xfer);
+    TEST_ASSERT(fabs(pt100_cfg[PT100_0].raw - 25) < SIM_TEMP_TOL);
+    TEST_ASSERT(fabs(pt100_cfg[PT100_1].raw - 80) < SIM_TEMP_TOL);
+    TEST_ASSERT(pt100_cfg[PT100_1].timestamp == pt100_cfg[PT100_0].timestamp);
+
+    //下一周期参考电压已缓存,只采两路温度
+    sim_rtd1_mv = cvd_resistance(81) * SIM_REF_MV / 1800;
+    TEST_ASSERT(sensor_open(dev0) == true);
+    lock = host_lock_count;
+    writes = sim_writes;
+    xfer = ads1015_xfer_count(&pt100_adc);
+    TEST_ASSERT(sensor_collect(dev0) == true && sensor_collect(dev1) == true);
+    uint32_t cached_xfer = ads1015_xfer_count(&pt100_adc) - xfer;
+    TEST_ASSERT(host_lock_count - lock == 1 && sim_writes - writes == 2);
+    TEST_ASSERT(fabs(pt100_cfg[PT100_1].raw - 81) < SIM_TEMP_TOL);
+    printf("module: 2 channels in one scan, cold %lu xfer, cached ref %lu xfer, 1 lock\r\n",
+           (unsigned long)cold_xfer, (unsigned long)cached_xfer);
+
+    //只打开一路时只采本路:电源重新上电,本路参考与温度两项
+    TEST_ASSERT(sensor_close(dev1) == true);
+    TEST_ASSERT(sensor_open(dev0) == true);
+    writes = sim_writes;
+    uint32_t ts = pt100_cfg[PT100_1].timestamp;
+    TEST_ASSERT(sensor_collect(dev0) == true && sim_writes - writes == 2);
+    TEST_ASSERT(pt100_cfg[PT100_1].timestamp == ts);
+    TEST_ASSERT(sensor_close(dev0) == true);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    fail |= test_accuracy();
+    fail |= test_table();
+    fail |= test_bench();
+    fail |= test_autorange();
+    fail |= test_sweep();
+    fail |= test_xfer();
+    fail |= test_module();
+    printf("test_pt100 %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_pt100_settle.c
+ * @brief PT100上电稳定检测仿真
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 直接包含sensor_pt100.c调用power_control;模拟ADS1015在电源通道返回RC充电电压,
+ * 时间常数按对数正态分布随机,叠加0.5LSB高斯噪声。验证冷启动与学习后均无超时、
+ * 判定稳定时剩余误差小于1LSB、学习后延后检测减少I2C传输且等待不变长,以及不收敛与总线异常时的处理:
+ * gcc -ISensor/test/stub -ISensor/core -ISensor/driver/ads1015 -ISensor/driver/pt100 Sensor/test/test_pt100_settle.c
+ *     Sensor/test/stub/host_stub.c Sensor/core/sensor_driver.c Sensor/core/sensor_time.c Sensor/core/sensor_log.c
+ *     Sensor/core/sensor_alarm.c Sensor/core/sensor_bus.c Sensor/driver/ads1015/ads1015.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "../driver/pt100/sensor_pt100.c"
+/* Private define ------------------------------------------------------------*/
+#define POWER_NUM       2000        //每组上电次数
+#define SIM_FINAL       1500.0      //参考电压终值(mV),FSR_2048下1LSB为1mV
+#define SIM_NOISE       0.5         //转换噪声(LSB RMS)
+#define SIM_SIGMA       0.6         //时间常数对数正态分布标准差
+#define RESIDUAL_TOL    1.0         //判定稳定时剩余误差上限(mV)
+#define SIM_PI          3.14159265358979
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static uint16_t sim_config;         //器件配置寄存器
+static uint8_t  sim_pointer;        //器件指针寄存器
+static uint32_t sim_on;             //上电时刻(ms)
+static double   sim_tau;            //本次上电时间常数(ms)
+static bool     sim_fault;          //总线异常
+static uint32_t sim_seed = 1;
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  随机数
+ * @note   线性同余,保证结果可复现
+ */
+static double sim_rand(void)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return ((sim_seed >> 8) + 1.0) / (double)(1 << 24);
+}
+
+static double sim_gauss(void)
+{
+    double u = sim_rand();
+    double w = sim_rand();
+    return sqrt(-2 * log(u)) * cos(2 * SIM_PI * w);
+}
+/**
+ * @brief  电源通道电压
+ * @param  ms: 上电后时间
+ */
+static double sim_voltage(uint32_t ms)
+{
+    return SIM_FINAL * (1 - exp(-(double)ms / sim_tau));
+}
+
+uint8_t I2cTransmit(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr;
+    if(sim_fault == true) {
+        return 1;
+    }
+    sim_pointer = data[0] & 0x03;
+    if(size == 3 && sim_pointer == Reg_Config) {
+        sim_config = (data[1] << 8) | data[2];
+    }
+    return 0;
+}
+
+uint8_t I2cReceive(I2c_t *obj, uint8_t addr, uint8_t *data, uint16_t size)
+{
+    (void)obj; (void)addr; (void)size;
+    uint16_t raw = sim_config;
+    if(sim_fault == true) {
+        return 1;
+    }
+    if(sim_pointer == Reg_Conversion) {
+        ConfigReg_t reg = {.value = sim_config};
+        int16_t code = 0;
+        if(reg.Bits.Mux == PT100_POWER_0CH) {
+            code = (int16_t)lround(sim_voltage(host_tick - sim_on) + SIM_NOISE * sim_gauss());
+        }
+        raw = (uint16_t)(code << 4);
+    }
+    data[0] = raw >> 8;
+    data[1] = raw & 0xFF;
+    return 0;
+}
+
+void glbs_process(float *buf, uint8_t num, float *out)
+{
+    float sum = 0;
+    for(uint8_t i = 0; i < num; i++) {
+        sum += buf[i];
+    }
+    *out = (num != 0) ? sum / num : 0;
+}
+/**
+ * @brief  仿真一次上电
+ * @param  tau: 时间常数(ms)
+ * @param  *residual: 判定稳定时剩余误差(mV)
+ * @retval 等待时间(ms)
+ */
+static uint32_t power_cycle(double tau, double *residual)
+{
+    pt100_cfg_t *config = &pt100_cfg[PT100_0];
+    sim_tau = tau;
+    sim_on = host_tick;
+    power_control(config, ON);
+    uint32_t elapsed = host_tick - sim_on;
+    *residual = SIM_FINAL - sim_voltage(elapsed);
+    power_control(config, OFF);
+    //断电后充分放电
+    host_tick += 1000;
+    return elapsed;
+}
+/**
+ * @brief  仿真统计
+ */
+typedef struct
+{
+    double   mean;          //平均等待时间(ms)
+    uint32_t max;           //最长等待时间(ms)
+    double   residual;      //最大剩余误差(mV)
+    double   xfer;          //平均I2C传输次数
+    uint32_t timeout;       //超时次数
+}sim_result_t;
+
+static void simulate(double median, bool learn, sim_result_t *res)
+{
+    memset(res, 0, sizeof(sim_result_t));
+    memset(&pt100_settle, 0, sizeof(pt100_settle));
+    uint32_t xfer = ads1015_xfer_count(&pt100_adc);
+    for(uint16_t i = 0; i < POWER_NUM; i++) {
+        double tau = median * exp(SIM_SIGMA * sim_gauss());
+        double residual = 0;
+        if(tau > 3 * median) {
+            tau = 3 * median;
+        }
+        if(learn == false) {
+            pt100_settle.typical = 0;
+        }
+        uint32_t elapsed = power_cycle(tau, &residual);
+        res->mean += elapsed;
+        if(elapsed > res->max) {
+            res->max = elapsed;
+        }
+        if(fabs(residual) > res->residual) {
+            res->residual = fabs(residual);
+        }
+    }
+    res->mean /= POWER_NUM;
+    res->xfer = (double)(ads1015_xfer_count(&pt100_adc) - xfer) / POWER_NUM;
+    res->timeout = pt100_settle.timeout;
+}
+
+static int test_settle(void)
+{
+    static const double median[] = {5, 10};
+    for(uint8_t i = 0; i < sizeof(median) / sizeof(median[0]); i++) {
+        sim_result_t cold, learned;
+        simulate(median[i], false, &cold);
+        simulate(median[i], true, &learned);
+        printf("tau %2.0fms: cold mean %.1fms max %lums residual %.2fmV xfer %.1f | "
+               "learned mean %.1fms max %lums residual %.2fmV xfer %.1f typical %.1fms\r\n",
+               median[i], cold.mean, (unsigned long)cold.max, cold.residual, cold.xfer,
+               learned.mean, (unsigned long)learned.max, learned.residual, learned.xfer, pt100_settle.typical);
+        TEST_ASSERT(cold.timeout == 0 && learned.timeout == 0);
+        TEST_ASSERT(cold.max < POWER_DELAY && learned.max < POWER_DELAY);
+        TEST_ASSERT(cold.residual < RESIDUAL_TOL && learned.residual < RESIDUAL_TOL);
+        //延后检测用于减少I2C占用,等待时间由稳定判定决定,允许1个检测步的差异
+        TEST_ASSERT(learned.xfer < cold.xfer);
+        TEST_ASSERT(learned.mean <= cold.mean + 8);
+    }
+    return 0;
+}
+
+static int test_timeout(void)
+{
+    //时间常数远大于POWER_DELAY,等待至上限并计入超时,不更新典型稳定时间
+    double residual = 0;
+    memset(&pt100_settle, 0, sizeof(pt100_settle));
+    uint32_t elapsed = power_cycle(5000, &residual);
+    printf("no settle: %lums timeout %lu\r\n", (unsigned long)elapsed, (unsigned long)pt100_settle.timeout);
+    TEST_ASSERT(pt100_settle.timeout == 1 && pt100_settle.typical == 0);
+    TEST_ASSERT(elapsed >= POWER_DELAY && elapsed < POWER_DELAY + 20);
+    return 0;
+}
+
+static int test_bus_fault(void)
+{
+    //总线异常时立即返回,不轮询至POWER_DELAY
+    double residual = 0;
+    memset(&pt100_settle, 0, sizeof(pt100_settle));
+    sim_fault = true;
+    uint32_t elapsed = power_cycle(5, &residual);
+    sim_fault = false;
+    printf("bus fault: %lums\r\n", (unsigned long)elapsed);
+    TEST_ASSERT(elapsed < 10 && pt100_settle.timeout == 0);
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    ads1015_init(&pt100_adc, ntag_i2c_init(), PT100_ADC_ADDR);
+    pt100_cfg[PT100_0].i2c.obj = ntag_i2c_init();
+    fail |= test_settle();
+    fail |= test_timeout();
+    fail |= test_bus_fault();
+    printf("test_pt100_settle %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file test_sched.c
+ * @brief 能耗预算调度仿真测试
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * 三个构建器按现场记录的单次工作时长循环执行(含重采尖峰),仿真7天,第4天预算降为1/4;
+ * 验证每日能耗跟踪预算、周期按优先级排列,以及预算不足时回退到最低采样率:
+ * gcc -ISensor/test/stub -ISensor/core Sensor/test/test_sched.c Sensor/test/stub/host_stub.c
+ *     Sensor/core/sensor_sched.c Sensor/core/sensor_builder.c Sensor/core/sensor_driver.c
+ *     Sensor/core/sensor_time.c Sensor/core/sensor_log.c Sensor/core/sensor_alarm.c Sensor/core/sensor_bus.c -lm
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include "sensor_sched.h"
+#include "stm32wlxx_hal.h"
+/* Private define ------------------------------------------------------------*/
+#define SIM_DAY_MS      (24UL * 3600 * 1000)
+#define SIM_DAYS        7
+#define SIM_CUT_DAY     4               //预算降低的日期
+#define DAILY_BUDGET    20000.0f        //每日能耗预算(mJ)
+#define PLAN_INTERVAL   (10 * 60 * 1000)
+#define PERIOD_MIN      (10 * 1000)
+#define PERIOD_MAX      (10 * 60 * 1000)
+#define BUDGET_TOL      0.02f           //每日能耗与预算相对偏差上限
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+#define ARRAY_NUM(x)    (sizeof(x) / sizeof((x)[0]))
+/* Private variables ---------------------------------------------------------*/
+//单次工作时长记录(ms),循环使用
+static const uint16_t trace_sht[] = {15, 15, 16, 15, 45, 15, 15, 15, 16, 15, 90, 15};
+static const uint16_t trace_ds[]  = {760, 755, 762, 1500, 758, 760};
+static const uint16_t trace_pt[]  = {120, 118, 121, 240, 119, 120, 122};
+static const uint16_t *trace[3] = {trace_sht, trace_ds, trace_pt};
+static const uint8_t trace_num[3] = {ARRAY_NUM(trace_sht), ARRAY_NUM(trace_ds), ARRAY_NUM(trace_pt)};
+static uint8_t trace_pos[3];
+/* Private user code ---------------------------------------------------------*/
+static bool sim_ok(sensor_device_t dev)
+{
+    (void)dev;
+    return true;
+}
+
+static const sensor_ops_t sim_ops =
+{
+    .init   = sim_ok,
+    .open   = sim_ok,
+    .close  = sim_ok,
+};
+/**
+ * @brief  工作阶段
+ * @note   上电区间按记录时长推进时间
+ */
+static void stage_work(sensor_device_t dev, void *cfg, uint8_t num)
+{
+    uint8_t id = (uint8_t)(dev->name[0] - '0');
+    (void)cfg; (void)num;
+    sensor_open(dev);
+    host_tick += trace[id][trace_pos[id]];
+    trace_pos[id] = (trace_pos[id] + 1) % trace_num[id];
+    sensor_close(dev);
+}
+
+static sensor_process_ops_t sim_process[] =
+{
+    {.handler = stage_work},
+};
+
+static bool sim_add(sensor_builder_t *builder, sensor_device_t sensor)
+{
+    builder->sensor = sensor;
+    sensor->arg = builder;
+    return true;
+}
+static sensor_builder_ops_t sim_builder_ops = {.sensor_add = sim_add};
+
+static struct sensor_device dev[3] =
+{
+    {.name = "0", .ops = &sim_ops, .energy = {.current = 800}},
+    {.name = "1", .ops = &sim_ops, .energy = {.current = 1000}},
+    {.name = "2", .ops = &sim_ops, .energy = {.current = 1850}},
+};
+static sensor_builder_t builder[3];
+static sensor_sched_item_t item[3] =
+{
+    {.builder = &builder[0], .priority = 4, .min_period = PERIOD_MIN, .max_period = PERIOD_MAX},
+    {.builder = &builder[1], .priority = 1, .min_period = PERIOD_MIN, .max_period = PERIOD_MAX},
+    {.builder = &builder[2], .priority = 2, .min_period = PERIOD_MIN, .max_period = PERIOD_MAX},
+};
+/**
+ * @brief  运行到指定时间
+ * @param  *sched: 调度器
+ * @param  end: 结束时间(ms)
+ * @retval 期间能耗(mJ)
+ */
+static float run_until(sensor_sched_t *sched, uint32_t end)
+{
+    uint64_t start = sensor_energy_total();
+    while((int32_t)(host_tick - end) < 0) {
+        sensor_sched_process(sched);
+        sensor_director_process();
+        sensor_director_sleep();
+    }
+    return (float)(sensor_energy_total() - start) / 1000000.0f;
+}
+
+static int test_budget(void)
+{
+    sensor_sched_t sched;
+
+    TEST_ASSERT(sensor_sched_init(&sched, DAILY_BUDGET, PLAN_INTERVAL, item, ARRAY_NUM(item)));
+    for(uint8_t day = 1; day <= SIM_DAYS; day++) {
+        if(day == SIM_CUT_DAY) {
+            sched.daily = DAILY_BUDGET / 4;
+        }
+        float used = run_until(&sched, day * SIM_DAY_MS);
+        printf("day %d budget %.0f used %.0f mJ periods %lu %lu %lu s cost %.2f %.2f %.2f mJ\r\n",
+               day, sched.daily, used, (unsigned long)builder[0].period / 1000,
+               (unsigned long)builder[1].period / 1000, (unsigned long)builder[2].period / 1000,
+               item[0].cost, item[1].cost, item[2].cost);
+        //第1天含能耗估计收敛,预算降低当天含结余修正,只检查稳定后的日期
+        if(day != 1 && day != SIM_CUT_DAY) {
+            TEST_ASSERT(fabsf(used - sched.daily) < sched.daily * BUDGET_TOL);
+        }
+        TEST_ASSERT(sched.shortfall == false);
+    }
+    //优先级越高周期越短
+    TEST_ASSERT(builder[0].period < builder[2].period && builder[2].period < builder[1].period);
+    for(uint8_t i = 0; i < ARRAY_NUM(item); i++) {
+        TEST_ASSERT(builder[i].period >= PERIOD_MIN && builder[i].period <= PERIOD_MAX);
+    }
+
+    //预算不足以维持最低采样率时全部回退到最大周期
+    sched.daily = 10.0f;
+    sched.balance = 0;
+    run_until(&sched, host_tick + 2 * PLAN_INTERVAL);
+    TEST_ASSERT(sched.shortfall == true);
+    for(uint8_t i = 0; i < ARRAY_NUM(item); i++) {
+        TEST_ASSERT(builder[i].period == PERIOD_MAX);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    for(uint8_t i = 0; i < ARRAY_NUM(builder); i++) {
+        builder[i].process = sim_process;
+        builder[i].process_num = ARRAY_NUM(sim_process);
+        builder[i].ops = &sim_builder_ops;
+        builder_sensor_add(&builder[i], &dev[i]);
+        sensor_builder_add(&builder[i]);
+    }
+    sensor_director_init();
+    fail |= test_budget();
+    printf("test_sched %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file test_store.c
+ * @brief Flash日志存储测试与基准
+ * @author huangly
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note :
+ * Flash以临时文件模拟:擦除置0xFF,写入按8字节单元与原内容相与,同一单元擦除后重复写入计为违例;
+ * 掉电在指定写入单元处截断,之后读写均失败,重新初始化模拟上电。
+ * 验证追加与范围查询、扇区循环覆盖、记录与扇区头半写后的恢复,
+ * 并输出不同记录长度下的写放大与擦除次数、上电恢复与范围查询的Flash读取次数及耗时:
+ * gcc -ISensor/core Sensor/test/test_store.c Sensor/core/sensor_store.c
+ * @par 修改日志:
+ * Date       Version Author      Description
+ * 2026-10-19 1.0     huangly     first version
+ */
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sensor_store.h"
+/* Private define ------------------------------------------------------------*/
+#define SIM_SECTOR_SIZE     2048        //STM32WL页大小
+#define SIM_SECTOR_NUM      8
+#define SIM_ALIGN           8
+#define SIM_DATA_SIZE       20          //记录数据长度,记录槽32字节,每扇区63条
+#define SIM_CUT_NONE        0xFFFFFFFF
+#define LOSS_TRIALS         1000        //随机掉电次数
+#define BENCH_NUM           5000        //写放大统计记录数量
+#define BENCH_QUERY         1000        //查询耗时统计次数
+/* Private macro -------------------------------------------------------------*/
+#define TEST_ASSERT(x)                                                      \
+    do {                                                                    \
+        if(!(x)) {                                                          \
+            printf("%s:%d: %s\r\n", __FILE__, __LINE__, #x);                \
+            return 1;                                                       \
+        }                                                                   \
+    } while(0)
+/* Private variables ---------------------------------------------------------*/
+static FILE     *sim_file;
+static uint32_t sim_cut = SIM_CUT_NONE; //剩余可写入单元数量,耗尽时掉电
+static bool     sim_lost;               //已掉电
+static uint32_t sim_violation;          //未擦除单元重复写入次数
+static uint32_t sim_reads;              //读取次数
+static uint32_t sim_seed = 1;
+static sensor_store_t store;
+/* Private user code ---------------------------------------------------------*/
+/**
+ * @brief  随机数
+ * @note   线性同余,保证结果可复现
+ */
+static uint32_t sim_rand(void)
+{
+    sim_seed = sim_seed * 1103515245 + 12345;
+    return sim_seed >> 8;
+}
+
+static bool sim_read(uint32_t addr, void *data, uint32_t len)
+{
+    if(sim_lost == true) {
+        return false;
+    }
+    sim_reads++;
+    fseek(sim_file, (long)addr, SEEK_SET);
+    return fread(data, 1, len, sim_file) == len;
+}
+
+static bool sim_write(uint32_t addr, const void *data, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    for(uint32_t i = 0; i < len; i += SIM_ALIGN) {
+        uint8_t unit[SIM_ALIGN];
+        if(sim_lost == true || sim_cut == 0) {
+            sim_lost = true;
+            return false;
+        }
+        if(sim_cut != SIM_CUT_NONE) {
+            sim_cut--;
+        }
+        fseek(sim_file, (long)(addr + i), SEEK_SET);
+        fread(unit, 1, SIM_ALIGN, sim_file);
+        for(uint8_t k = 0; k < SIM_ALIGN; k++) {
+            if(unit[k] != 0xFF) {
+                sim_violation++;
+                break;
+            }
+        }
+        for(uint8_t k = 0; k < SIM_ALIGN; k++) {
+            unit[k] &= src[i + k];
+        }
+        fseek(sim_file, (long)(addr + i), SEEK_SET);
+        fwrite(unit, 1, SIM_ALIGN, sim_file);
+    }
+    return true;
+}
+
+static bool sim_erase(uint32_t addr)
+{
+    static uint8_t blank[SIM_SECTOR_SIZE];
+    if(sim_lost == true) {
+        return false;
+    }
+    memset(blank, 0xFF, sizeof(blank));
+    fseek(sim_file, (long)(addr - addr % SIM_SECTOR_SIZE), SEEK_SET);
+    fwrite(blank, 1, sizeof(blank), sim_file);
+    return true;
+}
+
+static const sensor_flash_ops_t sim_flash =
+{
+    .read        = sim_read,
+    .write       = sim_write,
+    .erase       = sim_erase,
+    .base        = 0,
+    .sector_size = SIM_SECTOR_SIZE,
+    .sector_num  = SIM_SECTOR_NUM,
+    .write_align = SIM_ALIGN,
+};
+/**
+ * @brief  上电
+ * @note   清除掉电状态后重新初始化
+ */
+static bool sim_boot(uint16_t data_size)
+{
+    sim_lost = false;
+    sim_cut = SIM_CUT_NONE;
+    return sensor_store_init(&store, &sim_flash, data_size);
+}
+/**
+ * @brief  Flash恢复为全擦除状态
+ */
+static void sim_blank(void)
+{
+    sim_lost = false;
+    for(uint16_t i = 0; i < SIM_SECTOR_NUM; i++) {
+        sim_erase((uint32_t)i * SIM_SECTOR_SIZE);
+    }
+}
+/**
+ * @brief  记录数据由时间戳生成,查询时据此校验内容
+ */
+static void record_fill(uint32_t ts, uint8_t *data, uint16_t len)
+{
+    for(uint16_t i = 0; i < len; i++) {
+        data[i] = (uint8_t)(ts * 7 + i);
+    }
+}
+
+static bool append(uint32_t ts)
+{
+    uint8_t data[SIM_DATA_SIZE];
+    record_fill(ts, data, sizeof(data));
+    return sensor_store_append(&store, ts, data, sizeof(data));
+}
+/**
+ * @brief  查询结果
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t first;
+    uint32_t last;
+    uint32_t step;      //相邻记录时间戳间隔,不连续时为0
+    uint32_t bad;       //内容错误数量
+}visit_result_t;
+
+static bool visit_record(uint32_t ts, const uint8_t *data, uint16_t len, void *arg)
+{
+    visit_result_t *res = (visit_result_t *)arg;
+    uint8_t expect[SENSOR_STORE_RECORD_MAX];
+    record_fill(ts, expect, len);
+    if(len != SIM_DATA_SIZE || memcmp(data, expect, len) != 0) {
+        res->bad++;
+    }
+    if(res->count == 0) {
+        res->first = ts;
+    } else if(res->count == 1) {
+        res->step = ts - res->last;
+    } else if(ts - res->last != res->step) {
+        res->step = 0;
+    }
+    res->last = ts;
+    res->count++;
+    return true;
+}
+
+static uint32_t query(uint32_t t_start, uint32_t t_end, visit_result_t *res)
+{
+    memset(res, 0, sizeof(visit_result_t));
+    return sensor_store_query(&store, t_start, t_end, visit_record, res);
+}
+
+static int test_append(void)
+{
+    visit_result_t res;
+    sim_blank();
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    TEST_ASSERT(store.record_size == 32 && store.slot_num == 63);
+    for(uint32_t i = 1; i <= 100; i++) {
+        TEST_ASSERT(append(i * 10));
+    }
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == 100);
+    TEST_ASSERT(res.first == 10 && res.last == 1000 && res.step == 10 && res.bad == 0);
+    //范围边界不在记录上
+    TEST_ASSERT(query(205, 505, &res) == 30);
+    TEST_ASSERT(res.first == 210 && res.last == 500 && res.bad == 0);
+    TEST_ASSERT(query(1001, 2000, &res) == 0);
+    //超长记录与时间范围反向
+    uint8_t big[SENSOR_STORE_RECORD_MAX] = {0};
+    TEST_ASSERT(sensor_store_append(&store, 1010, big, SIM_DATA_SIZE + SIM_ALIGN) == false);
+    TEST_ASSERT(query(500, 100, &res) == 0);
+
+    //重新上电,恢复写入位置后继续追加
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    TEST_ASSERT(sensor_store_last(&store) == 1000);
+    TEST_ASSERT(store.stats.erase_count == 0);
+    TEST_ASSERT(append(1010));
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == 101);
+    TEST_ASSERT(res.last == 1010 && res.step == 10 && res.bad == 0);
+    TEST_ASSERT(sim_violation == 0);
+    return 0;
+}
+
+static int test_wrap(void)
+{
+    visit_result_t res;
+    uint32_t total = SIM_SECTOR_NUM * 63 * 3 + 17;
+    sim_blank();
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    for(uint32_t i = 1; i <= total; i++) {
+        TEST_ASSERT(append(i));
+    }
+    //最旧扇区被擦除,保留当前扇区与之前7个完整扇区
+    uint32_t keep = (SIM_SECTOR_NUM - 1) * 63 + 17;
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == keep);
+    TEST_ASSERT(res.first == total - keep + 1 && res.last == total && res.step == 1 && res.bad == 0);
+    //跨扇区范围
+    TEST_ASSERT(query(total - 300, total - 100, &res) == 201);
+    TEST_ASSERT(res.first == total - 300 && res.last == total - 100 && res.step == 1);
+    //已覆盖的时间范围
+    TEST_ASSERT(query(1, total - keep, &res) == 0);
+
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == keep && res.last == total);
+    TEST_ASSERT(sim_violation == 0);
+    return 0;
+}
+
+static int test_torn_head(void)
+{
+    //写满一个扇区,下一条记录时封存(1个单元)与扇区头单元0写入后掉电
+    visit_result_t res;
+    sim_blank();
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    for(uint32_t i = 1; i <= 63; i++) {
+        TEST_ASSERT(append(i));
+    }
+    sim_cut = 2;
+    TEST_ASSERT(append(64) == false);
+    TEST_ASSERT(sim_lost == true);
+
+    //半写扇区头不可导致格式化,已有记录保留
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    TEST_ASSERT(store.stats.erase_count == 0);
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == 63 && res.last == 63);
+    TEST_ASSERT(append(64));
+    TEST_ASSERT(query(0, 0xFFFFFFFF, &res) == 64 && res.last == 64 && res.step == 1);
+    TEST_ASSERT(sim_violation == 0);
+    return 0;
+}
+
+static int test_power_loss(void)
+{
+    //随机位置掉电:已确认的记录在保留范围内不丢失,半写记录被丢弃,上电后可继续追加
+    uint32_t dropped = 0;
+    for(uint16_t trial = 0; trial < LOSS_TRIALS; trial++) {
+        visit_result_t res;
+        uint32_t acked = 0;
+        sim_blank();
+        TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+        uint32_t num = sim_rand() % (SIM_SECTOR_NUM * 63 * 2);
+        for(uint32_t i = 1; i <= num; i++) {
+            TEST_ASSERT(append(i));
+            acked = i;
+        }
+        sim_cut = sim_rand() % 8;
+        for(uint32_t i = acked + 1; sim_lost == false; i++) {
+            if(append(i) == true) {
+                acked = i;
+            }
+        }
+
+        TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+        TEST_ASSERT(store.stats.erase_count == 0);
+        uint32_t keep = (acked < (SIM_SECTOR_NUM - 1) * 63) ? acked : (SIM_SECTOR_NUM - 1) * 63;
+        uint32_t got = query(0, 0xFFFFFFFF, &res);
+        TEST_ASSERT(res.bad == 0);
+        TEST_ASSERT(got >= keep && (got == 0 || (res.last == acked && res.step <= 1)));
+        dropped += store.stats.drop_count;
+
+        //上电后追加,时间戳接续
+        TEST_ASSERT(append(acked + 2));
+        TEST_ASSERT(query(acked + 1, 0xFFFFFFFF, &res) == 1 && res.first == acked + 2);
+    }
+    printf("power loss: %u trials, %lu torn records dropped, %lu unit rewrites\r\n",
+           LOSS_TRIALS, (unsigned long)dropped, (unsigned long)sim_violation);
+    TEST_ASSERT(sim_violation == 0);
+    return 0;
+}
+
+static int bench_amplification(void)
+{
+    //写放大 = 实际写入Flash字节 / 用户数据字节,含记录头、对齐填充与扇区头
+    static const uint16_t size[] = {4, 12, 20, 56, 120};
+    for(uint8_t k = 0; k < sizeof(size) / sizeof(size[0]); k++) {
+        uint8_t data[SENSOR_STORE_RECORD_MAX] = {0};
+        sim_blank();
+        TEST_ASSERT(sim_boot(size[k]));
+        store.stats.erase_count = 0;
+        for(uint32_t i = 1; i <= BENCH_NUM; i++) {
+            TEST_ASSERT(sensor_store_append(&store, i, data, size[k]));
+        }
+        float amp = (float)store.stats.flash_bytes / store.stats.payload_bytes;
+        printf("record %3u bytes: slot %3u, amplification %.2f, %.1f erases per 1000 records\r\n",
+               size[k], store.record_size, amp, store.stats.erase_count * 1000.0f / BENCH_NUM);
+        TEST_ASSERT(amp < (float)(size[k] + 8 + SIM_ALIGN) / size[k] * 1.02f);
+    }
+    return 0;
+}
+
+static int bench_query(void)
+{
+    //存储写满后:上电恢复与不同长度范围查询的Flash读取次数与耗时
+    visit_result_t res;
+    uint32_t total = SIM_SECTOR_NUM * 63 * 2;
+    sim_blank();
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    for(uint32_t i = 1; i <= total; i++) {
+        TEST_ASSERT(append(i));
+    }
+
+    sim_reads = 0;
+    TEST_ASSERT(sim_boot(SIM_DATA_SIZE));
+    printf("init: %lu flash reads\r\n", (unsigned long)sim_reads);
+    //仅读取扇区头与当前扇区二分查找
+    TEST_ASSERT(sim_reads <= SIM_SECTOR_NUM + 8);
+
+    static const uint32_t span[] = {1, 10, 100, 400};
+    for(uint8_t k = 0; k < sizeof(span) / sizeof(span[0]); k++) {
+        uint32_t start = total - 200 - span[k] / 2;
+        sim_reads = 0;
+        TEST_ASSERT(query(start, start + span[k] - 1, &res) == span[k]);
+        uint32_t reads = sim_reads;
+        clock_t t0 = clock();
+        for(uint16_t i = 0; i < BENCH_QUERY; i++) {
+            query(start, start + span[k] - 1, &res);
+        }
+        double us = (double)(clock() - t0) * 1e6 / CLOCKS_PER_SEC / BENCH_QUERY;
+        printf("query %3lu records: %3lu flash reads, %.2fus\r\n", (unsigned long)span[k], (unsigned long)reads, us);
+        //扇区内二分查找起点,读取次数为记录数量加跨越扇区的查找开销
+        TEST_ASSERT(reads <= span[k] + 1 + 7 * (span[k] / 63 + 2));
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    sim_file = tmpfile();
+    if(sim_file == NULL) {
+        printf("tmpfile failed\r\n");
+        return 1;
+    }
+    fail |= test_append();
+    fail |= test_wrap();
+    fail |= test_torn_head();
+    fail |= test_power_loss();
+    fail |= bench_amplification();
+    fail |= bench_query();
+    fclose(sim_file);
+    printf("test_store %s\r\n", (fail == 0) ? "pass" : "fail");
+    return fail;
+}